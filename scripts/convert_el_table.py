@@ -0,0 +1,111 @@
+"""
+Converts an EL light table from the text format read by ELLookupTable
+to its binary format, which nexus memory-maps instead of parsing it.
+
+Usage: python convert_el_table.py <input.txt> <output.bin> [--half]
+
+With --half the values are stored in half precision (float16).
+The grid geometry (radius, pitch, time binning) is taken from the
+"* <key> <value> [<unit>]" lines of the text header, with the same
+defaults as ELLookupTable.
+"""
+
+import sys
+import struct
+import argparse
+import bisect
+
+############################################################
+
+# Units of the header values, in the nexus internal units (mm, ns)
+units = {"nm": 1.e-6, "um": 1.e-3, "mum": 1.e-3, "mm": 1., "cm": 10., "m": 1000.,
+         "ps": 1.e-3, "ns": 1., "us": 1.e3, "mus": 1.e3, "microsecond": 1.e3,
+         "ms": 1.e6, "s": 1.e9}
+
+magic   = b"NXELTAB\0"
+version = 1
+
+############################################################
+
+
+def read_header(lines):
+    """Returns the table parameters and the number of header lines."""
+    pars = {"radius": 92.5, "pitch": 5., "time_bins": 5, "time_bin_width": 0.}
+    nlines = 0
+    for line in lines:
+        if not line.startswith("*"):
+            break
+        nlines += 1
+        words = line[1:].split()
+        if len(words) < 2 or words[0] not in pars:
+            continue
+        try:
+            value = float(words[1])
+        except ValueError:
+            continue
+        if len(words) > 2:
+            value *= units[words[2]]
+        pars[words[0]] = value
+    pars["time_bins"] = int(pars["time_bins"])
+    return pars, nlines
+
+
+def grid_points(radius, pitch):
+    """Returns the number of cells per axis and of points inside the circle,
+    numbered as in ELLookupTable::BuildGrid."""
+    ncells  = int(2. * radius / pitch + 1.)
+    centers = [-pitch * ncells / 2. + pitch / 2. + i * pitch for i in range(ncells)]
+    max_r2  = radius**2 * (1. + 1.e-9)
+    npoints = sum(1 for x in centers for y in centers if x*x + y*y <= max_r2)
+    return ncells, npoints
+
+
+def convert(input_file, output_file, half):
+    with open(input_file) as f:
+        lines = f.readlines()
+
+    pars, nheader = read_header(lines)
+    ncells, npoints = grid_points(pars["radius"], pars["pitch"])
+    ntbins = pars["time_bins"]
+
+    points, sensors, values = [], [], []
+    for line in lines[nheader:]:
+        words = line.split()
+        if not words:
+            continue
+        if len(words) != 2 + ntbins:
+            sys.exit("Wrong number of columns in {}: {}".format(input_file, line))
+        points .append(int(words[0]))
+        sensors.append(int(words[1]))
+        values .extend(float(v) for v in words[2:])
+
+    for prev, point in zip([0] + points, points):
+        if point < prev or point >= npoints:
+            sys.exit("Point ids of {} are not sorted or out of the grid".format(input_file))
+
+    offsets     = [bisect.bisect_left(points, i) for i in range(npoints + 1)]
+    sensor_list = sorted(set(sensors))
+
+    header = struct.pack("<8sII3dIIQQII", magic, version, 1 if half else 0,
+                         pars["radius"], pars["pitch"], pars["time_bin_width"],
+                         ntbins, ncells, npoints, len(sensors), len(sensor_list), 0)
+
+    with open(output_file, "wb") as f:
+        f.write(header)
+        f.write(struct.pack("<{}i".format(len(sensor_list)), *sensor_list))
+        f.write(b"\0" * (-4 * len(sensor_list) % 8))
+        f.write(struct.pack("<{}Q".format(len(offsets)), *offsets))
+        f.write(struct.pack("<{}i".format(len(sensors)), *sensors))
+        f.write(struct.pack("<{}{}".format(len(values), "e" if half else "f"), *values))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input",  help="light table in text format")
+    parser.add_argument("output", help="light table in binary format")
+    parser.add_argument("--half", action="store_true",
+                        help="store the values in half precision")
+    args = parser.parse_args()
+
+    convert(args.input, args.output, args.half)
@@ -0,0 +1,95 @@
+"""
+Builds the binary event library read by Decay0Library from a text
+file produced by the Decay0 event generator (.genbb), so that jobs can
+serve pre-generated events by index instead of parsing the text file.
+
+Usage: python make_decay0_library.py <input.genbb> <output.bin>
+
+The text events start after the line containing "First event" and the
+two lines following it, and are written as
+    <event number> <time> <number of particles>
+followed by one line per particle:
+    <GEANT3 code> <px> <py> <pz> <time>
+with momenta in MeV and times in seconds. Particles are stored with
+their PDG code, and every event block is padded to the maximum number
+of particles of the library.
+"""
+
+import sys
+import struct
+import argparse
+
+############################################################
+
+magic   = b"NXBBEVT\0"
+version = 1
+
+# GEANT3 codes of the particles produced by Decay0 (see Decay0Interface)
+g3_to_pdg = {1: 22, 2: -11, 3: 11, 5: -13, 6: 13,
+             13: 2112, 14: 2212, 47: 1000020040}
+
+particle_format = "<i3fd"
+event_format    = "<II"
+
+############################################################
+
+
+def read_events(input_file):
+    """Returns the events of the file as lists of (pdg, px, py, pz, t)."""
+    with open(input_file) as f:
+        for line in f:
+            if "First event" in line:
+                break
+        else:
+            sys.exit("No 'First event' line in the header of " + input_file)
+        next(f, None)
+        next(f, None)
+        words = f.read().split()
+
+    events = []
+    i = 0
+    while i + 3 <= len(words):
+        entries = int(words[i + 2])
+        i += 3
+        particles = []
+        for _ in range(entries):
+            g3, px, py, pz, t = words[i:i + 5]
+            i += 5
+            if int(g3) not in g3_to_pdg:
+                sys.exit("Particle with unknown GEANT3 code: " + g3)
+            particles.append((g3_to_pdg[int(g3)], float(px), float(py), float(pz), float(t)))
+        events.append(particles)
+
+    if i != len(words):
+        sys.exit("The last event of " + input_file + " is truncated")
+    return events
+
+
+def make_library(input_file, output_file):
+    events = read_events(input_file)
+    if not events:
+        sys.exit("No events in " + input_file)
+
+    max_particles = max(1, max(len(e) for e in events))
+    padding = struct.pack(particle_format, 0, 0., 0., 0., 0.)
+
+    with open(output_file, "wb") as f:
+        f.write(magic)
+        f.write(struct.pack("<IIQ", version, max_particles, len(events)))
+        for particles in events:
+            f.write(struct.pack(event_format, len(particles), 0))
+            for p in particles:
+                f.write(struct.pack(particle_format, *p))
+            f.write(padding * (max_particles - len(particles)))
+
+    print("{} events written to {}".format(len(events), output_file))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input",  help="Decay0 events in text format")
+    parser.add_argument("output", help="event library in binary format")
+    args = parser.parse_args()
+
+    make_library(args.input, args.output)
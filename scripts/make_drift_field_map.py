@@ -0,0 +1,98 @@
+"""
+Builds the binary drift field map read by DriftFieldMap from a table
+of drift parameters on a regular grid (e.g. the output of a Garfield++
+or COMSOL simulation of the detector field).
+
+Usage: python make_drift_field_map.py <input.txt> <output.bin>
+
+The input is a whitespace-separated text file, with lines starting with
+'#' taken as comments, and one row per grid node:
+    2D maps: r z velocity long_diff transv_diff dr
+    3D maps: x y z velocity long_diff transv_diff dx dy
+with positions and displacements in mm, velocities in mm/mus and
+diffusion coefficients in mm/sqrt(cm). The displacement is that of the
+endpoint of the drift of an electron starting at the node with respect
+to the straight drift line along z. The grid is deduced from the
+coordinates of the nodes, which must cover it completely.
+"""
+
+import sys
+import struct
+import argparse
+
+import numpy as np
+
+############################################################
+
+magic   = b"NXDRIFT\0"
+version = 1
+
+# Conversion of the input units to the nexus internal units (mm, ns)
+velocity_unit  = 1.e-3            # mm/mus
+diffusion_unit = 1. / np.sqrt(10.) # mm/sqrt(cm)
+
+############################################################
+
+
+def grid_axis(values):
+    """Returns the first node, step and number of nodes of a grid axis."""
+    nodes = np.unique(values)
+    if len(nodes) == 1:
+        return nodes[0], 0., 1
+    steps = np.diff(nodes)
+    if not np.allclose(steps, steps[0], rtol=1.e-4):
+        sys.exit("The nodes of the map are not on a regular grid")
+    return nodes[0], steps[0], len(nodes)
+
+
+def make_map(input_file, output_file):
+    data = np.loadtxt(input_file, comments="#", ndmin=2)
+
+    if data.shape[1] == 6:
+        dimensions = 2
+        coords = np.column_stack([data[:, 0], data[:, 1], np.zeros(len(data))])
+        values = np.column_stack([data[:, 2:6], np.zeros(len(data))])
+    elif data.shape[1] == 8:
+        dimensions = 3
+        coords = data[:, :3]
+        values = data[:, 3:8].copy()
+    else:
+        sys.exit("Wrong number of columns in the input: 6 (2D) or 8 (3D) expected")
+
+    axes  = [grid_axis(coords[:, i]) for i in range(3)]
+    mins  = [a[0] for a in axes]
+    steps = [a[1] for a in axes]
+    bins  = [a[2] for a in axes]
+
+    if np.prod(bins) != len(data):
+        sys.exit("The map has {} nodes for a grid of {} x {} x {}".format(len(data), *bins))
+
+    values[:, 0]   *= velocity_unit
+    values[:, 1:3] *= diffusion_unit
+
+    # Nodes in x-major (r-major) order, as read by DriftFieldMap
+    index = np.zeros(len(data), dtype=np.int64)
+    for i in range(3):
+        node = np.rint((coords[:, i] - mins[i]) / steps[i]).astype(np.int64) if bins[i] > 1 else 0
+        index = index * bins[i] + node
+    ordered = np.zeros_like(values)
+    ordered[index] = values
+
+    with open(output_file, "wb") as f:
+        f.write(magic)
+        f.write(struct.pack("<II", version, dimensions))
+        f.write(struct.pack("<3d", *mins))
+        f.write(struct.pack("<3d", *steps))
+        f.write(struct.pack("<3I", *bins))
+        f.write(struct.pack("<I", values.shape[1]))
+        f.write(ordered.astype("<f4").tobytes())
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input",  help="drift parameters in text format")
+    parser.add_argument("output", help="drift field map in binary format")
+    args = parser.parse_args()
+
+    make_map(args.input, args.output)
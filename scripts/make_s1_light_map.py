@@ -0,0 +1,116 @@
+"""
+Builds the S1 light map read by the S1 fast simulation (S1LightMap)
+from nexus output files produced with the ScintillationGenerator
+in voxel-map mode (see macros/NEXT100_S1_map_table.config.mac).
+
+Usage: python make_s1_light_map.py <output map> <nexus file> [<nexus file> ...]
+
+The voxel grid, the number of photons per event and the first voxel of
+each job are read from the configuration table of the files, so that
+the map can be built from several jobs covering different voxels.
+The arrival-time distribution of each voxel is built with the time
+binning of the sensors, which must be the same for all of them.
+"""
+
+import sys
+import argparse
+
+import numpy  as np
+import pandas as pd
+
+############################################################
+
+# Units of the configuration values, in the nexus internal units (mm, ns)
+units = {"mm": 1., "cm": 10., "m": 1000., "ns": 1., "mus": 1.e3, "ms": 1.e6}
+
+generator = "/Generator/ScintGenerator/"
+
+############################################################
+
+
+def read_vector(value):
+    """Converts a configuration value 'x y z unit' to a numpy array."""
+    words = value.split()
+    return np.array([float(w) for w in words[:3]]) * units.get(words[3], 1.)
+
+
+def read_configuration(filename):
+    conf = pd.read_hdf(filename, "MC/configuration")
+    conf = dict(zip(conf.param_key, conf.param_value))
+
+    pars = {"min"       : read_vector(conf[generator + "map_min"]),
+            "max"       : read_vector(conf[generator + "map_max"]),
+            "voxel_size": read_vector(conf[generator + "map_voxel_size"]),
+            "first"     : int(conf.get(generator + "map_first_voxel", 0)),
+            "nphotons"  : int(conf.get(generator + "nphotons", 1000000)),
+            "start_id"  : int(conf.get("/nexus/persistency/start_id", 0)),
+            "num_events": int(conf["num_events"])}
+
+    binnings = {v for k, v in conf.items() if k.endswith("_binning") and "fine" not in k}
+    if len(binnings) != 1:
+        sys.exit("The sensors of {} must have a single time binning".format(filename))
+    words = binnings.pop().split()
+    pars["time_bin_width"] = float(words[0]) * units[words[1]]
+
+    return pars
+
+
+def build_map(output_file, input_files, time_bins):
+    pars   = None
+    counts = []
+    times  = []
+    events = None
+
+    for filename in input_files:
+        file_pars = read_configuration(filename)
+        for key in ("min", "max", "voxel_size"):
+            if pars is not None and not np.allclose(pars[key], file_pars[key]):
+                sys.exit("The voxel grid of {} differs from the others".format(filename))
+        if pars is not None and pars["nphotons"] != file_pars["nphotons"]:
+            sys.exit("The number of photons of {} differs from the others".format(filename))
+        if pars is None:
+            pars   = file_pars
+            bins   = np.ceil((pars["max"] - pars["min"]) / pars["voxel_size"] - 1.e-6).astype(int)
+            events = np.zeros(np.prod(bins), dtype=int)
+
+        first = file_pars["first"]
+        events[first : first + file_pars["num_events"]] += 1
+
+        sns = pd.read_hdf(filename, "MC/sns_response")
+        sns["voxel"] = sns.event_id - file_pars["start_id"] + first
+        counts.append(sns.groupby(["voxel", "sensor_id"]).charge.sum())
+
+        sns["time_bin"] = np.minimum(sns.time_bin, time_bins - 1)
+        times .append(sns.groupby(["voxel", "time_bin"]).charge.sum())
+
+    counts = pd.concat(counts).groupby(level=[0, 1]).sum().reset_index()
+    times  = pd.concat(times ).groupby(level=[0, 1]).sum().unstack(fill_value=0)
+    times  = times.reindex(columns=range(time_bins), fill_value=0)
+
+    # Detection probability per photon emitted in the voxel
+    counts["prob"] = counts.charge / (pars["nphotons"] * events[counts.voxel])
+
+    with open(output_file, "w") as f:
+        f.write("* min {} {} {} mm\n"       .format(*pars["min"]))
+        f.write("* voxel_size {} {} {} mm\n".format(*pars["voxel_size"]))
+        f.write("* bins {} {} {}\n"         .format(*bins))
+        f.write("* time_bins {}\n"          .format(time_bins))
+        f.write("* time_bin_width {} ns\n"  .format(pars["time_bin_width"]))
+
+        for voxel, rows in counts.groupby("voxel"):
+            values = times.loc[voxel].values / times.loc[voxel].values.sum()
+            f.write("{} -1 {}\n".format(voxel, " ".join("{:.6g}".format(v) for v in values)))
+            for row in rows.itertuples():
+                f.write("{} {} {:.6g}\n".format(voxel, row.sensor_id, row.prob))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("output", help="S1 light map in text format")
+    parser.add_argument("inputs", nargs="+", help="nexus output files")
+    parser.add_argument("--time-bins", type=int, default=20,
+                        help="number of arrival-time bins (later photons go to the last one)")
+    args = parser.parse_args()
+
+    build_map(args.output, args.inputs, args.time_bins)
@@ -0,0 +1,288 @@
+// ----------------------------------------------------------------------------
+// nexus | BackgroundGenerator.cc
+//
+// This class is the primary generator of a mixture of radioactive
+// background sources, each one chosen with a probability proportional
+// to its activity.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "BackgroundGenerator.h"
+
+#include "GeometryBase.h"
+#include "DetectorConstruction.h"
+#include "BackgroundSourceInfo.h"
+#include "FactoryBase.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4IonTable.hh>
+#include <G4Gamma.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4Event.hh>
+#include <G4UIcommand.hh>
+#include <G4UnitsTable.hh>
+#include <G4RandomDirection.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <TFile.h>
+#include <TH1.h>
+
+#include <sstream>
+
+using namespace nexus;
+
+REGISTER_CLASS(BackgroundGenerator, G4VPrimaryGenerator)
+
+BackgroundGenerator::BackgroundGenerator():
+  G4VPrimaryGenerator(), msg_(nullptr), geom_(nullptr),
+  decay_at_time_zero_(true)
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/BackgroundGenerator/",
+                                "Control commands of the background mixture generator.");
+
+  msg_->DeclareMethod("add_ion", &BackgroundGenerator::AddIon,
+                      "Add a radioactive ion source (label Z A region activity unit).");
+
+  msg_->DeclareMethod("add_spectrum", &BackgroundGenerator::AddSpectrum,
+                      "Add a gamma source with the spectrum of a GammaEnergy "
+                      "histogram (label file region activity unit).");
+
+  msg_->DeclareMethod("importance", &BackgroundGenerator::SetImportance,
+                      "Multiply the probability of choosing a source (label factor).");
+
+  msg_->DeclareProperty("decay_at_time_zero", decay_at_time_zero_,
+                        "Set to true to make unstable ions decay at t=0.");
+
+  // Load the detector geometry, which will be used for the generation of vertices
+  const DetectorConstruction* detconst = dynamic_cast<const DetectorConstruction*>
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (detconst) geom_ = detconst->GetGeometry();
+  else G4Exception("[BackgroundGenerator]", "BackgroundGenerator()",
+                   FatalException, "Unable to load geometry.");
+}
+
+
+BackgroundGenerator::~BackgroundGenerator()
+{
+  delete msg_;
+}
+
+
+void BackgroundGenerator::AddIon(G4String command)
+{
+  std::istringstream iss(command);
+  Source source;
+  G4String region, unit;
+  G4double activity;
+  if (!(iss >> source.label >> source.atomic_number >> source.mass_number
+            >> region >> activity >> unit) ||
+      source.atomic_number <= 0 || source.mass_number <= 0) {
+    G4Exception("[BackgroundGenerator]", "AddIon()", FatalErrorInArgument,
+                ("Wrong ion source '" + command +
+                 "', expected 'label Z A region activity unit'.").c_str());
+  }
+
+  AddSource(source, region, activity, unit);
+}
+
+
+void BackgroundGenerator::AddSpectrum(G4String command)
+{
+  std::istringstream iss(command);
+  Source source;
+  G4String filename, region, unit;
+  G4double activity;
+  if (!(iss >> source.label >> filename >> region >> activity >> unit)) {
+    G4Exception("[BackgroundGenerator]", "AddSpectrum()", FatalErrorInArgument,
+                ("Wrong spectrum source '" + command +
+                 "', expected 'label file region activity unit'.").c_str());
+  }
+
+  source.atomic_number = 0;
+  source.mass_number   = 0;
+  ReadSpectrum(source, filename);
+
+  AddSource(source, region, activity, unit);
+}
+
+
+void BackgroundGenerator::AddSource(Source& source, const G4String& region,
+                                    G4double activity, const G4String& unit)
+{
+  for (const auto& s : sources_) {
+    if (s.label == source.label)
+      G4Exception("[BackgroundGenerator]", "AddSource()", FatalErrorInArgument,
+                  ("Source " + source.label + " already defined.").c_str());
+  }
+
+  // Labels are written in the fixed-size strings (STRLEN)
+  // of the event_sources table of the output
+  if (source.label.size() >= 100) {
+    G4Exception("[BackgroundGenerator]", "AddSource()", FatalErrorInArgument,
+                ("The label of source " + source.label +
+                 " is too long (99 characters at most).").c_str());
+  }
+
+  if (G4UnitDefinition::GetCategory(unit) != "Activity" || activity < 0.) {
+    G4Exception("[BackgroundGenerator]", "AddSource()", FatalErrorInArgument,
+                ("Source " + source.label +
+                 " needs a non-negative activity with an activity unit.").c_str());
+  }
+
+  source.activity   = activity * G4UIcommand::ValueOf(unit);
+  source.importance = 1.;
+  source.weight     = 1.;
+  source.definition = nullptr;
+
+  source.vertex_sampler = geom_->GetVertexSampler(region);
+
+  sources_.push_back(source);
+
+  // The table is rebuilt at the next event
+  source_sampler_ = AliasSampler();
+}
+
+
+void BackgroundGenerator::SetImportance(G4String command)
+{
+  std::istringstream iss(command);
+  G4String label;
+  G4double importance;
+  if (!(iss >> label >> importance) || importance <= 0.) {
+    G4Exception("[BackgroundGenerator]", "SetImportance()", FatalErrorInArgument,
+                ("Wrong importance '" + command +
+                 "', expected 'label factor' with a positive factor.").c_str());
+  }
+
+  for (auto& source : sources_) {
+    if (source.label == label) {
+      source.importance = importance;
+      source_sampler_ = AliasSampler();
+      return;
+    }
+  }
+
+  G4Exception("[BackgroundGenerator]", "SetImportance()", FatalErrorInArgument,
+              ("Unknown source " + label).c_str());
+}
+
+
+void BackgroundGenerator::ReadSpectrum(Source& source, const G4String& filename)
+{
+  // Spectra written by the ValidationTrackingAction, in keV
+  TFile file(filename.c_str());
+  TH1* spectrum = nullptr;
+  if (!file.IsZombie()) file.GetObject("GammaEnergy", spectrum);
+  if (!spectrum)
+    G4Exception("[BackgroundGenerator]", "ReadSpectrum()", FatalErrorInArgument,
+                ("Cannot read the GammaEnergy spectrum from " + filename).c_str());
+
+  const TAxis* axis = spectrum->GetXaxis();
+  const G4int nbins = axis->GetNbins();
+
+  std::vector<G4double> weights(nbins);
+  source.energy_edges.resize(nbins + 1);
+  for (G4int i=0; i<nbins; ++i) {
+    weights[i] = spectrum->GetBinContent(i+1);
+    source.energy_edges[i] = axis->GetBinLowEdge(i+1) * keV;
+  }
+  source.energy_edges[nbins] = axis->GetBinUpEdge(nbins) * keV;
+  source.energy_bins.SetWeights(weights);
+
+  delete spectrum;
+  file.Close();
+
+  if (source.energy_bins.IsEmpty())
+    G4Exception("[BackgroundGenerator]", "ReadSpectrum()", FatalErrorInArgument,
+                ("Empty spectrum in " + filename).c_str());
+}
+
+
+void BackgroundGenerator::BuildTable()
+{
+  if (sources_.empty())
+    G4Exception("[BackgroundGenerator]", "BuildTable()", FatalException,
+                "No background sources defined.");
+
+  // Sources are chosen in proportion to activity times importance,
+  // and their events weighted back to the proportion of the activities
+  G4double total_activity = 0.;
+  G4double total_biased   = 0.;
+  std::vector<G4double> weights;
+  for (const auto& source : sources_) {
+    total_activity += source.activity;
+    total_biased   += source.activity * source.importance;
+    weights.push_back(source.activity * source.importance);
+  }
+
+  if (!(total_biased > 0.))
+    G4Exception("[BackgroundGenerator]", "BuildTable()", FatalException,
+                "The total activity of the background sources is zero.");
+
+  source_sampler_.SetWeights(weights);
+
+  G4cout << "[BackgroundGenerator] Total activity "
+         << G4BestUnit(total_activity, "Activity")
+         << ", equivalent to " << (1./total_activity)/s
+         << " s of exposure per (unweighted) event." << G4endl;
+
+  for (size_t i=0; i<sources_.size(); ++i) {
+    Source& source = sources_[i];
+    source.weight = total_biased / (source.importance * total_activity);
+
+    // Ions are looked up at the first event, once the physics is built
+    if (source.mass_number > 0 && !source.definition) {
+      source.definition = G4IonTable::GetIonTable()->
+        GetIon(source.atomic_number, source.mass_number, 0.);
+      if (!source.definition)
+        G4Exception("[BackgroundGenerator]", "BuildTable()", FatalException,
+                    ("Unable to find the ion of source " + source.label).c_str());
+
+      // Unstable ions are made to decay at t=0, as in the IonGenerator
+      if (decay_at_time_zero_ && !(source.definition->GetPDGStable()))
+        source.definition->SetPDGLifeTime(1.*ps);
+    }
+
+    G4cout << "[BackgroundGenerator]   " << source.label << ": probability "
+           << source_sampler_.GetProbability(i) << ", weight "
+           << source.weight << G4endl;
+  }
+}
+
+
+G4PrimaryParticle* BackgroundGenerator::IonDecay(const Source& source) const
+{
+  return new G4PrimaryParticle(source.definition);
+}
+
+
+G4PrimaryParticle* BackgroundGenerator::Gamma(const Source& source) const
+{
+  // Uniform energy within the bin of the spectrum
+  size_t bin = source.energy_bins.Shoot();
+  G4double energy = source.energy_edges[bin] + G4UniformRand() *
+    (source.energy_edges[bin+1] - source.energy_edges[bin]);
+
+  G4ThreeVector momentum = energy * G4RandomDirection();
+  return new G4PrimaryParticle(G4Gamma::Definition(),
+                               momentum.x(), momentum.y(), momentum.z());
+}
+
+
+void BackgroundGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  if (source_sampler_.IsEmpty()) BuildTable();
+
+  const Source& source = sources_[source_sampler_.Shoot()];
+
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(source.vertex_sampler(), 0.);
+  vertex->SetPrimary(source.mass_number > 0 ? IonDecay(source) : Gamma(source));
+
+  // The source is written in the output with the event
+  vertex->SetUserInformation(new BackgroundSourceInfo(source.label, source.weight));
+  event->AddPrimaryVertex(vertex);
+}
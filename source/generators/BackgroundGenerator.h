@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+// nexus | BackgroundGenerator.h
+//
+// This class is the primary generator of a mixture of radioactive
+// background sources, each one chosen with a probability proportional
+// to its activity.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BACKGROUND_GENERATOR_H
+#define BACKGROUND_GENERATOR_H
+
+#include "AliasSampler.h"
+#include "GeometryBase.h"
+
+#include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+class G4ParticleDefinition;
+class G4PrimaryParticle;
+
+
+namespace nexus {
+
+  /// Every source is a radioactive ion (decayed by Geant4, as in the
+  /// IonGenerator) or a single gamma with the energy spectrum of one of
+  /// the GammaEnergy histograms of histos/, generated in a region of the
+  /// geometry with a given activity (for gamma sources, the rate of
+  /// emitted gammas rather than of decays). The source of every event is
+  /// chosen with an alias table, so that a single job produces the
+  /// mixture of all of them. Sources can be given an importance factor,
+  /// which multiplies their probability of being chosen: the events are
+  /// then weighted with the ratio between the true and the sampled
+  /// probabilities of their source, so that weighted distributions are
+  /// those of the real mixture. The label and weight of the source of
+  /// every event are written in the event_sources table of the output.
+
+  class BackgroundGenerator: public G4VPrimaryGenerator
+  {
+  public:
+    /// Constructor
+    BackgroundGenerator();
+    /// Destructor
+    ~BackgroundGenerator();
+
+    /// This method is invoked at the beginning of the event,
+    /// setting a primary vertex of one of the sources
+    void GeneratePrimaryVertex(G4Event*);
+
+  private:
+    struct Source {
+      G4String label;
+      G4int atomic_number, mass_number;  ///< Ion (if mass number > 0)
+      G4ParticleDefinition* definition;
+      AliasSampler energy_bins;          ///< Gamma spectrum (otherwise)
+      std::vector<G4double> energy_edges;
+      GeometryBase::VertexSampler vertex_sampler;
+      G4double activity;
+      G4double importance;
+      G4double weight;                   ///< Weight of the events
+    };
+
+    void AddIon(G4String);
+    void AddSpectrum(G4String);
+    void SetImportance(G4String);
+
+    void AddSource(Source&, const G4String& region,
+                   G4double activity, const G4String& unit);
+    void ReadSpectrum(Source&, const G4String& filename);
+    void BuildTable();
+
+    G4PrimaryParticle* IonDecay(const Source&) const;
+    G4PrimaryParticle* Gamma(const Source&) const;
+
+  private:
+    G4GenericMessenger* msg_;
+    const GeometryBase* geom_;
+
+    G4bool decay_at_time_zero_;
+
+    std::vector<Source> sources_;
+    AliasSampler source_sampler_; ///< Sampler of the sources of the events
+  };
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// nexus | BackgroundSourceInfo.cc
+//
+// This class is a utility to add the background source of the event
+// and its weight to the primary vertex of the BackgroundGenerator class.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "BackgroundSourceInfo.h"
+
+using namespace nexus;
+
+BackgroundSourceInfo::BackgroundSourceInfo(const G4String& label, G4double weight):
+  label_(label), weight_(weight)
+{
+}
+
+BackgroundSourceInfo::~BackgroundSourceInfo()
+{
+}
+
+void BackgroundSourceInfo::Print() const
+{
+  G4cout << "Background source " << label_ << ", weight " << weight_ << G4endl;
+}
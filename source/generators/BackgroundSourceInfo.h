@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------------------
+// nexus | BackgroundSourceInfo.h
+//
+// This class is a utility to add the background source of the event
+// and its weight to the primary vertex of the BackgroundGenerator class.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BACKGROUND_SOURCE_INFO_H
+#define BACKGROUND_SOURCE_INFO_H
+
+#include <G4VUserPrimaryVertexInformation.hh>
+#include "globals.hh"
+
+namespace nexus {
+
+  class BackgroundSourceInfo: public G4VUserPrimaryVertexInformation
+  {
+  public:
+    //constructor
+    BackgroundSourceInfo(const G4String& label, G4double weight);
+    //destructor
+    ~BackgroundSourceInfo();
+
+    void Print() const;
+    const G4String& GetLabel() const;
+    G4double GetWeight() const;
+
+  private:
+
+    G4String label_;
+    G4double weight_;
+  };
+
+  inline const G4String& BackgroundSourceInfo::GetLabel() const
+  { return label_; }
+  inline G4double BackgroundSourceInfo::GetWeight() const
+  { return weight_; }
+
+} // end namespace nexus
+
+#endif
@@ -6,12 +6,14 @@
 // FORTRAN package, with nexus.
 // It provides the primary vertex of a Xe-136 double beta decay.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta, or a binary library of pre-generated events, is
+// also allowed.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 #include "Decay0Interface.h"
+#include "Decay0Library.h"
 
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
@@ -21,30 +23,44 @@
 #include <G4RunManager.hh>
 #include <G4ParticleTable.hh>
 #include <G4ParticleDefinition.hh>
+#include <Randomize.hh>
 #include "decay0.h"
 #include <iostream>
+#include <algorithm>
 using namespace nexus;
 
 REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
-  G4VPrimaryGenerator(), msg_(0), opened_(false), geom_(0)
+  G4VPrimaryGenerator(), msg_(0), opened_(false),
+  library_(0), library_start_(-1), library_event_(-1), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
     "Control commands of the Decay0 interface.");
 
   msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
-  msg_->DeclareProperty("region", region_, "");
+  msg_->DeclareMethod("region", &Decay0Interface::SetRegion, "");
+
+  msg_->DeclareMethod("library", &Decay0Interface::OpenLibrary,
+    "Binary library of pre-generated Decay0 events.");
+
+  G4GenericMessenger::Command& start_cmd =
+    msg_->DeclareProperty("library_start", library_start_,
+      "First event of the library to be used (-1 for a random one).");
+  start_cmd.SetRange("library_start>=-1");
 
   msg_->DeclareMethod("EnergyThreshold", &Decay0Interface::SetEnergyThreshold, ""); // for electrons only.
   msg_->DeclareMethod("Xe136DecayMode", &Decay0Interface::SetXe136DecayMode, "");
   msg_->DeclareMethod("Ba136FinalState", &Decay0Interface::SetBa136FinalState, "");
+  msg_->DeclareProperty("spectrumCache", spectrumCache_,
+    "File where the tabulated energy spectra of the decay are cached.");
 
   DetectorConstruction* detConst = (DetectorConstruction*)
   G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detConst->GetGeometry();
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 
   decay0_ = 0;
   myEventCounter_ = 0;
@@ -58,6 +74,7 @@ Decay0Interface::~Decay0Interface()
   if (file_.is_open()) file_.close();
   if (fOutDebug_.is_open()) fOutDebug_.close();
   if (decay0_ != 0) delete decay0_;
+  delete library_;
 }
 
 
@@ -84,16 +101,39 @@ void Decay0Interface::OpenInputFile(G4String filename)
 
 
 
+void Decay0Interface::OpenLibrary(G4String filename)
+{
+  delete library_;
+  library_ = new Decay0Library(filename);
+  library_event_ = -1;
+}
+
+
+
+void Decay0Interface::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
+
+
 /// Read an event from file and create primary particles and
 /// vertices accordingly
 void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 {
+  if (library_) {
+    GenerateFromLibrary(event);
+    return;
+  }
+
   const bool runG4 = true;
 //  const bool runG4 = false;
   if (!opened_) {
      if (decay0_ == 0) {
        const std::string XeName("Xe136");
-       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_);
+       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_,
+                            0.0, 4.3, spectrumCache_);
       // Temporary debugging file, just generate particle and dump them on a file
 //      std::ostringstream fOutStrStr; fOutStrStr << "./Decay0Out_" << Ba136FinalState_ << "_" << Xe136DecayMode_ << "_V1.txt";
 //      std::string fOutStr(fOutStrStr.str());
@@ -122,7 +162,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
         }
      }
      if (runG4 && keepEvt) {
-        particle_position = geom_->GenerateVertex(region_);
+        G4ThreeVector particle_position = vertex_sampler_();
         for (std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++) {
           G4ParticleDefinition* g4code =
              G4ParticleTable::GetParticleTable()->FindParticle(itp->pdgCode_);
@@ -130,7 +170,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 	     new G4PrimaryParticle(g4code, MeV*itp->pmom_[0], MeV*itp->pmom_[1], MeV*itp->pmom_[2]);
          // create a primary vertex for the particle
           G4PrimaryVertex* vertex =
-              new G4PrimaryVertex(particle_position, particle_time*second);
+              new G4PrimaryVertex(particle_position, itp->time_*second);
          vertex->SetPrimary(particle);
          event->AddPrimaryVertex(vertex);
         }
@@ -160,7 +200,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
   // generate a position in the detector
   // (all primary particles will be generated there)
-  particle_position = geom_->GenerateVertex(region_);
+  G4ThreeVector particle_position = vertex_sampler_();
 
 
   // reading info for each particle in the event
@@ -169,6 +209,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
     G4int g3code;           // GEANT3 particle code
     G4double px, py, pz;    // Momentum components in MeV
+    G4double particle_time; // Emission time in seconds
 
     file_ >> g3code >> px >> py >> pz >> particle_time;
 
@@ -195,6 +236,55 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
 
 
+void Decay0Interface::GenerateFromLibrary(G4Event* event)
+{
+  const G4long num_events = library_->GetNumberOfEvents();
+
+  // Jobs reading the same library with a random start use
+  // different events without having to split the file
+  if (library_event_ < 0) {
+    if (library_start_ < 0)
+      library_event_ = std::min(G4long(G4UniformRand() * num_events), num_events - 1);
+    else
+      library_event_ = library_start_ % num_events;
+  }
+
+  G4int entries;
+  const Decay0Particle* particles = library_->GetEvent(library_event_, entries);
+
+  // Events are served sequentially, starting over at the end of the library
+  library_event_ = (library_event_ + 1) % num_events;
+
+  // all primary particles are generated in the same position
+  G4ThreeVector particle_position = vertex_sampler_();
+
+  for (G4int i=0; i<entries; i++) {
+    G4ParticleDefinition* g4code =
+      G4ParticleTable::GetParticleTable()->FindParticle(particles[i].pdg);
+
+    if (!g4code) {
+      G4Exception("[Decay0Interface]", "GenerateFromLibrary()", FatalException,
+                  "Unknown particle PDG code in the Decay0 library!");
+    }
+
+    G4PrimaryParticle* particle =
+      new G4PrimaryParticle(g4code, particles[i].momentum[0]*MeV,
+                            particles[i].momentum[1]*MeV,
+                            particles[i].momentum[2]*MeV);
+
+    particle->SetMass(g4code->GetPDGMass());
+    particle->SetCharge(g4code->GetPDGCharge());
+
+    G4PrimaryVertex* vertex =
+      new G4PrimaryVertex(particle_position, particles[i].time*second);
+
+    vertex->SetPrimary(particle);
+    event->AddPrimaryVertex(vertex);
+  }
+}
+
+
+
 void Decay0Interface::ProcessHeader()
 {
   G4String line;
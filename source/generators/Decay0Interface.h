@@ -5,7 +5,8 @@
 // interfacing the DECAY0 c++ code, translated from the original
 // FORTRAN package, with nexus.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta, or a binary library of pre-generated events, is
+// also allowed.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,7 +14,10 @@
 #ifndef DECAY0_INTERFACE_H
 #define DECAY0_INTERFACE_H
 
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 #include <fstream>
 
 class G4GenericMessenger;
@@ -23,7 +27,7 @@ class decay0;
 
 namespace nexus {
 
-  class GeometryBase;
+  class Decay0Library;
 
 
   /// This primary generator sets the G4Event objects according to the
@@ -43,11 +47,18 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
+
     /// Open the Decay0 input file selected by the user
     void OpenInputFile(G4String);
     /// Parse information in the file header
     void ProcessHeader();
 
+    /// Map the binary library of events selected by the user
+    void OpenLibrary(G4String);
+    /// Generate the primary particles of the next event of the library
+    void GenerateFromLibrary(G4Event*);
+
     /// Return the PDG code equivalent to a given GEANT3 particle code
     G4int G3toPDG(const G4int);
 
@@ -56,9 +67,14 @@ namespace nexus {
 
     std::ifstream file_; ///< ASCII file produced by Decay0
     G4String region_; ///< region of generation of vertices in geometry
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
 
     G4bool opened_;
 
+    Decay0Library* library_; ///< Binary library of pre-generated events
+    G4int library_start_;    ///< First event of the library (-1 = random)
+    G4long library_event_;   ///< Next event of the library to be used
+
     int myEventCounter_;
 
     decay0 *decay0_;
@@ -69,6 +85,8 @@ namespace nexus {
 
     double energyThreshold_;
 
+    G4String spectrumCache_; ///< File caching the tabulated Decay0 spectra
+
     std::ofstream fOutDebug_; // for debugging...
     const GeometryBase* geom_;
 
@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0Library.cc
+//
+// This class gives random access to a library of pre-generated Decay0
+// events stored in a memory-mapped binary file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Decay0Library.h"
+
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace nexus {
+
+
+  namespace {
+
+    const char DECAY0_LIBRARY_MAGIC[8] = {'N','X','B','B','E','V','T','\0'};
+
+    struct Decay0LibraryHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t max_particles;
+      uint64_t num_events;
+    };
+
+    struct Decay0EventHeader {
+      uint32_t num_particles;
+      uint32_t reserved;
+    };
+
+  }
+
+
+
+  Decay0Library::Decay0Library(const G4String& filename):
+    num_events_(0), max_particles_(0), block_size_(0), events_(0),
+    mapped_(0), mapped_size_(0)
+  {
+    MapFile(filename);
+  }
+
+
+
+  Decay0Library::~Decay0Library()
+  {
+    if (mapped_) munmap(mapped_, mapped_size_);
+  }
+
+
+
+  void Decay0Library::MapFile(const G4String& filename)
+  {
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      G4Exception("[Decay0Library]", "MapFile()", FatalException,
+                  ("Cannot open Decay0 library " + filename).c_str());
+    }
+
+    mapped_size_ = st.st_size;
+    if (mapped_size_ < sizeof(Decay0LibraryHeader)) {
+      close(fd);
+      G4Exception("[Decay0Library]", "MapFile()", FatalException,
+                  ("Decay0 library " + filename + " is truncated").c_str());
+    }
+
+    mapped_ = mmap(0, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped_ == MAP_FAILED) {
+      mapped_ = 0;
+      G4Exception("[Decay0Library]", "MapFile()", FatalException,
+                  ("Cannot map Decay0 library " + filename).c_str());
+    }
+
+    const char* data = static_cast<const char*>(mapped_);
+    Decay0LibraryHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, DECAY0_LIBRARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != 1 || header.max_particles == 0) {
+      G4Exception("[Decay0Library]", "MapFile()", FatalException,
+                  ("Wrong header in Decay0 library " + filename).c_str());
+    }
+
+    num_events_    = header.num_events;
+    max_particles_ = header.max_particles;
+    block_size_    = sizeof(Decay0EventHeader) +
+      max_particles_ * sizeof(Decay0Particle);
+    events_        = data + sizeof(header);
+
+    if (num_events_ == 0 ||
+        mapped_size_ < sizeof(header) + num_events_ * block_size_) {
+      G4Exception("[Decay0Library]", "MapFile()", FatalException,
+                  ("Decay0 library " + filename +
+                   " is empty or truncated").c_str());
+    }
+
+    G4cout << "[Decay0Library] " << num_events_ << " events mapped from "
+           << filename << G4endl;
+  }
+
+
+
+  const Decay0Particle* Decay0Library::GetEvent(size_t index,
+                                                G4int& num_particles) const
+  {
+    if (index >= num_events_) {
+      G4Exception("[Decay0Library]", "GetEvent()", FatalErrorInArgument,
+                  "Event index out of the library.");
+    }
+
+    const char* block = events_ + index * block_size_;
+
+    Decay0EventHeader header;
+    std::memcpy(&header, block, sizeof(header));
+    num_particles = header.num_particles;
+
+    if (header.num_particles > max_particles_) {
+      G4Exception("[Decay0Library]", "GetEvent()", FatalException,
+                  "Corrupted event block in the Decay0 library.");
+    }
+
+    // The header and the records are 8-byte aligned within the block,
+    // and blocks start at 8-byte offsets of the page-aligned mapping
+    return reinterpret_cast<const Decay0Particle*>(block + sizeof(header));
+  }
+
+
+} // namespace nexus
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0Library.h
+//
+// This class gives random access to a library of pre-generated Decay0
+// events stored in a memory-mapped binary file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DECAY0_LIBRARY_H
+#define DECAY0_LIBRARY_H
+
+#include <globals.hh>
+
+#include <cstdint>
+
+
+namespace nexus {
+
+  /// Particle of an event of the library, as stored in the file:
+  /// PDG code, momentum in MeV and emission time in seconds.
+
+  struct Decay0Particle
+  {
+    int32_t pdg;
+    float   momentum[3];
+    double  time;
+  };
+
+
+  /// The file (written by scripts/make_decay0_library.py) has a header
+  /// with the number of events and the maximum number of particles per
+  /// event, followed by one fixed-size block per event: the number of
+  /// particles and a Decay0Particle record per particle, padded to the
+  /// maximum. Event i is therefore found at a fixed offset of the file,
+  /// which is mapped read-only: pages are loaded on demand and shared by
+  /// all the jobs reading the same library.
+
+  class Decay0Library
+  {
+  public:
+    /// Constructor
+    Decay0Library(const G4String& filename);
+    /// Destructor
+    ~Decay0Library();
+
+    /// Returns the number of events of the library
+    size_t GetNumberOfEvents() const;
+
+    /// Returns the particles of the index-th event and their number
+    const Decay0Particle* GetEvent(size_t index, G4int& num_particles) const;
+
+  private:
+    void MapFile(const G4String&);
+
+  private:
+    size_t num_events_;
+    size_t max_particles_;
+    size_t block_size_;  ///< Size in bytes of the block of an event
+    const char* events_; ///< First event block
+
+    void* mapped_;       ///< Memory-mapped binary file
+    size_t mapped_size_; ///< Size of the memory-mapped file
+  };
+
+  // INLINE DEFINITIONS ////////////////////////////////////////////
+
+  inline size_t Decay0Library::GetNumberOfEvents() const
+  { return num_events_; }
+
+} // namespace nexus
+
+#endif
@@ -53,11 +53,12 @@ geom_(0)
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &ElecPositronPairGenerator::SetRegion,
     "Set the region of the geometry where the vertex will be generated.");
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 }
 
 
@@ -68,6 +69,13 @@ ElecPositronPairGenerator::~ElecPositronPairGenerator()
 }
 
 
+void ElecPositronPairGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
+
 void ElecPositronPairGenerator::GeneratePrimaryVertex(G4Event* event)
 {
 
@@ -75,7 +83,7 @@ void ElecPositronPairGenerator::GeneratePrimaryVertex(G4Event* event)
     G4ParticleTable::GetParticleTable()->FindParticle("e-");
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector pos = geom_->GenerateVertex(region_);
+  G4ThreeVector pos = vertex_sampler_();
 
   // Particle generated at start-of-event
   G4double time = 0.;
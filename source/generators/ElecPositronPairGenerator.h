@@ -10,7 +10,10 @@
 #ifndef ELEC_POSITRON_PAIR_GEN_H
 #define ELEC_POSITRON_PAIR_GEN_H
 
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
 class G4Event;
@@ -19,8 +22,6 @@ class G4ParticleDefinition;
 
 namespace nexus {
 
-  class GeometryBase;
-
   class ElecPositronPairGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -35,6 +36,7 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
 
     /// Generate a random kinetic energy with flat probability in
     //  the interval [energy_min, energy_max].
@@ -51,6 +53,7 @@ namespace nexus {
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
 
   };
 
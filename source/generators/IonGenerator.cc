@@ -53,7 +53,7 @@ IonGenerator::IonGenerator():
   msg_->DeclareProperty("decay_at_time_zero", decay_at_time_zero_,
                         "Set to true to make unstable ions decay at t=0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &IonGenerator::SetRegion,
                         "Region of the geometry where vertices will be generated.");
 
   // Load the detector geometry, which will be used for the generation of vertices
@@ -61,6 +61,7 @@ IonGenerator::IonGenerator():
     (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
   if (detconst) geom_ = detconst->GetGeometry();
   else G4Exception("[IonGenerator]", "IonGenerator()", FatalException, "Unable to load geometry.");
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 }
 
 
@@ -92,6 +93,13 @@ G4ParticleDefinition* IonGenerator::IonDefinition()
 }
 
 
+void IonGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
+
 void IonGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   // Pointer declared as static so that it gets allocated only once
@@ -101,7 +109,7 @@ void IonGenerator::GeneratePrimaryVertex(G4Event* event)
   G4PrimaryParticle* ion = new G4PrimaryParticle(pdef);
 
   // Generate an initial position for the ion using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4ThreeVector position = vertex_sampler_();
   // Ion generated at the start-of-event time
   G4double time = 0.;
   // Create a new vertex
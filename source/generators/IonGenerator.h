@@ -11,7 +11,10 @@
 #ifndef ION_GENERATOR_H
 #define ION_GENERATOR_H
 
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4Event;
 class G4GenericMessenger;
@@ -20,8 +23,6 @@ class G4ParticleDefinition;
 
 namespace nexus{
 
-  class GeometryBase;
-
   class IonGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -35,6 +36,8 @@ namespace nexus{
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
+
     G4ParticleDefinition* IonDefinition();
 
  private:
@@ -42,6 +45,7 @@ namespace nexus{
     G4double energy_level_;
     G4bool decay_at_time_zero_;
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
   };
@@ -12,6 +12,7 @@
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
 #include "FactoryBase.h"
+#include "SubEventInfo.h"
 
 #include <G4Event.hh>
 #include <G4GenericMessenger.hh>
@@ -37,7 +38,8 @@ namespace nexus {
   using namespace CLHEP;
 
   Kr83mGenerator::Kr83mGenerator() : geom_(0), energy_32_(32.1473*keV), energy_9_(9.396*keV),
-                                     probGamma_9_(0.0490), lifetime_9_(154.*ns)
+                                     probGamma_9_(0.0490), lifetime_9_(154.*ns),
+                                     decays_per_event_(1), decay_time_window_(0.)
   {
   // From the TORI /ENSDF data tables.
 
@@ -87,9 +89,22 @@ namespace nexus {
      msg_ = new G4GenericMessenger(this, "/Generator/Kr83mGenerator/",
     "Control commands of Kr83 generator.");
 
-     msg_->DeclareProperty("region", region_,
+     msg_->DeclareMethod("region", &Kr83mGenerator::SetRegion,
 			   "Set the region of the geometry where the vertex will be generated.");
 
+     G4GenericMessenger::Command& decays_cmd =
+       msg_->DeclareProperty("decays_per_event", decays_per_event_,
+                             "Number of independent decays in every event.");
+     decays_cmd.SetParameterName("decays_per_event", false);
+     decays_cmd.SetRange("decays_per_event > 0");
+
+     G4GenericMessenger::Command& window_cmd =
+       msg_->DeclareProperty("decay_time_window", decay_time_window_,
+                             "Time window in which the decays of an event happen.");
+     window_cmd.SetUnitCategory("Time");
+     window_cmd.SetParameterName("decay_time_window", false);
+     window_cmd.SetRange("decay_time_window >= 0.");
+
      // Set particle type searching in particle table by name
     particle_defgamma_ = G4ParticleTable::GetParticleTable()->
       FindParticle("gamma");
@@ -99,6 +114,7 @@ namespace nexus {
     DetectorConstruction* detconst = (DetectorConstruction*)
       G4RunManager::GetRunManager()->GetUserDetectorConstruction();
     geom_ = detconst->GetGeometry();
+    vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
     //
     // to debug possible problem with paucity of X-ray from the 32 kEV line..
     // May 2
@@ -112,13 +128,32 @@ namespace nexus {
   {
   }
 
+  void Kr83mGenerator::SetRegion(G4String region)
+  {
+    region_ = region;
+    vertex_sampler_ = geom_->GetVertexSampler(region_);
+  }
+
   void Kr83mGenerator::GeneratePrimaryVertex(G4Event* evt)
   {
-    // Add an Ascci ntuple to debug..
-   // const int evtNum = evt->GetEventID();
+    if (decays_per_event_ == 1) {
+      evt->AddPrimaryVertex(GenerateDecay(0.));
+      return;
+    }
 
+    // Independent decays, uniformly distributed in the time window
+    for (G4int i=0; i<decays_per_event_; ++i) {
+      G4PrimaryVertex* vertex =
+        GenerateDecay(decay_time_window_ * G4UniformRand());
+      vertex->SetUserInformation(new SubEventInfo(i));
+      evt->AddPrimaryVertex(vertex);
+    }
+  }
+
+  G4PrimaryVertex* Kr83mGenerator::GenerateDecay(G4double time)
+  {
     // Ask the geometry to generate a position for the particle
-    G4ThreeVector position = geom_->GenerateVertex(region_);
+    G4ThreeVector position = vertex_sampler_();
    //
    // First transition (32 kEv) Always one electron. Set it's kinetic energy.
    // Decide if we emit an X-ray..
@@ -147,9 +182,6 @@ namespace nexus {
     G4double px = pmod * momentum_dir32.x();
     G4double py = pmod * momentum_dir32.y();
     G4double pz = pmod * momentum_dir32.z();
-    // Set starting time of generation
-    G4double time = 0;
-
     G4PrimaryVertex* vertex =
       new G4PrimaryVertex(position, time);
 
@@ -159,7 +191,7 @@ namespace nexus {
       new G4PrimaryParticle(particle_defelectron_);
     particle1->SetMomentum(px, py, pz);
     particle1->SetPolarization(0.,0.,0.);
-    particle1->SetProperTime(time);
+    particle1->SetProperTime(0.);
     vertex->SetPrimary(particle1);
 //    fOutCheckKr83mTmp << " " << evtNum << " 32  11 " << eKin32 << std::endl;
     if (eXray > (0.0001*keV)) {
@@ -171,7 +203,7 @@ namespace nexus {
       G4PrimaryParticle* particle2 = new G4PrimaryParticle(particle_defgamma_);
       particle2->SetMomentum(px, py, pz);
       particle2->SetPolarization(0.,0.,0.);
-      particle2->SetProperTime(time);
+      particle2->SetProperTime(0.);
       vertex->SetPrimary(particle2);
 //      fOutCheckKr83mTmp << " " << evtNum << " 320  22 " << eXray << std::endl;
     }
@@ -212,6 +244,6 @@ namespace nexus {
       vertex->SetPrimary(particle3);
 //      fOutCheckKr83mTmp << " " << evtNum << " 9  11 " << energy_9_ << std::endl;
    }
-   evt->AddPrimaryVertex(vertex);
+   return vertex;
   }
 } // Name space nexus
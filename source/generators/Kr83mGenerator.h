@@ -10,17 +10,19 @@
 #ifndef Kr83m_GENERATOR_H
 #define Kr83m_GENERATOR_H
 
+#include "GeometryBase.h"
+
 #include <vector>
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4Event;
 class G4ParticleDefinition;
 class G4GenericMessenger;
+class G4PrimaryVertex;
 
 namespace nexus {
 
-  class GeometryBase;
-
   /// This state decays into the fundamental state of Kr 83 in two steps,
   ///  (JP 1/2- --> Jp 7/2+ -> 9/2+), with transition energies of 32.15 and 9.4 keV
   ///  The life time of 83mKr is long, ~ 1.83 hours, so, infinite for us,
@@ -46,6 +48,16 @@ namespace nexus {
   /// the EC. Since the path length of  12 and 14 keV x-ray is not strictly zero,
   /// it makes life a bit more complicated...
   /// So, we have to simulated 2 or 3 particles for each decay..
+  ///
+  /// Several independent decays can be simulated in the same event, at
+  /// different positions and at random times within a time window, to
+  /// save the per-event overhead of calibration productions. The vertex
+  /// of every decay is labelled with its index (SubEventInfo), which
+  /// is written in the sub_events table of the output, so that the
+  /// particles of every decay can be separated again. Everything else
+  /// is per event: the energy threshold of the DefaultEventAction applies
+  /// to the energy deposited by all the decays together, and the sensor
+  /// hits and waveforms contain the light of all of them.
 
   class Kr83mGenerator: public G4VPrimaryGenerator
   {
@@ -58,6 +70,9 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event* evt);
 
   private:
+    void SetRegion(G4String);
+    /// Returns the vertex of a single decay starting at the given time
+    G4PrimaryVertex* GenerateDecay(G4double time);
 
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
@@ -70,7 +85,11 @@ namespace nexus {
     std::vector<double> probability_Xrays_; // Probability to emit an X-ray of the above energy, per decay.
                                             // We make cumulative, for easy access for random number.
 
+    G4int decays_per_event_;      ///< Number of independent decays in every event
+    G4double decay_time_window_;  ///< Time window in which these decays happen
+
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
     G4ParticleDefinition*  particle_defgamma_;
     G4ParticleDefinition*  particle_defelectron_;
   };
@@ -24,6 +24,9 @@
 #include <G4RandomDirection.hh>
 #include <Randomize.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VSolid.hh>
 
 #include <TMath.h>
 #include <TFile.h>
@@ -39,7 +42,7 @@ REGISTER_CLASS(MuonAngleGenerator, G4VPrimaryGenerator)
 MuonAngleGenerator::MuonAngleGenerator():
   G4VPrimaryGenerator(), msg_(0), particle_definition_(0),
   angular_generation_(true), rPhi_(NULL), energy_min_(0.),
-  energy_max_(0.), distribution_(0), geom_(0), geom_solid_(0)
+  energy_max_(0.), projected_area_(false), geom_(0), geom_solid_(0)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/MuonAngleGenerator/",
 				"Control commands of muongenerator.");
@@ -56,7 +59,7 @@ MuonAngleGenerator::MuonAngleGenerator():
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &MuonAngleGenerator::SetRegion,
 			"Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclareProperty("angles_on", angular_generation_,
@@ -67,6 +70,9 @@ MuonAngleGenerator::MuonAngleGenerator():
   msg_->DeclareProperty("angle_dist", dist_name_,
 			"Name of the angular distribution histogram.");
 
+  msg_->DeclareProperty("projected_area", projected_area_,
+			"Generate the muons uniformly on the area of the target box projected along their direction, weighting the angular distribution with that area (alternative sampling model, the region is not used).");
+
   G4GenericMessenger::Command& rotation =
     msg_->DeclareProperty("azimuth_rotation", axis_rotation_,
 			  "Angle between north and nexus z in anticlockwise");
@@ -76,6 +82,7 @@ MuonAngleGenerator::MuonAngleGenerator():
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 
 }
 
@@ -94,16 +101,83 @@ void MuonAngleGenerator::SetupAngles()
   rPhi_ = new G4RotationMatrix();
   rPhi_->rotateY(-axis_rotation_);
 
+  // Get the solid to check overlap
+  geom_solid_ =
+    geom_->GetLogicalVolume()->GetDaughter(0)->GetLogicalVolume()->GetSolid();
+
+  if (projected_area_)
+    SetupTarget();
+
   // Get the Angular distribution from file.
   TFile angle_file(ang_file_);
-  angle_file.GetObject(dist_name_, distribution_);
-  distribution_->SetDirectory(0);
+  TH2F* distribution = 0;
+  angle_file.GetObject(dist_name_, distribution);
+  if (!distribution)
+    G4Exception("[MuonAngleGenerator]", "SetupAngles()", FatalException,
+                ("Cannot read angular distribution " + dist_name_ +
+                 " from " + ang_file_).c_str());
+
+  // Alias table of the bins of the distribution, with the azimuth
+  // in the x axis and the zenith angle in the y axis (in units of pi).
+  // With projected_area, the distribution is taken as the flux of muons
+  // per unit area perpendicular to their direction, so every direction
+  // is weighted with the area of the target box projected along it.
+  // This is a sampling model of its own, not a faster version of the
+  // default one (vertices in the region, rejecting the muons that miss
+  // the target), and its results are not expected to be the same.
+  const TAxis* xaxis = distribution->GetXaxis();
+  const TAxis* yaxis = distribution->GetYaxis();
+  const G4int nx = xaxis->GetNbins();
+  const G4int ny = yaxis->GetNbins();
+
+  azimuth_edges_.resize(nx + 1);
+  zenith_edges_.resize(ny + 1);
+  for (G4int i=0; i<=nx; ++i) azimuth_edges_[i] = xaxis->GetBinLowEdge(i+1) * pi;
+  for (G4int j=0; j<=ny; ++j) zenith_edges_[j]  = yaxis->GetBinLowEdge(j+1) * pi;
+
+  std::vector<G4double> weights(nx * ny);
+  for (G4int i=0; i<nx; ++i) {
+    for (G4int j=0; j<ny; ++j) {
+      G4double weight = distribution->GetBinContent(i+1, j+1);
+      if (projected_area_ && weight > 0.) {
+        G4double azimuth = (azimuth_edges_[i] + azimuth_edges_[i+1]) / 2.;
+        G4double zenith  = (zenith_edges_[j]  + zenith_edges_[j+1])  / 2.;
+        weight *= ProjectedArea(GetDirection(azimuth, zenith));
+      }
+      weights[i * ny + j] = weight;
+    }
+  }
+  angle_sampler_.SetWeights(weights);
+
+  delete distribution;
   angle_file.Close();
 
-  // Get the solid to check overlap
-  geom_solid_ =
-    geom_->GetLogicalVolume()->GetDaughter(0)->GetLogicalVolume()->GetSolid();
+  if (angle_sampler_.IsEmpty())
+    G4Exception("[MuonAngleGenerator]", "SetupAngles()", FatalException,
+                ("Empty angular distribution " + dist_name_).c_str());
+}
+
+
+void MuonAngleGenerator::SetupTarget()
+{
+  // The target is the volume placed in the geometry wrapper,
+  // described by the bounding box of its solid
+  G4VPhysicalVolume* target = geom_->GetLogicalVolume()->GetDaughter(0);
 
+  G4ThreeVector lower, upper;
+  target->GetLogicalVolume()->GetSolid()->BoundingLimits(lower, upper);
+
+  target_center_    = (upper + lower) / 2.;
+  target_half_size_ = (upper - lower) / 2.;
+  target_rotation_  = target->GetObjectRotationValue();
+  target_position_  = target->GetObjectTranslation();
+}
+
+
+void MuonAngleGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
 }
 
 
@@ -127,13 +201,20 @@ void MuonAngleGenerator::GeneratePrimaryVertex(G4Event* event)
   G4double energy = kinetic_energy + mass;
   G4double pmod   = std::sqrt(energy*energy - mass*mass);
 
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4ThreeVector position;
   G4ThreeVector p_dir(0., -1., 0.);
-  if (angular_generation_){
+  if (angular_generation_ && projected_area_) {
     GetDirection(p_dir);
+    position = ProjectedAreaVertex(p_dir);
+  }
+  else if (angular_generation_) {
+    GetDirection(p_dir);
+    position = vertex_sampler_();
     while ( !CheckOverlap(position, p_dir) )
-      position = geom_->GenerateVertex(region_);
+      position = vertex_sampler_();
   }
+  else
+    position = vertex_sampler_();
 
   G4double px = pmod * p_dir.x();
   G4double py = pmod * p_dir.y();
@@ -175,20 +256,30 @@ G4String MuonAngleGenerator::MuonCharge() const
 
 void MuonAngleGenerator::GetDirection(G4ThreeVector& dir)
 {
-  // GetAngles from file?? Azimuth defined anticlockwise
-  // From north
-  G4double zenith  = 0.;
-  G4double azimuth = 0.;
-  distribution_->GetRandom2(azimuth, zenith);
-  // !! Current distribution in units of pi
-  zenith  *= pi;
-  azimuth *= pi;
-
-  dir.setX(sin(zenith) * sin(azimuth));
-  dir.setY(-cos(zenith));
-  dir.setZ(-sin(zenith) * cos(azimuth));
+  // Bin of the distribution, and uniform angles within it
+  size_t bin = angle_sampler_.Shoot();
+  size_t i = bin / (zenith_edges_.size() - 1);
+  size_t j = bin % (zenith_edges_.size() - 1);
+
+  G4double azimuth = azimuth_edges_[i] +
+    G4UniformRand() * (azimuth_edges_[i+1] - azimuth_edges_[i]);
+  G4double zenith  = zenith_edges_[j] +
+    G4UniformRand() * (zenith_edges_[j+1] - zenith_edges_[j]);
+
+  dir = GetDirection(azimuth, zenith);
+}
+
+
+G4ThreeVector MuonAngleGenerator::GetDirection(G4double azimuth,
+                                               G4double zenith) const
+{
+  // Azimuth defined anticlockwise from north
+  G4ThreeVector dir(sin(zenith) * sin(azimuth),
+                    -cos(zenith),
+                    -sin(zenith) * cos(azimuth));
 
   dir *= *rPhi_;
+  return dir;
 }
 
 
@@ -203,3 +294,46 @@ G4bool MuonAngleGenerator::CheckOverlap(const G4ThreeVector& vtx,
 
   return true;
 }
+
+
+G4double MuonAngleGenerator::ProjectedArea(const G4ThreeVector& dir) const
+{
+  G4ThreeVector local = target_rotation_.inverse() * dir;
+  const G4ThreeVector& h = target_half_size_;
+
+  return 4. * (h.y() * h.z() * std::abs(local.x()) +
+               h.x() * h.z() * std::abs(local.y()) +
+               h.x() * h.y() * std::abs(local.z()));
+}
+
+
+G4ThreeVector MuonAngleGenerator::ProjectedAreaVertex(const G4ThreeVector& dir) const
+{
+  // The faces of the box crossed by the muons entering it cover its
+  // projected area once, each with its area times |cos| of the angle
+  // between its normal and the direction: a face chosen with that
+  // weight and a uniform point on it give a uniform point in the
+  // projected area
+  G4ThreeVector local = target_rotation_.inverse() * dir;
+  const G4ThreeVector& h = target_half_size_;
+
+  G4double weights[3] = {h.y() * h.z() * std::abs(local.x()),
+                         h.x() * h.z() * std::abs(local.y()),
+                         h.x() * h.y() * std::abs(local.z())};
+
+  G4double rnd = G4UniformRand() * (weights[0] + weights[1] + weights[2]);
+  G4int axis = (rnd < weights[0]) ? 0 : (rnd < weights[0] + weights[1]) ? 1 : 2;
+
+  G4ThreeVector point;
+  for (G4int i=0; i<3; ++i) {
+    if (i == axis)
+      point[i] = (local[i] > 0.) ? -h[i] : h[i];
+    else
+      point[i] = h[i] * (2. * G4UniformRand() - 1.);
+  }
+  point += target_center_;
+
+  // Start just outside the entrance face
+  G4ThreeVector vertex = target_rotation_ * point + target_position_;
+  return vertex - 1. * mm * dir;
+}
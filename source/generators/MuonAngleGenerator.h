@@ -10,21 +10,22 @@
 #ifndef MUON_ANGLE_GENERATOR_H
 #define MUON_ANGLE_GENERATOR_H
 
+#include "AliasSampler.h"
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 #include <G4RotationMatrix.hh>
+#include <vector>
 
 class G4GenericMessenger;
 class G4Event;
 class G4ParticleDefinition;
 class G4VSolid;
 
-class TH2F;
-
 
 namespace nexus {
 
-  class GeometryBase;
-
   class MuonAngleGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -39,6 +40,7 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
 
     // Sets the rotation angle and the spectra to
     // be read for angle generation as well as
@@ -51,10 +53,25 @@ namespace nexus {
     G4String MuonCharge() const;
 
     void GetDirection(G4ThreeVector& dir);
+    G4ThreeVector GetDirection(G4double azimuth, G4double zenith) const;
 
     G4bool CheckOverlap(const G4ThreeVector& vtx,
     			const G4ThreeVector& dir);
 
+    // Projected area model (projected_area option): the muons start on
+    // the bounding box of the target, uniformly in the area projected
+    // along their direction, and the angular distribution is weighted
+    // with that area. It is an alternative to generating the vertices
+    // in the region, with different assumptions on the flux.
+
+    /// Finds the bounding box of the volume targeted by the muons
+    void SetupTarget();
+    /// Area of the target box projected on a plane perpendicular to dir
+    G4double ProjectedArea(const G4ThreeVector& dir) const;
+    /// Random point, just outside the target box, on the line of a muon
+    /// of direction dir crossing it, uniform in the projected area
+    G4ThreeVector ProjectedAreaVertex(const G4ThreeVector& dir) const;
+
   private:
     G4GenericMessenger* msg_;
 
@@ -68,15 +85,25 @@ namespace nexus {
     G4double energy_max_; ///< Maximum kinetic energy
 
     G4String region_; ///< Name of generator region
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
     G4String ang_file_; ///< Name of file with distributions
     G4String dist_name_; ///< Name of distribution in file
 
-    TH2F * distribution_; ///< Anglular distribution
+    AliasSampler angle_sampler_; ///< Bins of the angular distribution
+    std::vector<G4double> azimuth_edges_; ///< Bin edges of the azimuth
+    std::vector<G4double> zenith_edges_;  ///< Bin edges of the zenith angle
+
+    G4bool projected_area_; ///< Alternative model: vertices on the projected area of the target
 
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4VSolid * geom_solid_;
 
+    G4RotationMatrix target_rotation_; ///< Placement of the target volume
+    G4ThreeVector target_position_;
+    G4ThreeVector target_center_;      ///< Target box in its local frame
+    G4ThreeVector target_half_size_;
+
   };
 
 } // end namespace nexus
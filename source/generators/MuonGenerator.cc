@@ -24,7 +24,6 @@
 #include <Randomize.hh>
 #include <G4OpticalPhoton.hh>
 
-#include <TF1.h>
 #include <TMath.h>
 
 #include "CLHEP/Units/SystemOfUnits.h"
@@ -37,7 +36,8 @@ REGISTER_CLASS(MuonGenerator, G4VPrimaryGenerator)
 
 MuonGenerator::MuonGenerator():
   G4VPrimaryGenerator(), msg_(0), particle_definition_(0),
-  energy_min_(0.), energy_max_(0.), geom_(0), momentum_{}
+  energy_min_(0.), energy_max_(0.), geom_(0), momentum_{},
+  theta_bin_width_(0.)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/MuonGenerator/",
 				"Control commands of muongenerator.");
@@ -54,7 +54,7 @@ MuonGenerator::MuonGenerator():
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &MuonGenerator::SetRegion,
 			"Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclarePropertyWithUnit("momentum", "mm",  momentum_,
@@ -63,7 +63,19 @@ MuonGenerator::MuonGenerator():
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
-
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
+
+  // Alias table of the cos^2 distribution of the zenith angle
+  // in [0, pi/2], with the exact integral of every bin
+  const G4int num_bins = 2000;
+  theta_bin_width_ = halfpi / num_bins;
+  std::vector<G4double> weights(num_bins);
+  for (G4int i=0; i<num_bins; ++i) {
+    G4double low  = i * theta_bin_width_;
+    G4double high = low + theta_bin_width_;
+    weights[i] = (high - low)/2. + (std::sin(2.*high) - std::sin(2.*low))/4.;
+  }
+  theta_sampler_.SetWeights(weights);
 }
 
 
@@ -74,6 +86,12 @@ MuonGenerator::~MuonGenerator()
   delete msg_;
 }
 
+void MuonGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
 void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   particle_definition_ = G4ParticleTable::GetParticleTable()->FindParticle(MuonCharge());
@@ -82,7 +100,7 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
                 FatalException, " can not create a muon ");
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4ThreeVector position = vertex_sampler_();
   // Particle generated at start-of-event
   G4double time = 0.;
   // Create a new vertex
@@ -149,9 +167,7 @@ G4String MuonGenerator::MuonCharge() const
 
 G4double MuonGenerator::GetTheta() const
 {
-  TF1 *f1 = new TF1("f1","pow(cos(x),2)",0,pi/2);
-  G4double theta = f1->GetRandom();
-  return theta;
+  return (theta_sampler_.Shoot() + G4UniformRand()) * theta_bin_width_;
 }
 
 
@@ -10,7 +10,11 @@
 #ifndef MUON_GENERATOR_H
 #define MUON_GENERATOR_H
 
+#include "AliasSampler.h"
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
 class G4Event;
@@ -19,8 +23,6 @@ class G4ParticleDefinition;
 
 namespace nexus {
 
-  class GeometryBase;
-
   class MuonGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -35,6 +37,7 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
 
     /// Generate a random kinetic energy with flat probability in
     //  the interval [energy_min, energy_max].
@@ -52,10 +55,14 @@ namespace nexus {
     G4double energy_max_; ///< Maximum kinetic energy
 
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
 
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4ThreeVector momentum_;
+
+    AliasSampler theta_sampler_; ///< Bins of the zenith angle distribution
+    G4double theta_bin_width_;
   };
 
 } // end namespace nexus
@@ -37,23 +37,30 @@ namespace nexus {
      msg_ = new G4GenericMessenger(this, "/Generator/Na22Generator/",
     "Control commands of Na22 generator.");
 
-     msg_->DeclareProperty("region", region_,
+     msg_->DeclareMethod("region", &Na22Generator::SetRegion,
 			   "Set the region of the geometry where the vertex will be generated.");
 
 
     DetectorConstruction* detconst = (DetectorConstruction*)
       G4RunManager::GetRunManager()->GetUserDetectorConstruction();
     geom_ = detconst->GetGeometry();
+    vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
   }
 
   Na22Generator::~Na22Generator()
   {
   }
 
+  void Na22Generator::SetRegion(G4String region)
+  {
+    region_ = region;
+    vertex_sampler_ = geom_->GetVertexSampler(region_);
+  }
+
   void Na22Generator::GeneratePrimaryVertex(G4Event* evt)
   {
     // Ask the geometry to generate a position for the particle
-    G4ThreeVector position = geom_->GenerateVertex(region_);
+    G4ThreeVector position = vertex_sampler_();
     G4double time = 0.;
     G4PrimaryVertex* vertex =
         new G4PrimaryVertex(position, time);
@@ -11,15 +11,16 @@
 #ifndef NA22_GENERATOR_H
 #define NA22_GENERATOR_H
 
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4Event;
 class G4GenericMessenger;
 
 namespace nexus {
 
-  class GeometryBase;
-
   class Na22Generator: public G4VPrimaryGenerator
   {
   public:
@@ -31,11 +32,13 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event* evt);
 
   private:
+    void SetRegion(G4String);
 
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
 
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
 
   };
 
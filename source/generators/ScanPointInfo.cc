@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// nexus | ScanPointInfo.cc
+//
+// This class is a utility to add the point of the scan of a light table
+// to the primary vertex of the ScintillationGenerator class.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ScanPointInfo.h"
+
+using namespace nexus;
+
+ScanPointInfo::ScanPointInfo(G4int point, const G4ThreeVector& position):
+  point_(point), position_(position)
+{
+}
+
+ScanPointInfo::~ScanPointInfo()
+{
+}
+
+void ScanPointInfo::Print() const
+{
+  G4cout << "Scan point " << point_ << " at " << position_ << G4endl;
+}
@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------------
+// nexus | ScanPointInfo.h
+//
+// This class is a utility to add the point of the scan of a light table
+// to the primary vertex of the ScintillationGenerator class.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SCAN_POINT_INFO_H
+#define SCAN_POINT_INFO_H
+
+#include <G4VUserPrimaryVertexInformation.hh>
+#include <G4ThreeVector.hh>
+#include "globals.hh"
+
+namespace nexus {
+
+  class ScanPointInfo: public G4VUserPrimaryVertexInformation
+  {
+  public:
+    //constructor
+    ScanPointInfo(G4int point, const G4ThreeVector& position);
+    //destructor
+    ~ScanPointInfo();
+
+    void Print() const;
+    G4int GetPoint() const;
+    const G4ThreeVector& GetPosition() const;
+
+  private:
+
+    G4int point_;
+    G4ThreeVector position_;
+  };
+
+  inline G4int ScanPointInfo::GetPoint() const
+  { return point_; }
+  inline const G4ThreeVector& ScanPointInfo::GetPosition() const
+  { return position_; }
+
+} // end namespace nexus
+
+#endif
@@ -14,6 +14,7 @@
 #include "GeometryBase.h"
 #include "OpticalMaterialProperties.h"
 #include "FactoryBase.h"
+#include "ScanPointInfo.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4ParticleDefinition.hh>
@@ -21,34 +22,108 @@
 #include <G4ParticleTable.hh>
 #include <G4PrimaryVertex.hh>
 #include <G4Event.hh>
-#include <G4RandomDirection.hh>
 #include <G4OpticalPhoton.hh>
+#include <Randomize.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
 using namespace nexus;
 using namespace CLHEP;
 
 REGISTER_CLASS(ScintillationGenerator, G4VPrimaryGenerator)
 
 
+namespace {
+
+  // Random numbers drawn per photon: two for the energy,
+  // two for the direction and two for the polarization
+  const G4int RANDOMS_PER_PHOTON = 6;
+  // Photons whose random numbers are drawn in a single call to the engine
+  const G4int PHOTONS_PER_CHUNK = 4096;
+
+  // Isotropic direction from two uniform random numbers,
+  // as G4RandomDirection() draws it
+  inline G4ThreeVector IsotropicDirection(G4double u, G4double v)
+  {
+    G4double cost = 2. * u - 1.;
+    G4double sint = std::sqrt(std::max(0., (1. - cost) * (1. + cost)));
+    G4double phi  = twopi * v;
+    return G4ThreeVector(sint * std::cos(phi), sint * std::sin(phi), cost);
+  }
+
+}
+
+
 ScintillationGenerator::ScintillationGenerator() :
-  G4VPrimaryGenerator(), msg_(0), geom_(0), nphotons_(1000000)
+  G4VPrimaryGenerator(), msg_(0), geom_(0), nphotons_(1000000),
+  photon_weight_(1),
+  map_min_(0., 0., 0.), map_max_(0., 0., 0.), map_voxel_size_(0., 0., 0.),
+  map_first_voxel_(0),
+  scan_min_(0., 0., 0.), scan_max_(0., 0., 0.), scan_step_(0., 0., 0.),
+  events_per_point_(1), scan_first_point_(0),
+  randoms_(RANDOMS_PER_PHOTON * PHOTONS_PER_CHUNK)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/ScintGenerator/",
     "Control commands of scintillation generator.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &ScintillationGenerator::SetRegion,
                         "Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclareProperty("nphotons", nphotons_, "Set number of photons");
 
+  G4GenericMessenger::Command& weight_cmd =
+    msg_->DeclareProperty("photon_weight", photon_weight_,
+                          "Number of photons carried by each optical photon tracked.");
+  weight_cmd.SetParameterName("photon_weight", false);
+  weight_cmd.SetRange("photon_weight>=1");
+
+  msg_->DeclarePropertyWithUnit("map_min", "mm", map_min_,
+    "Lower corner of the voxel grid of the S1 light map to be produced.");
+  msg_->DeclarePropertyWithUnit("map_max", "mm", map_max_,
+    "Upper corner of the voxel grid of the S1 light map to be produced.");
+  msg_->DeclarePropertyWithUnit("map_voxel_size", "mm", map_voxel_size_,
+    "Voxel size of the S1 light map; if set, each event is generated in a voxel.");
+
+  G4GenericMessenger::Command& first_cmd =
+    msg_->DeclareProperty("map_first_voxel", map_first_voxel_,
+                          "Voxel of the S1 light map of the first event.");
+  first_cmd.SetParameterName("map_first_voxel", false);
+  first_cmd.SetRange("map_first_voxel>=0");
+
+  msg_->DeclarePropertyWithUnit("scan_min", "mm", scan_min_,
+    "First point of the grid of points of the scan.");
+  msg_->DeclarePropertyWithUnit("scan_max", "mm", scan_max_,
+    "Last point of the grid of points of the scan.");
+  msg_->DeclarePropertyWithUnit("scan_step", "mm", scan_step_,
+    "Step of the grid of points of the scan (zero for a single point in an axis).");
+
+  msg_->DeclareMethod("scan_points_file", &ScintillationGenerator::ReadScanPoints,
+                      "File with the points of the scan (x y z in mm per line).");
+
+  G4GenericMessenger::Command& per_point_cmd =
+    msg_->DeclareProperty("events_per_point", events_per_point_,
+                          "Number of events generated at every point of the scan.");
+  per_point_cmd.SetParameterName("events_per_point", false);
+  per_point_cmd.SetRange("events_per_point>=1");
+
+  G4GenericMessenger::Command& first_point_cmd =
+    msg_->DeclareProperty("scan_first_point", scan_first_point_,
+                          "Point of the scan of the first event.");
+  first_point_cmd.SetParameterName("scan_first_point", false);
+  first_point_cmd.SetRange("scan_first_point>=0");
+
   geom_navigator_ =
     G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
 
   DetectorConstruction* detconst =
     (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 }
 
 ScintillationGenerator::~ScintillationGenerator()
@@ -56,20 +131,41 @@ ScintillationGenerator::~ScintillationGenerator()
   delete msg_;
 }
 
+void ScintillationGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
 void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   G4ParticleDefinition* particle_definition = G4OpticalPhoton::Definition();
   // Generate an initial position for the particle using the geometry and set time to 0.
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4bool scan_mode = !scan_points_.empty() || scan_step_.mag2() > 0.;
+  G4int scan_point = scan_mode ? GetScanPoint(event->GetEventID()) : -1;
+
+  G4ThreeVector position;
+  if (scan_mode)
+    position = scan_points_[scan_point];
+  else if (map_voxel_size_.mag2() > 0.)
+    position = GenerateVoxelVertex(event->GetEventID());
+  else
+    position = vertex_sampler_();
   G4double time = 0.;
 
-  // Energy is sampled from integral (like it is done in G4Scintillation)
+  // Energy is sampled from the scintillation spectrum of the material
 
   G4VPhysicalVolume* vol =
     geom_navigator_->LocateGlobalPointAndSetup(position, 0, false);
   G4Material* mat = vol->GetLogicalVolume()->GetMaterial();
   G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
 
+  // Voxels of the map (partly) outside the scintillating material
+  // and points of the scan outside it get no light from those points
+  G4bool voxel_mode = map_voxel_size_.mag2() > 0.;
+  if ((voxel_mode || scan_mode) &&
+      (!mpt || !mpt->GetProperty("FASTCOMPONENT"))) return;
+
   if (!mpt) {
     G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
                 "Material properties not defined for this material!");
@@ -83,48 +179,142 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
                 "Fast time decay constant not defined for this material!");
   }
 
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    new G4PhysicsOrderedFreeVector();
-  ComputeCumulativeDistribution(*spectrum, *spectrum_integral);
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  // The sampler of the spectrum is built once per material
+  auto it = spectra_.find(mat);
+  if (it == spectra_.end()) {
+    SpectrumSampler new_sampler(*spectrum);
+    if (new_sampler.IsEmpty()) {
+      G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
+                  ("The FASTCOMPONENT spectrum of " + mat->GetName() +
+                   " has no positive intensity!").c_str());
+    }
+    it = spectra_.insert(std::make_pair(mat, new_sampler)).first;
+  }
+  const SpectrumSampler& sampler = it->second;
 
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  if (scan_mode) vertex->SetUserInformation(new ScanPointInfo(scan_point, position));
+
+  // Macro-photons: each primary carries photon_weight_ photons. The
+  // number of primaries is rounded stochastically to keep the mean.
+  G4int num_primaries = nphotons_ / photon_weight_;
+  if (G4UniformRand() * photon_weight_ < nphotons_ % photon_weight_)
+    ++num_primaries;
 
-  for ( G4int i = 0; i<nphotons_; i++)
-    {
-      // Generate random direction by default
-      G4ThreeVector _momentum_direction = G4RandomDirection();
-      // Determine photon energy
-      G4double sc_value = G4UniformRand()*sc_max;
-      G4double pmod = spectrum_integral->GetEnergy(sc_value);
-      G4double px = pmod * _momentum_direction.x();
-      G4double py = pmod * _momentum_direction.y();
-      G4double pz = pmod * _momentum_direction.z();
+  // The random numbers of the photons are drawn in chunks of a fixed
+  // size, with a single call to the engine per chunk, into a buffer
+  // allocated once. The sequence of numbers does not depend on the size.
+  for (G4int first=0; first<num_primaries; first+=PHOTONS_PER_CHUNK) {
+    const G4int num_photons = std::min(PHOTONS_PER_CHUNK, num_primaries - first);
+    G4Random::getTheEngine()->flatArray(RANDOMS_PER_PHOTON * num_photons,
+                                        randoms_.data());
+
+    const G4double* u = randoms_.data();
+    for (G4int i=0; i<num_photons; ++i, u+=RANDOMS_PER_PHOTON) {
+      G4double pmod = sampler.Sample(u[0], u[1]);
+      G4ThreeVector momentum = pmod * IsotropicDirection(u[2], u[3]);
 
       // Create the new primary particle and set it some properties
       G4PrimaryParticle* particle =
-        new G4PrimaryParticle(particle_definition, px, py, pz);
-
-      G4ThreeVector polarization = G4RandomDirection();
-      particle->SetPolarization(polarization);
+        new G4PrimaryParticle(particle_definition, momentum.x(), momentum.y(), momentum.z());
+      particle->SetPolarization(IsotropicDirection(u[4], u[5]));
+      particle->SetWeight(photon_weight_);
 
-      // Add particle to the vertex and this to the event
+      // Add particle to the vertex
       vertex->SetPrimary(particle);
     }
+  }
+
   event->AddPrimaryVertex(vertex);
 }
 
-void ScintillationGenerator::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
+G4ThreeVector ScintillationGenerator::GenerateVoxelVertex(G4int event_id) const
+{
+  // Voxels are numbered (ix*ny + iy)*nz + iz, as in S1LightMap
+  G4int bins[3];
+  for (G4int i=0; i<3; ++i) {
+    if (map_voxel_size_[i] <= 0. || map_max_[i] <= map_min_[i]) {
+      G4Exception("[ScintillationGenerator]", "GenerateVoxelVertex()", FatalException,
+                  "Wrong voxel grid of the S1 light map.");
+    }
+    bins[i] = G4int(std::ceil((map_max_[i] - map_min_[i])/map_voxel_size_[i] - 1.e-6));
+  }
+
+  G4int voxel = map_first_voxel_ + event_id;
+  if (voxel >= bins[0]*bins[1]*bins[2]) {
+    G4Exception("[ScintillationGenerator]", "GenerateVoxelVertex()", FatalException,
+                ("Voxel " + std::to_string(voxel) +
+                 " is outside the grid of the S1 light map.").c_str());
+  }
+
+  G4int index[3] = {voxel / (bins[1]*bins[2]), (voxel / bins[2]) % bins[1], voxel % bins[2]};
+
+  G4ThreeVector vertex;
+  for (G4int i=0; i<3; ++i)
+    vertex[i] = map_min_[i] + (index[i] + G4UniformRand()) * map_voxel_size_[i];
+
+  return vertex;
+}
+
+void ScintillationGenerator::ReadScanPoints(G4String filename)
+{
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4Exception("[ScintillationGenerator]", "ReadScanPoints()", FatalErrorInArgument,
+                ("Cannot open file of scan points " + filename).c_str());
+  }
+
+  scan_points_.clear();
+
+  G4String line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream iss(line);
+    G4double x, y, z;
+    if (!(iss >> x >> y >> z)) {
+      G4Exception("[ScintillationGenerator]", "ReadScanPoints()", FatalErrorInArgument,
+                  ("Wrong line in file of scan points " + filename + ": " + line).c_str());
+    }
+    scan_points_.push_back(G4ThreeVector(x, y, z) * mm);
+  }
+
+  if (scan_points_.empty()) {
+    G4Exception("[ScintillationGenerator]", "ReadScanPoints()", FatalErrorInArgument,
+                ("No points in file of scan points " + filename).c_str());
+  }
+}
+
+G4int ScintillationGenerator::GetScanPoint(G4int event_id)
 {
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+  // The nodes of the grid are built at the first event, in the
+  // order (ix*ny + iy)*nz + iz, and include both ends of every axis
+  if (scan_points_.empty()) {
+    G4int bins[3];
+    for (G4int i=0; i<3; ++i) {
+      if (scan_step_[i] < 0. || scan_max_[i] < scan_min_[i] ||
+          (scan_step_[i] == 0. && scan_max_[i] > scan_min_[i])) {
+        G4Exception("[ScintillationGenerator]", "GetScanPoint()", FatalException,
+                    "Wrong grid of points of the scan.");
+      }
+      bins[i] = (scan_step_[i] > 0.) ?
+        G4int(std::floor((scan_max_[i] - scan_min_[i])/scan_step_[i] + 1.e-6)) + 1 : 1;
+    }
+
+    for (G4int ix=0; ix<bins[0]; ++ix)
+      for (G4int iy=0; iy<bins[1]; ++iy)
+        for (G4int iz=0; iz<bins[2]; ++iz)
+          scan_points_.push_back(scan_min_ + G4ThreeVector(ix * scan_step_.x(),
+                                                           iy * scan_step_.y(),
+                                                           iz * scan_step_.z()));
   }
+
+  G4int point = scan_first_point_ + event_id / events_per_point_;
+  if (point >= G4int(scan_points_.size())) {
+    G4Exception("[ScintillationGenerator]", "GetScanPoint()", FatalException,
+                ("Point " + std::to_string(point) +
+                 " is outside the list of points of the scan.").c_str());
+  }
+
+  return point;
 }
@@ -11,20 +11,23 @@
 #ifndef SCINTILLATION_GENERATOR_H
 #define SCINTILLATION_GENERATOR_H
 
+#include "SpectrumSampler.h"
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <G4Navigator.hh>
 #include <G4TransportationManager.hh>
+#include <G4ThreeVector.hh>
+
+#include <map>
+#include <vector>
 
 class G4GenericMessenger;
 class G4Event;
-class G4PhysicsOrderedFreeVector;
+class G4Material;
 
 namespace nexus {
 
-  class GeometryBase;
-
-
-
   class ScintillationGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -39,17 +42,52 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
+
+    /// Returns the vertex of the event in voxel-map mode: a random
+    /// point inside the voxel of the S1 light map given by the event id
+    G4ThreeVector GenerateVoxelVertex(G4int event_id) const;
 
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
+    /// Read the points of the scan from a file with a point
+    /// per line, given as x y z in mm
+    void ReadScanPoints(G4String filename);
+    /// Returns the index of the point of the scan of the event
+    G4int GetScanPoint(G4int event_id);
 
     G4GenericMessenger* msg_;
     G4Navigator* geom_navigator_; ///< Geometry Navigator
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
     G4int    nphotons_;
-
+    G4int    photon_weight_; ///< Photons carried by each primary
+
+    // Voxel grid of the S1 light map to be produced (if the voxel
+    // size is not null), with one event per voxel starting
+    // from voxel map_first_voxel_
+    G4ThreeVector map_min_;
+    G4ThreeVector map_max_;
+    G4ThreeVector map_voxel_size_;
+    G4int map_first_voxel_;
+
+    // Points of the scan of a light table (if the grid step is not null
+    // or a list of points is given), with events_per_point_ events
+    // per point starting from point scan_first_point_. The point of
+    // every event is written in the output, and the photons detected
+    // by every sensor are added up per point (see ScanPointInfo).
+    G4ThreeVector scan_min_;
+    G4ThreeVector scan_max_;
+    G4ThreeVector scan_step_;
+    G4int events_per_point_;
+    G4int scan_first_point_;
+    std::vector<G4ThreeVector> scan_points_;
+
+    /// Sampler of the scintillation spectrum of every material
+    std::map<const G4Material*, SpectrumSampler> spectra_;
+
+    /// Buffer of the random numbers of a chunk of photons
+    std::vector<G4double> randoms_;
 
   };
 
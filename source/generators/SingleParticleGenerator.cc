@@ -61,7 +61,7 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &SingleParticleGenerator::SetRegion,
     "Set the region of the geometry where the vertex will be generated.");
 
 
@@ -79,6 +79,7 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
+  vertex_sampler_ = [this]() { return geom_->GenerateVertex(region_); };
 }
 
 
@@ -102,6 +103,14 @@ void SingleParticleGenerator::SetParticleDefinition(G4String particle_name)
 
 
 
+void SingleParticleGenerator::SetRegion(G4String region)
+{
+  region_ = region;
+  vertex_sampler_ = geom_->GetVertexSampler(region_);
+}
+
+
+
 void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   // Generate uniform random energy in [E_min, E_max]
@@ -136,7 +145,7 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   }
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4ThreeVector position = vertex_sampler_();
 
   // Particle generated at start-of-event
   G4double time = 0.;
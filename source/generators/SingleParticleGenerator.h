@@ -14,7 +14,10 @@
 #ifndef SINGLE_PARTICLE_GENERATOR_H
 #define SINGLE_PARTICLE_GENERATOR_H
 
+#include "GeometryBase.h"
+
 #include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
 class G4Event;
@@ -23,8 +26,6 @@ class G4ParticleDefinition;
 
 namespace nexus {
 
-  class GeometryBase;
-
   class SingleParticleGenerator: public G4VPrimaryGenerator
   {
   public:
@@ -39,6 +40,7 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
+    void SetRegion(G4String);
 
     void SetParticleDefinition(G4String);
 
@@ -57,6 +59,7 @@ namespace nexus {
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4String region_;
+    GeometryBase::VertexSampler vertex_sampler_; ///< Sampler of the vertices in the region
 
     G4ThreeVector momentum_;
 
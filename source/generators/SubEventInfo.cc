@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// nexus | SubEventInfo.cc
+//
+// This class is a utility to label the primary vertices of the generators
+// that simulate several independent decays in the same event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SubEventInfo.h"
+
+using namespace nexus;
+
+SubEventInfo::SubEventInfo(G4int sub_event):
+  sub_event_(sub_event)
+{
+}
+
+SubEventInfo::~SubEventInfo()
+{
+}
+
+void SubEventInfo::Print() const
+{
+  G4cout << "Sub-event " << sub_event_ << G4endl;
+}
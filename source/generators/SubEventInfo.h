@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------------------
+// nexus | SubEventInfo.h
+//
+// This class is a utility to label the primary vertices of the generators
+// that simulate several independent decays in the same event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SUB_EVENT_INFO_H
+#define SUB_EVENT_INFO_H
+
+#include <G4VUserPrimaryVertexInformation.hh>
+#include "globals.hh"
+
+namespace nexus {
+
+  /// The persistency manager gives the label of the vertex to its
+  /// primary particles and all their descendants, so that the logical
+  /// events can be split again in the analysis.
+
+  class SubEventInfo: public G4VUserPrimaryVertexInformation
+  {
+  public:
+    //constructor
+    SubEventInfo(G4int sub_event);
+    //destructor
+    ~SubEventInfo();
+
+    void Print() const;
+    G4int GetSubEvent() const;
+
+  private:
+
+    G4int sub_event_;
+  };
+
+  inline G4int SubEventInfo::GetSubEvent() const
+  { return sub_event_; }
+
+} // end namespace nexus
+
+#endif
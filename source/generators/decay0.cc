@@ -10,6 +10,9 @@
 
 #include <cfloat>
 #include <complex>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
 #include "decay0.h"
 #include <G4RandomDirection.hh>
 #include <Randomize.hh>
@@ -41,7 +44,9 @@ emass_(0.51099906),
 nuclideName_("Xe136"),
 fsNum_(0),
 modebb_(0),
-modebbOld_(0)
+modebbOld_(0),
+e1Low_(0.),
+nRows12_(0)
 {
   ebb1_ = 0.;
   ebb2_ = 4.3; // original code, line 628
@@ -49,13 +54,17 @@ modebbOld_(0)
   fillInfo();
 }
 decay0::decay0(const std::string nuclide, int finalStateNumber,
-               int decayModeNumber, double eRangeLow, double eRangeHigh):
+               int decayModeNumber, double eRangeLow, double eRangeHigh,
+               const std::string cacheFile):
 ready_(false),
 emass_(0.51099906),
 nuclideName_(nuclide),
 fsNum_(finalStateNumber),
 modebb_(decayModeNumber),
-modebbOld_(decayModeNumber)
+modebbOld_(decayModeNumber),
+e1Low_(0.),
+nRows12_(0),
+cacheFile_(cacheFile)
 {
   ebb1_ = eRangeLow;
   ebb2_ = eRangeHigh; // for mode 4, 2nbbdecay.
@@ -218,6 +227,12 @@ void decay0::initSpectrum() {
   int iiMax = static_cast<int>(e0_*1000.); //kEv, as int if I followed correctly...
   spthe1_.resize(iiMax);
   spthe2_.resize(iiMax);
+  e1Low_ = (modebb_ == 10) ? ebb1_ : 0.;
+  if (!cacheFile_.empty() && this->readSpectrumCache()) {
+    std::cout << " decay0::initSpectrum, spectra read from " << cacheFile_ << std::endl;
+    this->buildCdfs();
+    return;
+  }
   std::vector<double> params(10, 0.); // For integration.. oversized
   params[0] = emass_; //
   params[1] = bbNucl_.Zdbb_;
@@ -381,9 +396,229 @@ void decay0::initSpectrum() {
 	   }
 	   toallevents_ = r1/r2;
      }
+     this->fillSpectrum12();
+     this->buildCdfs();
+     if (!cacheFile_.empty()) this->writeSpectrumCache();
      std::cout << " .... starting the generation " << std::endl;
 }
 //
+// Tabulated spectra. The energy of the first e-/e+ follows spthe1_, constant in 1 keV bins,
+// as in the original acceptance/rejection. The spectrum of the second one, for the modes where
+// it is random, is tabulated on rows of fixed e1 every keV, at the centres of nBins12_ bins of
+// the e2 range of the row scaled to [0, 1], so that the range of every row ends exactly at the
+// kinematic limit. It is sampled by choosing one of the two rows around e1 with the weights of a
+// linear interpolation, then a bin of the row, and a point of the bin following the straight
+// line between the values at its edges, interpolated from the neighbouring centres.
+//
+bool decay0::hasRandomE2() const {
+  return ((modebb_ == 4) || (modebb_ == 5) || (modebb_ == 6) || (modebb_ == 8) ||
+          (modebb_ == 13) || (modebb_ == 14) || (modebb_ == 15) || (modebb_ == 16));
+}
+double decay0::fe2(double e2, void *p) const {
+  switch(modebb_) {
+    case 4 : return fe2_mod4(e2, p);
+    case 5 : return fe2_mod5(e2, p);
+    case 6 : return fe2_mod6(e2, p);
+    case 8 : return fe2_mod8(e2, p);
+    case 13 : return fe2_mod13(e2, p);
+    case 14 : return fe2_mod14(e2, p);
+    case 15 : return fe2_mod15(e2, p);
+    case 16 : return fe2_mod16(e2, p);
+    default : return 0.;
+  }
+}
+void decay0::fillSpectrum12() {
+  spthe12_.clear();
+  nRows12_ = 0;
+  if (!this->hasRandomE2()) return;
+  std::vector<double> params(10, 0.);
+  params[0] = emass_;
+  params[1] = bbNucl_.Zdbb_;
+  params[2] = e0_;
+  nRows12_ = static_cast<size_t>(ebb2_*1000.) + 2;
+  spthe12_.assign(nRows12_*nBins12_, 0.);
+  for (size_t j=0; j != nRows12_; j++) {
+    const double e1 = static_cast<double>(j)/1000.;
+    const double re2s = std::max(0., (ebb1_ - e1));
+    const double re2f = ebb2_ - e1;
+    if (re2f <= re2s) continue; // nothing left for the second particle
+    params[3] = e1;
+    for (size_t i=0; i != nBins12_; i++) {
+      const double e2 = re2s + (re2f - re2s)*(static_cast<double>(i) + 0.5)/nBins12_;
+      spthe12_[j*nBins12_ + i] = this->fe2(e2, &params[0]);
+    }
+  }
+}
+namespace {
+  // Densities at the edges of bin i of a row of the e2 spectrum,
+  // interpolated linearly between the centres of the bins
+  void edgeDensities12(const float *row, const size_t i, const size_t n, double &g0, double &g1) {
+    g0 = (i > 0) ? 0.5*(row[i-1] + row[i]) : row[i];
+    g1 = (i+1 < n) ? 0.5*(row[i] + row[i+1]) : row[i];
+  }
+}
+void decay0::buildCdfs() {
+  cdf1_.assign(spthe1_.size()+1, 0.);
+  for (size_t k=0; k != spthe1_.size(); k++) {
+    // spthe1_[k] is the density for e1 in [k+1, k+2) keV
+    const double lo = std::max(e1Low_, static_cast<double>(k+1)/1000.);
+    const double hi = std::min(ebb2_, static_cast<double>(k+2)/1000.);
+    cdf1_[k+1] = cdf1_[k] + ((hi > lo) ? spthe1_[k]*(hi - lo) : 0.);
+  }
+  cdf12_.assign(nRows12_*(nBins12_+1), 0.);
+  for (size_t j=0; j != nRows12_; j++) {
+    const float *row = &spthe12_[j*nBins12_];
+    double *cdf = &cdf12_[j*(nBins12_+1)];
+    // Bins are chosen with the areas of the same linear density used inside them
+    for (size_t i=0; i != nBins12_; i++) {
+      double g0, g1;
+      edgeDensities12(row, i, nBins12_, g0, g1);
+      cdf[i+1] = cdf[i] + 0.5*(g0 + g1);
+    }
+  }
+}
+double decay0::sampleE1() const {
+  const double r = cdf1_.back()*G4UniformRand();
+  size_t k = std::upper_bound(cdf1_.begin()+1, cdf1_.end(), r) - (cdf1_.begin()+1);
+  if (k >= spthe1_.size()) k = spthe1_.size() - 1;
+  const double lo = std::max(e1Low_, static_cast<double>(k+1)/1000.);
+  const double hi = std::min(ebb2_, static_cast<double>(k+2)/1000.);
+  return lo + (hi - lo)*G4UniformRand();
+}
+double decay0::sampleE2(const double e1) const {
+  const double re2s = std::max(0., (ebb1_ - e1));
+  const double re2f = ebb2_ - e1;
+  if (re2f <= re2s) return re2s;
+  const double x = e1*1000.;
+  const size_t jLow = std::min(static_cast<size_t>(x), nRows12_ - 2);
+  const bool upper = G4UniformRand() < (x - jLow);
+  size_t j = upper ? jLow+1 : jLow;
+  if (cdf12_[j*(nBins12_+1) + nBins12_] <= 0.) j = upper ? jLow : jLow+1; // row beyond the kinematic limit
+  const float *row = &spthe12_[j*nBins12_];
+  const double *cdf = &cdf12_[j*(nBins12_+1)];
+  if (cdf[nBins12_] <= 0.) return re2s + (re2f - re2s)*G4UniformRand();
+  const double r = cdf[nBins12_]*G4UniformRand();
+  size_t i = std::upper_bound(cdf+1, cdf+nBins12_+1, r) - (cdf+1);
+  if (i >= nBins12_) i = nBins12_ - 1;
+  // Position in the bin, for a density going linearly from g0 to g1
+  double g0, g1;
+  edgeDensities12(row, i, nBins12_, g0, g1);
+  const double rr = 0.5*(g0 + g1)*G4UniformRand();
+  const double den = g0 + std::sqrt(std::max(0., g0*g0 + 2.*(g1 - g0)*rr));
+  const double f = (den > 0.) ? std::min(1., 2.*rr/den) : G4UniformRand();
+  return re2s + (re2f - re2s)*(static_cast<double>(i) + f)/nBins12_;
+}
+double decay0::sampleCosCorrelation(const double a, const double b, const double c) const {
+  // Inversion of the cumulative distribution, with y = 1 + cos:
+  // F(y) = (a - b + c)*y + (b - 2c)*y*y/2 + c*y*y*y/3
+  const double c1 = a - b + c;
+  const double c2 = 0.5*(b - 2.*c);
+  const double c3 = c/3.;
+  const double r = (2.*a + 2.*c/3.)*G4UniformRand();
+  if (c == 0.) {
+    const double y = 2.*r/(c1 + std::sqrt(std::max(0., c1*c1 + 4.*c2*r)));
+    return std::max(-1., std::min(1., y - 1.));
+  }
+  // Newton iterations kept inside the bracket, as F is monotonous
+  double lo = 0.; double hi = 2.; double y = 1.;
+  for (int it=0; it != 50; it++) {
+    const double g = ((c3*y + c2)*y + c1)*y - r;
+    if (g > 0.) hi = y; else lo = y;
+    const double dg = (3.*c3*y + 2.*c2)*y + c1;
+    double yn = (dg > 0.) ? y - g/dg : 0.5*(lo + hi);
+    if ((yn <= lo) || (yn >= hi)) yn = 0.5*(lo + hi);
+    if (std::abs(yn - y) < 1.e-12) { y = yn; break; }
+    y = yn;
+  }
+  return y - 1.;
+}
+//
+// Cache of the tabulated spectra, valid only for the same nuclide, final state, mode and energy range.
+//
+namespace {
+  const char bbSpectrumCacheMagic[8] = {'N','X','B','B','S','P','C','\0'};
+  struct bbSpectrumCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t mode;
+    uint32_t finalState;
+    uint32_t nBins1;
+    uint32_t nRows12;
+    uint32_t nBins12;
+    char nuclide[16];
+    double e0;
+    double ebb1;
+    double ebb2;
+    double spmax;
+    double toallevents;
+  };
+  void fillCacheHeader(bbSpectrumCacheHeader &h, const std::string &nuclide, size_t mode,
+                       size_t fs, double e0, double ebb1, double ebb2) {
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, bbSpectrumCacheMagic, sizeof(h.magic));
+    h.version = 1;
+    h.mode = mode;
+    h.finalState = fs;
+    nuclide.copy(h.nuclide, sizeof(h.nuclide)-1);
+    h.e0 = e0;
+    h.ebb1 = ebb1;
+    h.ebb2 = ebb2;
+  }
+}
+bool decay0::readSpectrumCache() {
+  std::ifstream fIn(cacheFile_.c_str(), std::ios::binary);
+  if (!fIn.is_open()) return false;
+  bbSpectrumCacheHeader h;
+  fIn.read(reinterpret_cast<char*>(&h), sizeof(h));
+  bbSpectrumCacheHeader expected;
+  fillCacheHeader(expected, nuclideName_, modebb_, fsNum_, e0_, ebb1_, ebb2_);
+  const size_t nRows12 = this->hasRandomE2() ? static_cast<size_t>(ebb2_*1000.) + 2 : 0;
+  if (!fIn || (std::memcmp(h.magic, expected.magic, sizeof(h.magic)) != 0) ||
+      (h.version != expected.version) || (h.mode != expected.mode) ||
+      (h.finalState != expected.finalState) ||
+      (std::memcmp(h.nuclide, expected.nuclide, sizeof(h.nuclide)) != 0) ||
+      (h.e0 != e0_) || (h.ebb1 != ebb1_) || (h.ebb2 != ebb2_) ||
+      (h.nBins1 != spthe1_.size()) || (h.nRows12 != nRows12) || (h.nBins12 != nBins12_)) {
+    std::cerr << " decay0::readSpectrumCache, " << cacheFile_
+              << " does not match this decay, recomputing the spectra " << std::endl;
+    return false;
+  }
+  std::vector<double> spthe1(h.nBins1);
+  std::vector<float> spthe12(nRows12*nBins12_);
+  fIn.read(reinterpret_cast<char*>(&spthe1[0]), spthe1.size()*sizeof(double));
+  if (!spthe12.empty())
+    fIn.read(reinterpret_cast<char*>(&spthe12[0]), spthe12.size()*sizeof(float));
+  if (!fIn) {
+    std::cerr << " decay0::readSpectrumCache, " << cacheFile_
+              << " is truncated, recomputing the spectra " << std::endl;
+    return false;
+  }
+  spthe1_.swap(spthe1);
+  spthe12_.swap(spthe12);
+  nRows12_ = nRows12;
+  spmax_ = h.spmax;
+  toallevents_ = h.toallevents;
+  return true;
+}
+void decay0::writeSpectrumCache() const {
+  std::ofstream fOut(cacheFile_.c_str(), std::ios::binary);
+  if (!fOut.is_open()) {
+    std::cerr << " decay0::writeSpectrumCache, cannot write " << cacheFile_ << std::endl;
+    return;
+  }
+  bbSpectrumCacheHeader h;
+  fillCacheHeader(h, nuclideName_, modebb_, fsNum_, e0_, ebb1_, ebb2_);
+  h.nBins1 = spthe1_.size();
+  h.nRows12 = nRows12_;
+  h.nBins12 = nBins12_;
+  h.spmax = spmax_;
+  h.toallevents = toallevents_;
+  fOut.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  fOut.write(reinterpret_cast<const char*>(&spthe1_[0]), spthe1_.size()*sizeof(double));
+  if (!spthe12_.empty())
+    fOut.write(reinterpret_cast<const char*>(&spthe12_[0]), spthe12_.size()*sizeof(float));
+}
+//
 // Subroutine GENBBsub generates the events of decay of natural
 // radioactive nuclides and various modes of double beta decay.
 // GENBB units: energy and moment - MeV and MeV/c; time - sec.
@@ -415,11 +650,6 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 //                                                          Salvador Dali
 // ***********************************************************************
   const double twopi = 2.0*M_PI;
-  std::vector<double> params(10, 0.);
-  params[0] = emass_; //
-  params[1] = bbNucl_.Zdbb_;
-  params[2] = e0_;
-  void *p = &params[0];
 
   if (modebb_ == 9) {
 //  fixed energies of e+ and X-ray; no angular correlation
@@ -446,21 +676,9 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
     return;
   }
 
-// sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
+// sampling the energies: first e-/e+, by inversion of the cumulative of spthe1_
   double e2=0.;
-  int numThrow = 0;
-//  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
-     if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
-     else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
-//     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
-     const size_t k = static_cast<size_t>(static_cast<int>(e1_*1000.) - 1);
-     if (k >= spthe1_.size()) continue;
-     if(spmax_*G4UniformRand() < spthe1_[k]) break;
-     numThrow++;
-     if (numThrow%1000 == 0) std::cerr << " Thrwing e1 ... " << numThrow
-                                       << " times ... " << std::endl;
-  }
+  e1_ = this->sampleE1();
 //  second e-/e+ or X-ray
    if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
           (modebb_ == 7) || (modebb_ == 17) || (modebb_==18)) {
@@ -470,69 +688,9 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
    } else if ((modebb_ == 4) || (modebb_ == 5) || (modebb_ == 6) ||
             (modebb_ == 8) || (modebb_ == 13) || (modebb_ == 14) ||
             (modebb_ == 15) || (modebb_ == 16))  {
-// something else is emitted - energy of second e-/e+ is random
-	double re2s = std::max(0., (ebb1_ - e1_));
-	double re2f = ebb2_ - e1_;
-	double f2max = -1;
-	params[3] = e1_;
-	int ke2s = std::max(0, static_cast<int>(re2s*1000.)-1);
-	int ke2f= static_cast<int>(re2f*1000.) -1;
-	for (int ke2 = ke2s; ke2 != ke2f; ke2++) {
-	   e2 = 0.0005 + static_cast<double>(ke2)/1000.; // add 1/2 a bin...
-	   size_t kke2 = static_cast<size_t>(ke2) -1;
-	   if (kke2 >= spthe2_.size()) continue; // Should not occur often..
-	   switch(modebb_) {
-	   case 4 :
-	      spthe2_[kke2] = fe2_mod4(e2, p); break;
-	   case 5 :
-	      spthe2_[kke2] = fe2_mod5(e2, p); break;
-	   case 6 :
-	      spthe2_[kke2] = fe2_mod6(e2, p); break;
-	   case  8 :
-	       spthe2_[kke2] = fe2_mod8(e2, p); break;
-	   case 13 :
-	       spthe2_[kke2] = fe2_mod13(e2, p); break;
-	   case 14 :
-	     spthe2_[kke2] = fe2_mod14(e2, p); break;
-	   case 15 :
-	     spthe2_[kke2] = fe2_mod15(e2, p); break;
-	   case 16 :
-	     spthe2_[kke2] = fe2_mod16(e2, p); break;
-	   default:
-	     spthe2_[kke2] = 0.;
-	   }
-	   f2max = std::max(f2max, spthe2_[kke2]);
-	}
-//	std::cerr << " real f2max= "  << f2max << std::endl;
-
-// c2	   e2=(e0-e1)*rnd1(d)
-// sampling the energies: second e-/e+ Acceptance/rejection method (Von Neumann), again
-//
-        while(true) {
-	 e2 = re2s + (re2f-re2s)*G4UniformRand();
-	 double fe2=0.;
-	 switch(modebb_) {
-	   case 4 :
-	     fe2 = fe2_mod4(e2, p); break;
-	   case 5 :
-	     fe2 = fe2_mod5(e2, p); break;
-	   case 6 :
-	     fe2 = fe2_mod6(e2, p); break;
-	   case 8 :
-	     fe2 = fe2_mod8(e2, p); break;
-	   case 13 :
-	     fe2 = fe2_mod13(e2, p); break;
-	   case 14 :
-	     fe2 = fe2_mod14(e2, p); break;
-	   case 15 :
-	     fe2 = fe2_mod15(e2, p); break;
-	   case 16 :
-	     fe2 = fe2_mod16(e2, p); break;
-	   default :
-	     fe2 = 0.; break;
-	 }
-	 if ( f2max*G4UniformRand() < fe2) break;
-        }
+// something else is emitted - energy of second e-/e+ is random,
+// sampled from its tabulated spectrum
+	e2 = this->sampleE2(e1_);
       } else if( modebb_ == 10) {
 // energy of X-ray is fixed; no angular correlation
            this->timedParticle(outPart, 2, e1_, e1_, 0., M_PI, 0., twopi, 0., 0.);
@@ -600,42 +758,32 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 	   endif
 	endif
 	*/
-      const double romaxt = a + std::abs(b) + c;
-      double phi1=0.; double phi2=0.; double ctet1 = 1.0; double stet1 = 0.0;
-      double ctet2 = 1.0; double stet2 = 0.0;
-      numThrow = 0;
-      while(true) {
-	  phi1 = twopi * G4UniformRand();
-	  ctet1 = 1. - 2.* G4UniformRand();
-	  stet1 = std::sqrt(1. - ctet1*ctet1);
-	  phi2= twopi * G4UniformRand();
-	  ctet2 = 1. - 2.*G4UniformRand();
-	  stet2=std::sqrt(1. - ctet2*ctet2);
-	  const double ctet = ctet1*ctet2 + stet1*stet2*std::cos(phi1-phi2);
-	  if((romaxt*G4UniformRand()) < (a + b*ctet + c*ctet*ctet)) break;
-	  numThrow++;
-	  if (numThrow%10000 == 0) {
-	     std::cerr << " Angular distribution Von Neumann accp/rej numThrow " << numThrow << std::endl;
-	     std::cerr << " e1_ " << e1_ << " e2 " << e2 << " a " << a
-                       << " b  " << b << " c " << c  << std::endl;
-	  }
-	  if (numThrow > 1000000) {
-	    outPart.clear();
-	    return;
-	  }
-      }
+//  the first direction is isotropic, and the angle between the two particles follows
+//  a + b*cos + c*cos^2, with the second direction uniform in azimuth around the first one
+      const double phi1 = twopi * G4UniformRand();
+      const double ctet1 = 1. - 2.* G4UniformRand();
+      const double stet1 = std::sqrt(1. - ctet1*ctet1);
+      const double ctet = this->sampleCosCorrelation(a, b, c);
+      const double stet = std::sqrt(std::max(0., 1. - ctet*ctet));
+      const double phi = twopi * G4UniformRand();
+      const double u1[3] = {stet1*std::cos(phi1), stet1*std::sin(phi1), ctet1};
+      const double uTheta[3] = {ctet1*std::cos(phi1), ctet1*std::sin(phi1), -stet1};
+      const double uPhi[3] = {-std::sin(phi1), std::cos(phi1), 0.};
+      double u2[3];
+      for (int i=0; i != 3; i++)
+        u2[i] = ctet*u1[i] + stet*(std::cos(phi)*uTheta[i] + std::sin(phi)*uPhi[i]);
       decay0Part aP;
       if(bbNucl_.Zdbb_ > 0.) aP.pdgCode_ = 11;
       else aP.pdgCode_ = -11;
-      aP.pmom_[0] = p1*stet1*std::cos(phi1);
-      aP.pmom_[1] = p1*stet1*std::sin(phi1);
-      aP.pmom_[2] = p1*ctet1;
+      aP.pmom_[0] = p1*u1[0];
+      aP.pmom_[1] = p1*u1[1];
+      aP.pmom_[2] = p1*u1[2];
       aP.time_ = 0.;
       aP.energy_ = e1_;
       outPart.push_back(aP); // same particle id as above..
-      aP.pmom_[0] = p2*stet2*std::cos(phi2);
-      aP.pmom_[1] = p2*stet2*std::sin(phi2);
-      aP.pmom_[2] = p2*ctet2;
+      aP.pmom_[0] = p2*u2[0];
+      aP.pmom_[1] = p2*u2[1];
+      aP.pmom_[2] = p2*u2[2];
       aP.energy_ = e2;
       outPart.push_back(aP); // same particle id as above..
     //
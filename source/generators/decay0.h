@@ -54,7 +54,8 @@ class decay0 {
 
      decay0();
      decay0(const std::string nuclide, int finalStateNumber, int decayModeNumber,
-                 double eRangeLow=0.0, double eRangeHigh=4.3); // no limits, be default. (for 2nbbdecay. )
+                 double eRangeLow=0.0, double eRangeHigh=4.3, // no limits, be default. (for 2nbbdecay. )
+                 const std::string cacheFile=""); // file caching the tabulated spectra, none by default
      ~decay0();
     void decay0DoIt(std::vector<decay0Part> &outPart) const ;
     void fillInfo(); // to be used if the Nuclide, final state or decay mode is changed...Not advised..
@@ -91,9 +92,30 @@ class decay0 {
     mutable double ebb1_;
     mutable double ebb2_;
     mutable std::vector<double> spthe2_;
+    //
+    // Tabulated distributions, filled in initSpectrum, used to sample the energies by
+    // inversion of their cumulative distributions instead of acceptance/rejection.
+    //
+    static const size_t nBins12_ = 400; // bins of every row of spthe12_, scaled to the e2 range
+    double e1Low_; // lower end of the sampled e1 range
+    std::vector<double> cdf1_; // cumulative of spthe1_ over the e1 range
+    size_t nRows12_; // rows of spthe12_, at e1 = 0, 1, 2, ... keV
+    std::vector<float> spthe12_; // spectrum of the second e-/e+ on every row, for modes with a random e2
+    std::vector<double> cdf12_; // cumulative of every row of spthe12_
+    std::string cacheFile_; // binary file where spthe1_ and spthe12_ are cached
 
     void initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
     void decay0DoItbb(std::vector<decay0Part> &outPart) const; // Main method, generate the two electrons.
+
+    bool hasRandomE2() const; // whether something else is emitted, and e2 is random
+    double fe2(double e2, void *p) const; // spectrum of the second e-/e+ for the current mode
+    void fillSpectrum12(); // fill spthe12_
+    void buildCdfs(); // cumulative distributions of spthe1_ and spthe12_
+    bool readSpectrumCache(); // read spthe1_ and spthe12_ from cacheFile_, if it matches the decay
+    void writeSpectrumCache() const;
+    double sampleE1() const;
+    double sampleE2(const double e1) const;
+    double sampleCosCorrelation(const double a, const double b, const double c) const; // density a + b*x + c*x*x
     void Ba136low(std::vector<decay0Part> &outPart) const;  // Baryum 136 de-excitation.
 //    void Xe130low(std::vector<decay0Part> &outPart) const;  // Xenon de-excitation. // we (NEXT) don't care...
 
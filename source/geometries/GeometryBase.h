@@ -10,8 +10,13 @@
 #define GEOMETRY_BASE_H
 
 #include <G4ThreeVector.hh>
+#include <globals.hh>
 #include <CLHEP/Units/SystemOfUnits.h>
 
+#include <functional>
+#include <map>
+#include <vector>
+
 class G4LogicalVolume;
 
 namespace nexus {
@@ -23,6 +28,9 @@ namespace nexus {
   class GeometryBase
   {
   public:
+    /// Sampler of vertices within a region of the geometry
+    typedef std::function<G4ThreeVector()> VertexSampler;
+
     /// The volumes (solid, logical and physical) must be defined
     /// in this method, which will be invoked during the detector
     /// construction phase
@@ -34,6 +42,15 @@ namespace nexus {
     /// Returns a point within a given region of the geometry
     virtual G4ThreeVector GenerateVertex(const G4String&) const;
 
+    /// Returns the vertex sampler of a region, so that the region name
+    /// is resolved once at configuration time. Geometries that register
+    /// their regions raise an error here if the region is unknown;
+    /// for the others the sampler calls GenerateVertex with the region.
+    VertexSampler GetVertexSampler(const G4String& region) const;
+
+    /// Returns the names of the regions registered by the geometry
+    std::vector<G4String> GetVertexRegions() const;
+
     /// Returns the span (maximum dimension) of the geometry
     G4double GetSpan();
 
@@ -72,6 +89,9 @@ namespace nexus {
     /// Sets the 3 dimensions of the geometry (x, y, z)
     void SetDimensions(G4ThreeVector dim);
 
+    /// Registers the vertex sampler of a region of the geometry
+    void RegisterVertexRegion(const G4String& region, VertexSampler sampler);
+
   private:
     /// Copy-constructor (hidden)
     GeometryBase(const GeometryBase&);
@@ -84,6 +104,7 @@ namespace nexus {
     G4ThreeVector dimensions_; ///< XYZ dimensions of a regular geometry
     G4bool drift_; ///< True if geometry contains a drift field (for hit coordinates)
     G4double el_z_; ///< Starting point of EL generation in z
+    std::map<G4String, VertexSampler> vertex_regions_; ///< Registered regions
   };
 
 
@@ -102,6 +123,34 @@ namespace nexus {
   inline G4ThreeVector GeometryBase::GenerateVertex(const G4String&) const
   { return G4ThreeVector(0., 0., 0.); }
 
+  inline GeometryBase::VertexSampler
+  GeometryBase::GetVertexSampler(const G4String& region) const
+  {
+    if (vertex_regions_.empty())
+      return [this, region]() { return GenerateVertex(region); };
+
+    auto it = vertex_regions_.find(region);
+    if (it == vertex_regions_.end()) {
+      G4String msg = "Unknown vertex generation region " + region +
+        ". Valid regions are:";
+      for (const auto& entry : vertex_regions_) msg += " " + entry.first;
+      G4Exception("[GeometryBase]", "GetVertexSampler()",
+                  FatalErrorInArgument, msg.c_str());
+    }
+    return it->second;
+  }
+
+  inline std::vector<G4String> GeometryBase::GetVertexRegions() const
+  {
+    std::vector<G4String> regions;
+    for (const auto& entry : vertex_regions_) regions.push_back(entry.first);
+    return regions;
+  }
+
+  inline void GeometryBase::RegisterVertexRegion(const G4String& region,
+                                                 VertexSampler sampler)
+  { vertex_regions_[region] = sampler; }
+
   inline void GeometryBase::SetSpan(G4double s) { span_ = s; }
 
   inline G4double GeometryBase::GetSpan() { return span_; }
@@ -79,6 +79,7 @@ namespace nexus {
   // Inner Elements
   inner_elements_ = new Next100InnerElements();
 
+  RegisterVertexRegions();
   }
 
 
@@ -181,82 +182,55 @@ namespace nexus {
 
   G4ThreeVector Next100::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
+    return GetVertexSampler(region)();
+  }
+
+
+  void Next100::RegisterVertexRegions()
+  {
+    // The vertices of the components are displaced
+    // to the position of the gate in the vessel
+    auto register_component = [this](const G4String& region,
+                                      const GeometryBase* component) {
+      VertexSampler sampler = component->GetVertexSampler(region);
+      RegisterVertexRegion(region, [this, sampler]() {
+          return sampler() + G4ThreeVector(0., 0., -gate_zpos_in_vessel_); });
+    };
 
     // Air around shielding
-    if (region == "LAB") {
-      vertex = lab_gen_->GenerateVertex("INSIDE");
-    }
+    RegisterVertexRegion("LAB", [this]() {
+        return lab_gen_->GenerateVertex("INSIDE") +
+          G4ThreeVector(0., 0., -gate_zpos_in_vessel_); });
 
     // Shielding regions
-    else if ((region == "SHIELDING_LEAD")  ||
-             (region == "SHIELDING_STEEL") ||
-             (region == "INNER_AIR") ||
-             (region == "EXTERNAL") ||
-             (region == "SHIELDING_STRUCT") ||
-             (region == "PEDESTAL") ||
-             (region == "BUBBLE_SEAL") ||
-             (region == "EDPM_SEAL")) {
-      vertex = shielding_->GenerateVertex(region);
-    }
+    for (const G4String region : {"SHIELDING_LEAD", "SHIELDING_STEEL", "INNER_AIR",
+                                  "EXTERNAL", "SHIELDING_STRUCT", "PEDESTAL",
+                                  "BUBBLE_SEAL", "EDPM_SEAL"})
+      register_component(region, shielding_);
 
     // Vessel regions
-    else if ((region == "VESSEL")  ||
-             (region == "PORT_1a") ||
-             (region == "PORT_2a") ||
-             (region == "PORT_1b") ||
-             (region == "PORT_2b")) {
-      vertex = vessel_->GenerateVertex(region);
-    }
+    for (const G4String region : {"VESSEL", "PORT_1a", "PORT_2a", "PORT_1b", "PORT_2b"})
+      register_component(region, vessel_);
 
     // Inner copper shielding
-    else if (region == "ICS"){
-      vertex = ics_->GenerateVertex(region);
-    }
+    register_component("ICS", ics_);
 
-    // Inner elements (photosensors' planes and field cage)
-    else if ((region == "CENTER") ||
-             (region == "ACTIVE") ||
-             (region == "BUFFER") ||
-             (region == "XENON") ||
-             (region == "LIGHT_TUBE") ||
-             (region == "EL_GAP") ||
-             (region == "EP_COPPER_PLATE") ||
-             (region == "SAPPHIRE_WINDOW") ||
-             (region == "OPTICAL_PAD") ||
-             (region == "PMT_BODY") ||
-             (region == "PMT") ||
-             (region == "PMT_BASE") ||
-             (region == "TP_COPPER_PLATE") ||
-             (region == "DICE_BOARD") ||
-             (region == "EL_TABLE") ||
-             (region == "FIELD_RING")) {
-      vertex = inner_elements_->GenerateVertex(region);
-    }
+    // Inner elements
+    for (const G4String& region : inner_elements_->GetVertexRegions())
+      register_component(region, inner_elements_);
 
-    else if (region == "AD_HOC") {
-      // AD_HOC does not need to be shifted because it is passed by the user
-      vertex = specific_vertex_;
-      return vertex;
-    }
+    // AD_HOC does not need to be shifted because it is passed by the user
+    RegisterVertexRegion("AD_HOC", [this]() { return specific_vertex_; });
 
     // Lab walls
-    else if ((region == "HALLA_INNER") || (region == "HALLA_OUTER")){
-      if (!lab_walls_)
-	G4Exception("[Next100]", "GenerateVertex()", FatalException,
-                    "This vertex generation region must be used with lab_walls == true!");
-      vertex = hallA_walls_->GenerateVertex(region);
+    for (const G4String region : {"HALLA_INNER", "HALLA_OUTER"}) {
+      VertexSampler sampler = hallA_walls_->GetVertexSampler(region);
+      RegisterVertexRegion(region, [this, sampler]() {
+          if (!lab_walls_)
+            G4Exception("[Next100]", "GenerateVertex()", FatalException,
+                        "This vertex generation region must be used with lab_walls == true!");
+          return sampler() + G4ThreeVector(0., 0., -gate_zpos_in_vessel_); });
     }
-
-    else {
-      G4Exception("[Next100]", "GenerateVertex()", FatalException,
-		  "Unknown vertex generation region!");
-    }
-
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -gate_zpos_in_vessel_);
-    vertex = vertex + displacement;
-
-    return vertex;
   }
 
 } //end namespace nexus
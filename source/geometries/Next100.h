@@ -42,6 +42,7 @@ namespace nexus {
   private:
     void BuildLab();
     void Construct();
+    void RegisterVertexRegions();
 
 
   private:
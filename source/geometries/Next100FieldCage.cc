@@ -12,8 +12,11 @@
 #include "IonizationSD.h"
 #include "OpticalMaterialProperties.h"
 #include "UniformElectricDriftField.h"
+#include "MapDriftField.h"
+#include "DriftFieldMap.h"
 #include "XenonProperties.h"
 #include "CylinderPointSampler2020.h"
+#include "VoxelizedVolumeSampler.h"
 
 #include <G4Navigator.hh>
 #include <G4SystemOfUnits.hh>
@@ -38,6 +41,8 @@
 #include <G4UnitsTable.hh>
 #include <G4TransportationManager.hh>
 
+#include <algorithm>
+
 using namespace nexus;
 
 
@@ -74,6 +79,8 @@ Next100FieldCage::Next100FieldCage():
   // Diffusion constants
   drift_transv_diff_ (1. * mm/sqrt(cm)),
   drift_long_diff_ (.3 * mm/sqrt(cm)),
+  drift_field_map_ (""),
+  drift_map_segment_ (1. * cm),
   ELtransv_diff_ (0. * mm/sqrt(cm)),
   ELlong_diff_ (0. * mm/sqrt(cm)),
   // EL electric field
@@ -87,7 +94,8 @@ Next100FieldCage::Next100FieldCage():
   // EL gap generation disk parameters
   el_gap_gen_disk_diam_(0.),
   el_gap_gen_disk_x_(0.), el_gap_gen_disk_y_(0.),
-  el_gap_gen_disk_zmin_(0.), el_gap_gen_disk_zmax_(1.)
+  el_gap_gen_disk_zmin_(0.), el_gap_gen_disk_zmax_(1.),
+  vertex_voxel_size_(0.)
 {
   /// Define new categories
   new G4UnitDefinition("kilovolt/cm","kV/cm","Electric field", kilovolt/cm);
@@ -115,6 +123,16 @@ Next100FieldCage::Next100FieldCage():
   drift_long_diff_cmd.SetParameterName("drift_long_diff", true);
   drift_long_diff_cmd.SetUnitCategory("Diffusion");
 
+  msg_->DeclareProperty("drift_field_map", drift_field_map_,
+                        "Map of the drift parameters in the drift region (uniform field if none).");
+
+  G4GenericMessenger::Command& drift_map_segment_cmd =
+    msg_->DeclareProperty("drift_map_segment", drift_map_segment_,
+                          "Length of the segments of the drift with a field map.");
+  drift_map_segment_cmd.SetParameterName("drift_map_segment", false);
+  drift_map_segment_cmd.SetUnitCategory("Length");
+  drift_map_segment_cmd.SetRange("drift_map_segment>0.");
+
   G4GenericMessenger::Command&  ELtransv_diff_cmd =
   msg_->DeclareProperty("ELtransv_diff", ELtransv_diff_,
                         "Tranvsersal diffusion in the EL region");
@@ -172,6 +190,15 @@ Next100FieldCage::Next100FieldCage():
                           "Maximum Z range of the EL gap vertex generation disk.");
   el_gap_gen_disk_zmax_cmd.SetParameterName("el_gap_gen_disk_zmax", false);
   el_gap_gen_disk_zmax_cmd.SetRange("el_gap_gen_disk_zmax>=0.0 && el_gap_gen_disk_zmax<=1.0");
+
+  G4GenericMessenger::Command& vertex_voxel_size_cmd =
+    msg_->DeclareProperty("vertex_voxel_size", vertex_voxel_size_,
+                          "Size of the voxels of the vertex generation maps (0 = no maps).");
+  vertex_voxel_size_cmd.SetUnitCategory("Length");
+  vertex_voxel_size_cmd.SetParameterName("vertex_voxel_size", false);
+  vertex_voxel_size_cmd.SetRange("vertex_voxel_size>=0.");
+
+  RegisterVertexRegions();
 }
 
 
@@ -311,14 +338,28 @@ void Next100FieldCage::BuildActive()
   active_logic->SetSensitiveDetector(ionisd);
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
-  /// Define a drift field for this volume
-  UniformElectricDriftField* field = new UniformElectricDriftField();
+  /// Define a drift field for this volume: uniform, or
+  /// described by a map of the drift parameters if given
   G4double global_active_zpos = active_zpos_ - GetELzCoord();
-  field->SetCathodePosition(global_active_zpos + active_length_/2.);
-  field->SetAnodePosition(global_active_zpos - active_length_/2.);
-  field->SetDriftVelocity(1. * mm/microsecond);
-  field->SetTransverseDiffusion(drift_transv_diff_);
-  field->SetLongitudinalDiffusion(drift_long_diff_);
+  BaseDriftField* field = 0;
+  if (drift_field_map_ != "") {
+    DriftFieldMap* map = new DriftFieldMap(drift_field_map_);
+    map->Print();
+    MapDriftField* map_field =
+      new MapDriftField(map, global_active_zpos - active_length_/2.,
+                        global_active_zpos + active_length_/2.);
+    map_field->SetSegmentLength(drift_map_segment_);
+    field = map_field;
+  }
+  else {
+    UniformElectricDriftField* uniform_field = new UniformElectricDriftField();
+    uniform_field->SetCathodePosition(global_active_zpos + active_length_/2.);
+    uniform_field->SetAnodePosition(global_active_zpos - active_length_/2.);
+    uniform_field->SetDriftVelocity(1. * mm/microsecond);
+    uniform_field->SetTransverseDiffusion(drift_transv_diff_);
+    uniform_field->SetLongitudinalDiffusion(drift_long_diff_);
+    field = uniform_field;
+  }
   G4Region* drift_region = new G4Region("DRIFT");
   drift_region->SetUserInformation(field);
   drift_region->AddRootLogicalVolume(active_logic);
@@ -909,92 +950,71 @@ Next100FieldCage::~Next100FieldCage()
   delete xenon_gen_;
   delete teflon_gen_;
   delete el_gap_gen_;
+
+  for (auto& sampler : voxel_samplers_) delete sampler.second;
 }
 
 
 G4ThreeVector Next100FieldCage::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vertex(0., 0., 0.);
-
-  if (region == "CENTER") {
-    vertex = G4ThreeVector(0., 0., active_zpos_);
-  }
-
-  else if (region == "ACTIVE") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = active_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "BUFFER") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = buffer_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
+  return GetVertexSampler(region)();
+}
 
-  else if (region == "XENON") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = xenon_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (
-    VertexVolume->GetName() != "ACTIVE" &&
-    VertexVolume->GetName() != "BUFFER" &&
-    VertexVolume->GetName() != "EL_GAP");
-  }
 
-  else if (region == "LIGHT_TUBE") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = teflon_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (
-    VertexVolume->GetName() != "LIGHT_TUBE_DRIFT" &&
-    VertexVolume->GetName() != "LIGHT_TUBE_BUFFER" );
-  }
+void Next100FieldCage::RegisterVertexRegions()
+{
+  RegisterVertexRegion("CENTER", [this]() {
+      return G4ThreeVector(0., 0., active_zpos_); });
+
+  // Regions made of whole volumes. The vertex generators are built with
+  // the geometry, so the samplers read them when called. The slots of
+  // the voxel maps are created here, so that they aren't looked up
+  // at every vertex.
+  auto register_volumes =
+    [this](const G4String& region, CylinderPointSampler2020* const* gen,
+           const std::vector<G4String>& volumes, G4bool voxelize) {
+      VoxelizedVolumeSampler** voxels =
+        voxelize ? &voxel_samplers_[region] : nullptr;
+      RegisterVertexRegion(region, [this, gen, volumes, voxels]() {
+          return GenerateVertexInVolumes(*gen, volumes, voxels); });
+    };
+
+  register_volumes("ACTIVE",     &active_gen_, {"ACTIVE"}, true);
+  register_volumes("BUFFER",     &buffer_gen_, {"BUFFER"}, true);
+  register_volumes("XENON",      &xenon_gen_,  {"ACTIVE", "BUFFER", "EL_GAP"}, true);
+  register_volumes("LIGHT_TUBE", &teflon_gen_,
+                   {"LIGHT_TUBE_DRIFT", "LIGHT_TUBE_BUFFER"}, true);
+  register_volumes("FIELD_RING", &ring_gen_,   {"FIELD_RING"}, true);
+
+  // The EL gap region is a configurable disk rather than a whole
+  // volume, so it never uses a voxel map
+  register_volumes("EL_GAP",     &el_gap_gen_, {"EL_GAP"}, false);
+}
 
-  else if (region == "EL_GAP") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = el_gap_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
 
-  else if (region == "FIELD_RING") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = ring_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
+G4ThreeVector
+Next100FieldCage::GenerateVertexInVolumes(CylinderPointSampler2020* gen,
+                                          const std::vector<G4String>& volumes,
+                                          VoxelizedVolumeSampler** voxels) const
+{
+  // Sample the voxel map of the volumes if requested
+  if (voxels && vertex_voxel_size_ > 0.) {
+    if (!*voxels)
+      *voxels = new VoxelizedVolumeSampler(volumes, vertex_voxel_size_,
+                                           geom_navigator_);
+    return (*voxels)->Shoot() + G4ThreeVector(0., 0., GetELzCoord());
   }
 
-  else {
-    G4Exception("[Next100FieldCage]", "GenerateVertex()", FatalException,
-    "Unknown vertex generation region!");
-  }
+  G4ThreeVector vertex;
+  G4VPhysicalVolume *VertexVolume;
+  do {
+    vertex = gen->GenerateVertex("VOLUME");
+    G4ThreeVector glob_vtx(vertex);
+    glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
+    VertexVolume =
+      geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+  } while (std::find(volumes.begin(), volumes.end(), VertexVolume->GetName()) ==
+           volumes.end());
 
   return vertex;
 }
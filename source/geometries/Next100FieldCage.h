@@ -11,6 +11,7 @@
 
 #include "GeometryBase.h"
 #include <vector>
+#include <map>
 
 class G4Material;
 class G4LogicalVolume;
@@ -21,6 +22,7 @@ class G4Navigator;
 namespace nexus {
 
   class CylinderPointSampler2020;
+  class VoxelizedVolumeSampler;
 
 
   class Next100FieldCage: public GeometryBase
@@ -45,6 +47,10 @@ namespace nexus {
     void BuildELRegion();
     void BuildLightTube();
     void BuildFieldCage();
+    void RegisterVertexRegions();
+    G4ThreeVector GenerateVertexInVolumes(CylinderPointSampler2020*,
+                                          const std::vector<G4String>& volumes,
+                                          VoxelizedVolumeSampler**) const;
 
     // Dimensions
     G4double gate_sapphire_wdw_dist_;
@@ -63,6 +69,8 @@ namespace nexus {
     const G4double overlap_;
     // Diffusion constants
     G4double drift_transv_diff_, drift_long_diff_;
+    G4String drift_field_map_;    ///< map of the drift parameters (none = uniform)
+    G4double drift_map_segment_;  ///< length of the drift segments with a map
     G4double ELtransv_diff_; ///< transversal diffusion in the EL gap
     G4double ELlong_diff_; ///< longitudinal diffusion in the EL gap
     // Electric field
@@ -123,6 +131,10 @@ namespace nexus {
     G4double el_gap_gen_disk_diam_;
     G4double el_gap_gen_disk_x_, el_gap_gen_disk_y_;
     G4double el_gap_gen_disk_zmin_, el_gap_gen_disk_zmax_;
+
+    // Voxel maps for vertex generation, built at first use
+    G4double vertex_voxel_size_;
+    std::map<G4String, VoxelizedVolumeSampler*> voxel_samplers_;
   };
 
 
@@ -38,6 +38,17 @@ namespace nexus {
     // Messenger
     msg_ = new G4GenericMessenger(this, "/Geometry/Next100/",
                                   "Control commands of geometry Next100.");
+
+    // Vertex generation regions of the components
+    for (const G4String& region : field_cage_->GetVertexRegions())
+      RegisterVertexRegion(region, field_cage_->GetVertexSampler(region));
+
+    for (const G4String region : {"EP_COPPER_PLATE", "SAPPHIRE_WINDOW", "OPTICAL_PAD",
+                                  "PMT", "PMT_BODY", "PMT_BASE"})
+      RegisterVertexRegion(region, energy_plane_->GetVertexSampler(region));
+
+    for (const G4String region : {"TP_COPPER_PLATE", "SIPM_BOARD"})
+      RegisterVertexRegion(region, tracking_plane_->GetVertexSampler(region));
   }
 
 
@@ -93,38 +104,7 @@ namespace nexus {
 
   G4ThreeVector Next100InnerElements::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
-
-    // Field Cage regions
-    if ((region == "CENTER") ||
-        (region == "ACTIVE") ||
-        (region == "BUFFER") ||
-        (region == "XENON")  ||
-        (region == "EL_GAP") ||
-        (region == "LIGHT_TUBE") ||
-        (region == "FIELD_RING")) {
-      vertex = field_cage_->GenerateVertex(region);
-    }
-    // Energy Plane regions
-    else if ((region == "EP_COPPER_PLATE") ||
-             (region == "SAPPHIRE_WINDOW") ||
-             (region == "OPTICAL_PAD") ||
-             (region == "PMT") ||
-             (region == "PMT_BODY") ||
-             (region == "PMT_BASE")) {
-      vertex = energy_plane_->GenerateVertex(region);
-    }
-    // Tracking Plane regions
-    else if ((region == "TP_COPPER_PLATE") ||
-             (region == "SIPM_BOARD")) {
-      vertex = tracking_plane_->GenerateVertex(region);
-    }
-    else {
-      G4Exception("[Next100InnerElements]", "GenerateVertex()", FatalException,
-        "Unknown vertex generation region!");
-    }
-
-    return vertex;
+    return GetVertexSampler(region)();
   }
 
 } // end namespace nexus
@@ -75,6 +75,8 @@ namespace nexus {
 
 
     inner_elements_ = new Next100InnerElements();
+
+    RegisterVertexRegions();
   }
 
 
@@ -158,19 +160,22 @@ namespace nexus {
 
   G4ThreeVector Next100OpticalGeometry::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
-    if (region == "AD_HOC") {
-      // AD_HOC does not need to be shifted because it is passed by the user
-      vertex = specific_vertex_;
-      return vertex;
-    }
-    else {
-      vertex = inner_elements_->GenerateVertex(region);
+    return GetVertexSampler(region)();
+  }
+
+
+  void Next100OpticalGeometry::RegisterVertexRegions()
+  {
+    // The vertices of the inner elements are displaced
+    // to the position of the gate in the gas
+    for (const G4String& region : inner_elements_->GetVertexRegions()) {
+      VertexSampler sampler = inner_elements_->GetVertexSampler(region);
+      RegisterVertexRegion(region, [this, sampler]() {
+          return sampler() + G4ThreeVector(0., 0., -gate_zpos_in_gas_); });
     }
 
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -gate_zpos_in_gas_);
-    vertex = vertex + displacement;
-    return vertex;
+    // AD_HOC does not need to be shifted because it is passed by the user
+    RegisterVertexRegion("AD_HOC", [this]() { return specific_vertex_; });
   }
 
 
@@ -38,7 +38,9 @@ namespace nexus {
 
 
   private:
+    void RegisterVertexRegions();
 
+  private:
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
 
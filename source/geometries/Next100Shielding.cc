@@ -10,6 +10,7 @@
 #include "MaterialsList.h"
 #include "Visibilities.h"
 #include "BoxPointSampler.h"
+#include "CompositeVolumeSampler.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4SubtractionSolid.hh>
@@ -411,19 +412,58 @@ namespace nexus {
                           lead_thickness_, 0.,
                           G4ThreeVector(-front_x_separation_/2., -lead_thickness_/2., front_beam_z), 0);
 
+    // The parts of the vertex generators are placed at every copy of
+    // the beams and weighted by their volumes
+    auto add_part = [](CompositeVolumeSampler* gen, BoxPointSampler* part,
+                       G4ThreeVector offset, G4double weight) {
+      gen->AddPart([part, offset]() {
+          return part->GenerateVertex("INSIDE") + offset; }, weight);
+    };
+
     // Compute relative volumes
     G4double roof_vol       = roof_beam_solid->GetCubicVolume();
     G4double struct_top_vol = struct_solid   ->GetCubicVolume();
     G4double lateral_vol    = lat_beam_solid ->GetCubicVolume();
     G4double total_vol      = roof_vol + struct_top_vol + (8*lateral_vol);
 
-    perc_roof_vol_       = roof_vol/total_vol;
-    perc_front_roof_vol_ = 2*(lead_x_*beam_thickness_2*lead_thickness_)/roof_vol;
-    perc_top_struct_vol_ = struct_top_vol /total_vol;
-
+    G4double front_roof_vol   = lead_x_*beam_thickness_2*lead_thickness_;
     G4double struc_beam_x_vol = (shield_x_ + 2.*lead_thickness_
                                 + 2.*steel_thickness_)*lead_thickness_*beam_thickness_1;
-    perc_struc_x_vol_    = 4*struc_beam_x_vol/struct_top_vol;
+    G4double lat_prob = beam_thickness_1/(beam_thickness_1+beam_thickness_2);
+
+    G4double front_roof_z = shield_z_/2. + steel_thickness_ + lead_thickness_/2.;
+    G4double lat_roof_x   = shield_x_/2. + steel_thickness_ + lead_thickness_/2.;
+    G4double lat_beam_dx  = shield_x_ + 2*steel_thickness_ + lead_thickness_;
+    G4double front_beam_dz = shield_z_ + 2*steel_thickness_ + lead_thickness_;
+
+    struct_gen_ = new CompositeVolumeSampler();
+
+    // Roof beams
+    for (G4double sign : {1., -1.}) {
+      add_part(struct_gen_, front_roof_gen_, G4ThreeVector(0., 0., sign * front_roof_z),
+               front_roof_vol);
+      add_part(struct_gen_, lat_roof_gen_, G4ThreeVector(sign * lat_roof_x, 0., 0.),
+               (roof_vol - 2*front_roof_vol)/2.);
+    }
+
+    // Top structure
+    for (G4double dz : {0., -roof_z_separation_, -(roof_z_separation_+lateral_z_separation_),
+                        -(2*roof_z_separation_+lateral_z_separation_)})
+      add_part(struct_gen_, struct_x_gen_, G4ThreeVector(0., 0., dz), struc_beam_x_vol);
+
+    for (G4double dx : {0., front_x_separation_})
+      add_part(struct_gen_, struct_z_gen_, G4ThreeVector(dx, 0., 0.),
+               (struct_top_vol - 4*struc_beam_x_vol)/2.);
+
+    // Lateral and front beams
+    for (G4int i=0; i<4; ++i) {
+      add_part(struct_gen_, lat_beam_gen_,
+               G4ThreeVector(-(i/2) * lat_beam_dx, 0., -(i%2) * lateral_z_separation_),
+               2*lateral_vol * lat_prob);
+      add_part(struct_gen_, front_beam_gen_,
+               G4ThreeVector((i%2) * front_x_separation_, 0., -(i/2) * front_beam_dz),
+               2*lateral_vol * (1. - lat_prob));
+    }
 
 
     // PEDESTAL GENERATORS
@@ -467,11 +507,28 @@ namespace nexus {
     G4double ped_total_vol = ped_roof_vol + 2*(ped_support_bottom_vol + ped_support_top_vol
                            + ped_front_vol + ped_lateral_vol);
 
-    perc_ped_bottom_vol_ = 2*ped_support_bottom_vol/ped_total_vol;
-    perc_ped_top_vol_    = 2*ped_support_top_vol   /ped_total_vol;
-    perc_ped_front_vol_  = 2*ped_front_vol         /ped_total_vol;
-    perc_ped_lateral_vol_= 2*ped_lateral_vol       /ped_total_vol;
-    perc_ped_roof_vol_   = ped_roof_vol            /ped_total_vol;
+    pedestal_gen_ = new CompositeVolumeSampler();
+
+    for (G4int i=0; i<2; ++i) {
+      add_part(pedestal_gen_, ped_support_bottom_gen_,
+               G4ThreeVector(0., 0., -i * support_beam_dist_), ped_support_bottom_vol);
+      add_part(pedestal_gen_, ped_support_top_gen_,
+               G4ThreeVector(0., 0., -i * support_beam_dist_), ped_support_top_vol);
+      add_part(pedestal_gen_, ped_front_gen_,
+               G4ThreeVector(0., 0., -i * (2.*support_front_dist_ + support_beam_dist_)),
+               ped_front_vol);
+      add_part(pedestal_gen_, ped_lateral_gen_,
+               G4ThreeVector(-i * (pedestal_x_ + pedestal_lateral_beam_thickness_), 0., 0.),
+               ped_lateral_vol);
+
+      // The roof is split evenly between its lateral and front sides
+      add_part(pedestal_gen_, ped_roof_lat_gen_,
+               G4ThreeVector(-i * (pedestal_top_x_ + pedestal_roof_thickness_), 0., 0.),
+               ped_roof_vol/4.);
+      add_part(pedestal_gen_, ped_roof_front_gen_,
+               G4ThreeVector(0., 0., -i * (pedestal_lateral_length_ - pedestal_roof_thickness_)),
+               ped_roof_vol/4.);
+    }
 
 
     // BUBBLE SEAL
@@ -489,8 +546,18 @@ namespace nexus {
     G4double bubble_lateral_vol = 2*(bubble_seal_thickness_)
                                    *(bubble_seal_thickness_)*(pedestal_lateral_length_);
 
-    perc_bubble_front_vol_  = bubble_front_vol  /(bubble_front_vol + bubble_lateral_vol);
-    perc_buble_lateral_vol_ = bubble_lateral_vol/(bubble_front_vol + bubble_lateral_vol);
+    G4double bubble_front_z = support_beam_dist_/2. + support_front_dist_
+                            + pedestal_front_beam_thickness_/2. + bubble_seal_thickness_/2.;
+    G4double bubble_lateral_x = pedestal_x_/2. + pedestal_lateral_beam_thickness_
+                              + bubble_seal_thickness_/2.;
+
+    bubble_seal_gen_ = new CompositeVolumeSampler();
+    for (G4double sign : {1., -1.}) {
+      add_part(bubble_seal_gen_, bubble_seal_front_gen_,
+               G4ThreeVector(0., 0., sign * bubble_front_z), bubble_front_vol/2.);
+      add_part(bubble_seal_gen_, bubble_seal_lateral_gen_,
+               G4ThreeVector(sign * bubble_lateral_x, 0., 0.), bubble_lateral_vol/2.);
+    }
 
     // EDPM SEAL
     edpm_seal_front_gen_ =
@@ -504,8 +571,13 @@ namespace nexus {
     G4double edpm_front_vol   = 2*edpm_seal_thickness_ * shield_y_ * edpm_seal_thickness_;
     G4double edpm_lateral_vol =   edpm_seal_thickness_ * edpm_seal_thickness_ * shield_z_;
 
-    perc_edpm_front_vol_   = edpm_front_vol  /(edpm_front_vol + edpm_lateral_vol);
-    perc_edpm_lateral_vol_ = edpm_lateral_vol/(edpm_front_vol + edpm_lateral_vol);
+    edpm_seal_gen_ = new CompositeVolumeSampler();
+    for (G4double sign : {1., -1.})
+      add_part(edpm_seal_gen_, edpm_seal_front_gen_,
+               G4ThreeVector(0., 0., sign * (shield_z_/2. - edpm_seal_thickness_/2.)),
+               edpm_front_vol/2.);
+    add_part(edpm_seal_gen_, edpm_seal_lateral_gen_,
+             G4ThreeVector(0., shield_y_/2. - edpm_seal_thickness_/2., 0.), edpm_lateral_vol);
 
 
     if (verbosity_){
@@ -524,11 +596,11 @@ namespace nexus {
       std::cout<<"LEAD VOLUME        (m3) "<< lead_vol /1.e9 <<std::endl;
 
       std::cout << "PEDESTAL GENERATOR PERCENTS" << std::endl;
-      std::cout << "BOTTOM " << perc_ped_bottom_vol_ * 100 << std::endl;
-      std::cout << "TOP "    << perc_ped_top_vol_    * 100 << std::endl;
-      std::cout << "FRONT "  << perc_ped_front_vol_  * 100 << std::endl;
-      std::cout << "LATERAL "<< perc_ped_lateral_vol_* 100 << std::endl;
-      std::cout << "ROOF "   << perc_ped_roof_vol_   * 100 << std::endl;
+      std::cout << "BOTTOM " << 2*ped_support_bottom_vol/ped_total_vol * 100 << std::endl;
+      std::cout << "TOP "    << 2*ped_support_top_vol   /ped_total_vol * 100 << std::endl;
+      std::cout << "FRONT "  << 2*ped_front_vol         /ped_total_vol * 100 << std::endl;
+      std::cout << "LATERAL "<< 2*ped_lateral_vol       /ped_total_vol * 100 << std::endl;
+      std::cout << "ROOF "   << ped_roof_vol            /ped_total_vol * 100 << std::endl;
     }
   }
 
@@ -556,6 +628,10 @@ namespace nexus {
     delete bubble_seal_lateral_gen_;
     delete edpm_seal_front_gen_;
     delete edpm_seal_lateral_gen_;
+    delete struct_gen_;
+    delete pedestal_gen_;
+    delete bubble_seal_gen_;
+    delete edpm_seal_gen_;
   }
 
   G4LogicalVolume* Next100Shielding::GetAirLogicalVolume() const
@@ -611,173 +687,22 @@ namespace nexus {
       vertex = external_gen_->GenerateVertex("WHOLE_VOL");
     }
 
-    else if(region=="SHIELDING_STRUCT"){
-        G4double rand = G4UniformRand();
-
-        if (rand < perc_roof_vol_) { //ROOF BEAM STRUCTURE
-        	if (G4UniformRand() <  perc_front_roof_vol_){
-            vertex = front_roof_gen_->GenerateVertex("INSIDE");
-            if (G4UniformRand() < 0.5) {
-              vertex.setZ(vertex.z() + (shield_z_/2.+steel_thickness_+lead_thickness_/2.));
-            }
-            else{
-              vertex.setZ(vertex.z() - (shield_z_/2.+steel_thickness_+lead_thickness_/2.));
-            }
-        	}
-        	else{
-              vertex = lat_roof_gen_->GenerateVertex("INSIDE");
-          	  if (G4UniformRand() < 0.5) {
-          	    vertex.setX(vertex.x() + (shield_x_/2.+ steel_thickness_ + lead_thickness_/2.));
-          	  }
-          	  else{
-          	    vertex.setX(vertex.x() - (shield_x_/2.+ steel_thickness_ + lead_thickness_/2.));
-          	  }
-        	}
-        }
-
-        else if (rand < (perc_top_struct_vol_ + perc_roof_vol_)) { //TOP BEAM STRUCTURE
-            	G4double random = G4UniformRand();
-            	if (random <  perc_struc_x_vol_){
-            	  G4double rand_beam = int (4* G4UniformRand());
-                vertex = struct_x_gen_->GenerateVertex("INSIDE");
-            	  if (rand_beam == 1) {
-            	    vertex.setZ(vertex.z()-roof_z_separation_);
-            	  }
-            	  else if (rand_beam == 2) {
-            	    vertex.setZ(vertex.z()-(roof_z_separation_+lateral_z_separation_));
-            	  }
-            	  else if (rand_beam == 3) {
-            	    vertex.setZ(vertex.z()-(2*roof_z_separation_+lateral_z_separation_));
-            	  }
-            	}
-            	else {
-                vertex = struct_z_gen_->GenerateVertex("INSIDE");
-            	  if (G4UniformRand() < 0.5) {
-            	    vertex.setX(vertex.x()+front_x_separation_);
-            	  }
-              }
-        }
-
-        else{ //LATERAL BEAM STRUCTURE
-              G4double lat_prob = beam_thickness_1/(beam_thickness_1+beam_thickness_2);
-              if (G4UniformRand()<lat_prob){ //lateral
-              	G4double rand_beam = int (4 * G4UniformRand());
-                vertex = lat_beam_gen_->GenerateVertex("INSIDE");
-              	if (rand_beam ==1){
-              	  vertex.setZ(vertex.z() - lateral_z_separation_);
-              	}
-              	else if (rand_beam ==2){
-              	  vertex.setX(vertex.x() - (shield_x_ + 2*steel_thickness_ + lead_thickness_));
-              	}
-              	else if (rand_beam ==3){
-              	  vertex.setX(vertex.x() - (shield_x_ + 2*steel_thickness_ + lead_thickness_));
-              	  vertex.setZ(vertex.z() - lateral_z_separation_);
-              	}
-              }
-              else{ // front
-                G4double rand_beam = int (4 * G4UniformRand());
-                vertex = front_beam_gen_->GenerateVertex("INSIDE");
-              	if (rand_beam ==1){
-              	  vertex.setX(vertex.x() + front_x_separation_);
-              	}
-              	else if (rand_beam ==2){
-              	  vertex.setZ(vertex.z() - (shield_z_+2*steel_thickness_+lead_thickness_));
-              	}
-              	else if (rand_beam ==3){
-              	  vertex.setX(vertex.x() + front_x_separation_);
-              	  vertex.setZ(vertex.z() - (shield_z_+2*steel_thickness_+lead_thickness_));
-              	}
-              }
-            }
-        }
-
-    else if(region=="PEDESTAL"){
-        G4double rand = G4UniformRand();
-
-        if (rand < perc_ped_bottom_vol_) { //SUPPORT-BOTTOM
-          vertex = ped_support_bottom_gen_->GenerateVertex("INSIDE");
-      	  if (G4UniformRand() < 0.5) {
-      	    vertex.setZ(vertex.z() - support_beam_dist_);
-      	  }
-        }
-        else if (rand < (perc_ped_bottom_vol_ + perc_ped_top_vol_)) { //SUPPORT-TOP
-          vertex = ped_support_top_gen_->GenerateVertex("INSIDE");
-          if (G4UniformRand() < 0.5) {
-      	    vertex.setZ(vertex.z() - support_beam_dist_);
-      	  }
-        }
-        else if (rand < (perc_ped_bottom_vol_ + perc_ped_top_vol_ + perc_ped_front_vol_)){ //FRONT BEAM
-          vertex = ped_front_gen_->GenerateVertex("INSIDE");
-          if (G4UniformRand() < 0.5) {
-      	    vertex.setZ(vertex.z() - (2.*support_front_dist_ + support_beam_dist_));
-      	  }
-        }
-        else if (rand < (perc_ped_bottom_vol_ + perc_ped_top_vol_ + perc_ped_front_vol_
-                                                                  + perc_ped_lateral_vol_)){ // LATERAL BEAM
-          vertex = ped_lateral_gen_->GenerateVertex("INSIDE");
-          if (G4UniformRand() < 0.5) {
-            vertex.setX(vertex.x() - (pedestal_x_ + pedestal_lateral_beam_thickness_));
-          }
-         }
-        else { // ROOF
-          if (G4UniformRand() < 0.5) {
-            vertex = ped_roof_lat_gen_->GenerateVertex("INSIDE");
-            if (G4UniformRand() < 0.5){
-              vertex.setX(vertex.x() - pedestal_top_x_ - pedestal_roof_thickness_);
-            }
-          }
-          else{
-            vertex = ped_roof_front_gen_->GenerateVertex("INSIDE");
-            if (G4UniformRand() < 0.5){
-              vertex.setZ(vertex.z() - pedestal_lateral_length_ + pedestal_roof_thickness_);
-            }
-          }
-         }
-      }
+    else if (region == "SHIELDING_STRUCT") {
+      vertex = struct_gen_->Shoot();
+    }
+
+    else if (region == "PEDESTAL") {
+      vertex = pedestal_gen_->Shoot();
+    }
 
     // Note: BUBBLE_SEAL and EDPM_SEAL are not implemented as logical volumes, only their
     // generators. They are placed in INNER_AIR volume.
-    else if(region=="BUBBLE_SEAL"){
-      G4double rand = G4UniformRand();
-      if (rand<perc_bubble_front_vol_){ // front
-        vertex = bubble_seal_front_gen_->GenerateVertex("INSIDE");
-        if (G4UniformRand() < 0.5){
-          vertex.setZ(vertex.z() + (support_beam_dist_/2. + support_front_dist_
-                                 + pedestal_front_beam_thickness_/2. + bubble_seal_thickness_/2.));
-        }
-        else{
-          vertex.setZ(vertex.z() - (support_beam_dist_/2. + support_front_dist_
-                                 + pedestal_front_beam_thickness_/2. + bubble_seal_thickness_/2.));
-        }
-      }
-      else{ // lateral
-        vertex = bubble_seal_lateral_gen_->GenerateVertex("INSIDE");
-        if (G4UniformRand() < 0.5){
-          vertex.setX(vertex.x() + (pedestal_x_/2. + pedestal_lateral_beam_thickness_
-                                 + bubble_seal_thickness_/2.));
-        }
-        else{
-          vertex.setX(vertex.x() - (pedestal_x_/2. + pedestal_lateral_beam_thickness_
-                                 + bubble_seal_thickness_/2.));
-        }
-      }
-      }
-
-    else if(region=="EDPM_SEAL"){
-      G4double rand = G4UniformRand();
-      if (rand<perc_edpm_front_vol_){ // front
-        vertex = edpm_seal_front_gen_->GenerateVertex("INSIDE");
-        if (G4UniformRand() < 0.5){
-          vertex.setZ(vertex.z() + (shield_z_/2. - edpm_seal_thickness_/2.));
-        }
-        else{
-          vertex.setZ(vertex.z() - (shield_z_/2. - edpm_seal_thickness_/2.));
-        }
-      }
-      else{ // lateral
-        vertex = edpm_seal_lateral_gen_->GenerateVertex("INSIDE");
-        vertex.setY(vertex.y() + (shield_y_/2. - edpm_seal_thickness_/2.));
-      }
+    else if (region == "BUBBLE_SEAL") {
+      vertex = bubble_seal_gen_->Shoot();
+    }
+
+    else if (region == "EDPM_SEAL") {
+      vertex = edpm_seal_gen_->Shoot();
     }
 
     else {
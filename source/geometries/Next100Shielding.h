@@ -20,6 +20,7 @@ class G4GenericMessenger;
 namespace nexus {
 
   class BoxPointSampler;
+  class CompositeVolumeSampler;
 
   class Next100Shielding: public GeometryBase
   {
@@ -91,20 +92,11 @@ namespace nexus {
     BoxPointSampler* edpm_seal_front_gen_;
     BoxPointSampler* edpm_seal_lateral_gen_;
 
-    G4double perc_roof_vol_;
-    G4double perc_front_roof_vol_;
-    G4double perc_top_struct_vol_;
-    G4double perc_struc_x_vol_;
-    G4double perc_ped_bottom_vol_;
-    G4double perc_ped_top_vol_;
-    G4double perc_ped_front_vol_;
-    G4double perc_ped_lateral_vol_;
-    G4double perc_ped_roof_vol_;
-
-    G4double perc_bubble_front_vol_;
-    G4double perc_buble_lateral_vol_;
-    G4double perc_edpm_front_vol_;
-    G4double perc_edpm_lateral_vol_;
+    // Generators of the regions made of several parts
+    CompositeVolumeSampler* struct_gen_;
+    CompositeVolumeSampler* pedestal_gen_;
+    CompositeVolumeSampler* bubble_seal_gen_;
+    CompositeVolumeSampler* edpm_seal_gen_;
 
 
     // Geometry Navigator
@@ -37,6 +37,7 @@ NextDemo::NextDemo():
   msg_->DeclarePropertyWithUnit("specific_vertex", "mm",  specific_vertex_,
       "Set generation vertex.");
 
+  RegisterVertexRegions();
 }
 
 
@@ -91,28 +92,26 @@ void NextDemo::ConstructLab()
 
 G4ThreeVector NextDemo::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vtx;
-
-  if (region == "AD_HOC") {
-    vtx = specific_vertex_;
-  }
-  else if (region == "CALIBRATION_SOURCE") {
-    vtx = vessel_geom_->GenerateVertex("CALIBRATION_SOURCE");
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance());
-    vtx = vtx + displacement;
-  }
-  else if ((region == "ACTIVE")  ||
-           (region == "TP_PLATE") ||
-           (region == "SIPM_BOARD") ||
-           (region == "EL_GAP")) {
-    vtx = inner_geom_->GenerateVertex(region);
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance());
-    vtx = vtx + displacement;
-  }
-  else {
-    G4Exception("[NextDemo]", "GenerateVertex()", FatalException,
-                "Unknown vertex generation region.");
-  }
-
-  return vtx;
+  return GetVertexSampler(region)();
+}
+
+
+void NextDemo::RegisterVertexRegions()
+{
+  // The vertices of the components are displaced
+  // to the position of the gate in the vessel
+  auto register_component = [this](const G4String& region,
+                                    const GeometryBase* component) {
+    VertexSampler sampler = component->GetVertexSampler(region);
+    RegisterVertexRegion(region, [this, sampler]() {
+        return sampler() +
+          G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance()); });
+  };
+
+  RegisterVertexRegion("AD_HOC", [this]() { return specific_vertex_; });
+
+  register_component("CALIBRATION_SOURCE", vessel_geom_);
+
+  for (const G4String region : {"ACTIVE", "TP_PLATE", "SIPM_BOARD", "EL_GAP"})
+    register_component(region, inner_geom_);
 }
@@ -71,6 +71,9 @@ NextFlex::NextFlex():
 
   // Tracking Plane
   tracking_plane_ = new NextFlexTrackingPlane();
+
+  // Vertex generation regions
+  RegisterVertexRegions();
 }
 
 
@@ -289,44 +292,26 @@ void NextFlex::BuildICS(G4LogicalVolume* mother_logic) {
 
 G4ThreeVector NextFlex::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vertex;
+  return GetVertexSampler(region)();
+}
+
 
-  if (region == "AD_HOC") {
-    vertex = specific_vertex_;
-  }
+
+void NextFlex::RegisterVertexRegions()
+{
+  RegisterVertexRegion("AD_HOC", [this]() { return specific_vertex_; });
 
   // ICS region
-  else if (region == "ICS") {
-    vertex = copper_gen_->GenerateVertex("VOLUME");
-  }
+  RegisterVertexRegion("ICS", [this]() { return copper_gen_->GenerateVertex("VOLUME"); });
 
   // Field Cage regions
-  else if (
-    (region == "ACTIVE") ||
-    (region == "BUFFER") ||
-    (region == "EL_GAP") ||
-    (region == "LIGHT_TUBE") ||
-    (region == "FIBER_CORE")) {
-    vertex = field_cage_->GenerateVertex(region);
-  }
+  for (const G4String region : {"ACTIVE", "BUFFER", "EL_GAP", "LIGHT_TUBE", "FIBER_CORE"})
+    RegisterVertexRegion(region, field_cage_->GetVertexSampler(region));
 
   // Energy Plane regions
-  else if (
-    (region == "EP_COPPER") ||
-    (region == "EP_WINDOWS")) {
-    vertex = energy_plane_->GenerateVertex(region);
-  }
+  for (const G4String region : {"EP_COPPER", "EP_WINDOWS"})
+    RegisterVertexRegion(region, energy_plane_->GetVertexSampler(region));
 
   // Tracking Plane regions
-  else if (
-    (region == "TP_COPPER")) {
-    vertex = tracking_plane_->GenerateVertex(region);
-  }
-
-  else {
-    G4Exception("[NextFlex]", "GenerateVertex()", FatalException,
-      "Unknown vertex generation region!");
-  }
-
-  return vertex;
+  RegisterVertexRegion("TP_COPPER", tracking_plane_->GetVertexSampler("TP_COPPER"));
 }
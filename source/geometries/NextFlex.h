@@ -57,6 +57,9 @@ namespace nexus {
     // Different builders
     void BuildICS(G4LogicalVolume* mother_logic);
 
+    // Registers the vertex generation regions
+    void RegisterVertexRegions();
+
   private:
 
     const G4int FIRST_ENERGY_SENSOR_ID      =      0;
@@ -133,6 +133,7 @@ namespace nexus {
 
     extra_ = new ExtraVessel();
 
+    RegisterVertexRegions();
   }
 
   NextNew::~NextNew()
@@ -445,152 +446,120 @@ namespace nexus {
 
   G4ThreeVector NextNew::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
+    return GetVertexSampler(region)();
+  }
+
+
+  void NextNew::RegisterVertexRegions()
+  {
+    // The vertices of the detector are first rotated
+    // and then shifted to its position in the lab
+    auto register_region = [this](const G4String& region, VertexSampler sampler) {
+      RegisterVertexRegion(region, [this, sampler]() {
+          G4ThreeVector vertex = sampler();
+          vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
+          return vertex + displ_; });
+    };
+
+    auto register_component = [register_region](const G4String& region,
+                                                 const GeometryBase* component) {
+      register_region(region, component->GetVertexSampler(region));
+    };
 
     //AIR AROUND SHIELDING
-    if (region == "LAB") {
-      vertex = lab_gen_->GenerateVertex("INSIDE");
-    }
+    register_region("LAB", [this]() { return lab_gen_->GenerateVertex("INSIDE"); });
+
     /// Calibration source in capsule, placed inside Jordi's lead,
     /// at the end (lateral and axial ports).
-    else if (region == "EXTERNAL_PORT_ANODE") {
-      if (lead_block_) {
-        vertex =  lat_source_gen_->GenerateVertex("BODY_VOL");
-      } else {
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
-                    "This vertex generation region must be used together with lead_block == true!");
-      }
-    }
-    else if (region == "EXTERNAL_PORT_AXIAL") {
-      if (lead_block_) {
-        vertex =  axial_source_gen_->GenerateVertex("BODY_VOL");
-      } else {
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
-                    "This vertex generation region must be used together with lead_block == true!");
-      }
-    }
-    // Vertex just outside the axial port
-    else if (region == "SOURCE_PORT_AXIAL_EXT") {
-      vertex = vessel_->GetAxialExtSourcePosition();
-    }
-    // Vertex just outside the lateral port
-    else if (region == "SOURCE_PORT_LATERAL_EXT") {
-      vertex = vessel_->GetLatExtSourcePosition();
-    }
+    register_region("EXTERNAL_PORT_ANODE", [this]() {
+        if (!lead_block_)
+          G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+                      "This vertex generation region must be used together with lead_block == true!");
+        return lat_source_gen_->GenerateVertex("BODY_VOL"); });
+
+    register_region("EXTERNAL_PORT_AXIAL", [this]() {
+        if (!lead_block_)
+          G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+                      "This vertex generation region must be used together with lead_block == true!");
+        return axial_source_gen_->GenerateVertex("BODY_VOL"); });
+
+    // Vertices just outside the axial and lateral ports
+    register_region("SOURCE_PORT_AXIAL_EXT",
+                    [this]() { return vessel_->GetAxialExtSourcePosition(); });
+    register_region("SOURCE_PORT_LATERAL_EXT",
+                    [this]() { return vessel_->GetLatExtSourcePosition(); });
+
     // Extended sources with the shape of a disk outside port
-    else if (region == "SOURCE_PORT_LATERAL_DISK") {
-      vertex =  source_gen_lat_->GenerateVertex("BODY_VOL");
-    }
-    else if (region == "SOURCE_PORT_UP_DISK") {
-      vertex =  source_gen_up_->GenerateVertex("BODY_VOL");
-    }
-     else if (region == "SOURCE_DISK") {
-      vertex =  source_gen_random_->GenerateVertex("BODY_VOL");
-    }
-    else if ( (region == "SHIELDING_LEAD") || (region == "SHIELDING_STEEL") ||
-	          (region == "INNER_AIR")  || (region == "SHIELDING_STRUCT") ||
-	          (region == "EXTERNAL") ) {
-      vertex = shielding_->GenerateVertex(region);
-    }
+    register_region("SOURCE_PORT_LATERAL_DISK",
+                    [this]() { return source_gen_lat_->GenerateVertex("BODY_VOL"); });
+    register_region("SOURCE_PORT_UP_DISK",
+                    [this]() { return source_gen_up_->GenerateVertex("BODY_VOL"); });
+    register_region("SOURCE_DISK",
+                    [this]() { return source_gen_random_->GenerateVertex("BODY_VOL"); });
+
+    for (const G4String region : {"SHIELDING_LEAD", "SHIELDING_STEEL", "INNER_AIR",
+                                  "SHIELDING_STRUCT", "EXTERNAL"})
+      register_component(region, shielding_);
+
     //PEDESTAL
-    else if (region == "PEDESTAL_BOARD") {
-      vertex = pedestal_->GenerateVertex(region);
-    }
+    register_component("PEDESTAL_BOARD", pedestal_);
+
     // EXTRA ELEMENTS
-    else if (region == "EXTRA_VESSEL") {
-      G4ThreeVector ini_vertex = extra_->GenerateVertex(region);
-      ini_vertex.rotate(pi/2., G4ThreeVector(1., 0., 0.));
-      vertex = ini_vertex + extra_pos_;
-    }
-    // Lab walls
-    else if ((region == "HALLA_INNER") || (region == "HALLA_OUTER")){
-      if (!lab_walls_)
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
-                    "This vertex generation region must be used with lab_walls == true!");
-      vertex = hallA_walls_->GenerateVertex(region);
-      vertex = displ_ + vertex;
+    register_region("EXTRA_VESSEL", [this]() {
+        G4ThreeVector ini_vertex = extra_->GenerateVertex("EXTRA_VESSEL");
+        ini_vertex.rotate(pi/2., G4ThreeVector(1., 0., 0.));
+        return ini_vertex + extra_pos_; });
+
+    // Lab walls: the LSC HallA vertices are already rotated
+    for (const G4String region : {"HALLA_INNER", "HALLA_OUTER"}) {
+      VertexSampler sampler = hallA_walls_->GetVertexSampler(region);
+      RegisterVertexRegion(region, [this, sampler]() {
+          if (!lab_walls_)
+            G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+                        "This vertex generation region must be used with lab_walls == true!");
+          return displ_ + sampler(); });
     }
 
     //  MINI CASTLE and RADON
     // on the inner lead surface (SHIELDING_GAS) and on the outer mini lead castle surface (RN_MINI_CASTLE)
-    else if ((region == "MINI_CASTLE") ||
-             (region == "RN_MINI_CASTLE") ||
-             (region == "MINI_CASTLE_STEEL")) {
-      vertex = mini_castle_->GenerateVertex(region);
-    }
+    for (const G4String region : {"MINI_CASTLE", "RN_MINI_CASTLE", "MINI_CASTLE_STEEL"})
+      register_component(region, mini_castle_);
+
     //VESSEL REGIONS
-    else if ((region == "VESSEL") ||
-             (region == "SOURCE_PORT_ANODE") ||
-             (region == "SOURCE_PORT_UP") ||
-             (region == "SOURCE_PORT_AXIAL") ||
-             (region == "INTERNAL_PORT_ANODE") ||
-             (region == "INTERNAL_PORT_UPPER") ||
-             (region == "INTERNAL_PORT_AXIAL")){
-      vertex = vessel_->GenerateVertex(region);
-    }
+    for (const G4String region : {"VESSEL", "SOURCE_PORT_ANODE", "SOURCE_PORT_UP",
+                                  "SOURCE_PORT_AXIAL", "INTERNAL_PORT_ANODE",
+                                  "INTERNAL_PORT_UPPER", "INTERNAL_PORT_AXIAL"})
+      register_component(region, vessel_);
+
     // ICS REGIONS
-    else if (region == "ICS") {
-      vertex = ics_->GenerateVertex(region);
-    }
-    //INNER ELEMENTS
-    else if ((region == "CENTER") ||
-             (region == "CARRIER_PLATE") ||
-             (region == "ENCLOSURE_BODY") ||
-             (region == "ENCLOSURE_WINDOW") ||
-             (region == "OPTICAL_PAD") ||
-             (region == "PMT_BODY") ||
-             (region == "PMT_BASE") ||
-             (region == "INT_ENCLOSURE_SURF") ||
-             (region == "PMT_SURF") ||
-             (region == "DRIFT_TUBE") ||
-             (region == "ANODE_QUARTZ")||
-             (region == "HDPE_TUBE") ||
-             (region == "XENON") ||
-             (region == "ACTIVE") ||
-             (region == "BUFFER") ||
-             (region == "EL_GAP") ||
-             (region == "EL_TABLE") ||
-             (region == "CATHODE")||
-             (region == "TRACKING_FRAMES") ||
-             (region == "SUPPORT_PLATE") ||
-             (region == "DICE_BOARD") ||
-             (region == "DB_PLUG")) {
-      vertex = inner_elements_->GenerateVertex(region);
-    }
-    // AD_HOC is not rotated and shifted because it is passed by the user
-    else if (region == "AD_HOC") {
-      return specific_vertex_;
-    }
-    else {
-      G4Exception("[NextNew]", "GenerateVertex()", FatalException,
-		  "Unknown vertex generation region!");
-    }
+    register_component("ICS", ics_);
 
-    // The LSC HallA vertices are already corrected so no need.
-    if ((region == "HALLA_OUTER") ||
-        (region == "HALLA_INNER"))
-      return vertex;
+    //INNER ELEMENTS
+    for (const G4String region : {"CENTER", "CARRIER_PLATE", "ENCLOSURE_BODY",
+                                  "ENCLOSURE_WINDOW", "OPTICAL_PAD", "PMT_BODY",
+                                  "PMT_BASE", "INT_ENCLOSURE_SURF", "PMT_SURF",
+                                  "DRIFT_TUBE", "ANODE_QUARTZ", "HDPE_TUBE", "XENON",
+                                  "ACTIVE", "BUFFER", "EL_TABLE", "CATHODE",
+                                  "TRACKING_FRAMES", "SUPPORT_PLATE", "DICE_BOARD",
+                                  "DB_PLUG"})
+      register_component(region, inner_elements_);
 
     // In EL_GAP, x and y coordinates are passed by the user,
     // but the z coordinate is not. Therefore, rotation + displacement
     // must be applied to get the correct z, but x and y must be left
     // unchanged.
-    if (region == "EL_GAP") {
-      // First rotate, then shift to return the correct z coordinate
-      vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
-      vertex = vertex + displ_;
+    VertexSampler el_gap = inner_elements_->GetVertexSampler("EL_GAP");
+    RegisterVertexRegion("EL_GAP", [this, el_gap]() {
+        // First rotate, then shift to return the correct z coordinate
+        G4ThreeVector vertex = el_gap();
+        vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
+        vertex = vertex + displ_;
+        // Change back x coordinate alone (y is not touched).
+        vertex.setX(-vertex.x());
+        return vertex; });
 
-      // Change back x coordinate alone (y is not touched).
-      vertex.setX(-vertex.x());
-
-      return vertex;
-    }
-
-    // First rotate, then shift
-    vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
-    vertex = vertex + displ_;
-
-    return vertex;
+    // AD_HOC is not rotated and shifted because it is passed by the user
+    RegisterVertexRegion("AD_HOC", [this]() { return specific_vertex_; });
   }
 
 
@@ -13,6 +13,7 @@
 #include "CalibrationSource.h"
 #include "CylinderPointSampler.h"
 #include "SpherePointSampler.h"
+#include "CompositeVolumeSampler.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4LogicalVolume.hh>
@@ -769,14 +770,37 @@ void NextNewVessel::Construct()
 
 
 
-  /// Calculating some prob
+  /// Volumes of the parts of the vessel
   G4double body_vol = vessel_tube_solid->GetCubicVolume() - vessel_gas_tube_solid->GetCubicVolume();
   G4double flange_vol = vessel_flange_solid->GetCubicVolume();
   G4double endcap_vol = vessel_tracking_endcap_solid->GetCubicVolume() - vessel_gas_tracking_endcap_solid->GetCubicVolume();
-  G4double vol_tot = body_vol+ 2*flange_vol+ 2*endcap_vol;
 
-  perc_tube_vol_ = body_vol/vol_tot;
-  perc_endcap_vol_ = endcap_vol /vol_tot;
+  // The points of the body and endcaps generators are checked
+  // with the navigator, since those generators overlap the gas
+  vessel_gen_ = new CompositeVolumeSampler();
+
+  vessel_gen_->AddPart([this]() {
+      G4ThreeVector vertex;
+      do vertex = body_gen_->GenerateVertex("BODY_VOL");
+      while (!IsInVessel(vertex));
+      return vertex; }, body_vol);
+
+  vessel_gen_->AddPart([this]() {
+      G4ThreeVector vertex;
+      do vertex = tracking_endcap_gen_->GenerateVertex("VOLUME");
+      while (!IsInVessel(vertex));
+      return vertex; }, endcap_vol);
+
+  vessel_gen_->AddPart([this]() {
+      G4ThreeVector vertex;
+      do vertex = energy_endcap_gen_->GenerateVertex("VOLUME");
+      while (!IsInVessel(vertex));
+      return vertex; }, endcap_vol);
+
+  for (G4double sign : {1., -1.})
+    vessel_gen_->AddPart([this, sign]() {
+        return flange_gen_->GenerateVertex("BODY_VOL") +
+          G4ThreeVector(0., 0., sign * flange_z_pos_); }, flange_vol);
   }
 
   NextNewVessel::~NextNewVessel()
@@ -787,6 +811,7 @@ void NextNewVessel::Construct()
     delete energy_endcap_gen_;
     delete screw_gen_lat_;
     delete screw_gen_axial_;
+    delete vessel_gen_;
   }
 
 
@@ -842,56 +867,7 @@ void NextNewVessel::Construct()
     G4ThreeVector vertex(0., 0., 0.);
     // Vertex in the VESSEL volume
     if (region == "VESSEL") {
-      G4double rand = G4UniformRand();
-      if (rand < perc_tube_vol_) { //VESSEL_TUBE
-	G4VPhysicalVolume *VertexVolume;
-	do {
-	  // std::cout<< "vessel tube \t"<< rand <<"\t"<< perc_tube_vol_ << std::endl;
-	  vertex = body_gen_->GenerateVertex("BODY_VOL");
-	  // To check its volume, one needs to rotate and shift the vertex
-	  // because the check is done using global coordinates
-	  G4ThreeVector glob_vtx(vertex);
-	  // First rotate, then shift
-	  glob_vtx.rotate(pi, G4ThreeVector(0., 1., 0.));
-	  glob_vtx = glob_vtx + G4ThreeVector(0, 0, GetELzCoord());
-	  VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-	  // std::cout<<vertex<<std::endl;
-	} while (VertexVolume->GetName() != "VESSEL");
-      }
-      //Vertex in ENDCAPS
-      else if (rand < (perc_tube_vol_+2*perc_endcap_vol_)){
-	G4VPhysicalVolume *VertexVolume;
-	do {
-	  if (G4UniformRand() < 0.5){
-	    //std::cout<< "tracking endcap "<< rand <<"\t"<< perc_tube_vol_+2*perc_endcap_vol_<< std::endl;
-	    vertex = tracking_endcap_gen_->GenerateVertex("VOLUME");  // Tracking
-	  }
-	  else {
-	    //std::cout<< "energy endcap " << rand <<"\t"<< perc_tube_vol_+2*perc_endcap_vol_<< std::endl;
-	    vertex = energy_endcap_gen_->GenerateVertex("VOLUME");  // Energy endcap
-	  }
-	  // To check its volume, one needs to rotate and shift the vertex
-	  // because the check is done using global coordinates
-	  G4ThreeVector glob_vtx(vertex);
-	  // First rotate, then shift
-	  glob_vtx.rotate(pi, G4ThreeVector(0., 1., 0.));
-	  glob_vtx = glob_vtx + G4ThreeVector(0, 0, GetELzCoord());
-	  VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-	  //std::cout<<vertex<<std::endl;
-	} while (VertexVolume->GetName() != "VESSEL");
-      }
-      else { //FLANGES
-   	if (G4UniformRand() < 0.5) {
-	  vertex = flange_gen_->GenerateVertex("BODY_VOL");
-	  vertex.setZ(vertex.z() + flange_z_pos_);
-	  //std::cout<< "flange tracking \t"<<vertex.z() <<"\t"<< rand << std::endl;
-    	}
-    	else {
-	  vertex = flange_gen_->GenerateVertex("BODY_VOL");
-    	  vertex.setZ(vertex.z() - flange_z_pos_);
-	  //std::cout<< "flange energy \t"<<vertex.z() <<"\t"<<rand<< std::endl;
-   	}
-      }
+      vertex = vessel_gen_->Shoot();
     }
     /// Vertex inside lateral feedthrough, most internal position
     else if (region =="SOURCE_PORT_ANODE") {
@@ -927,4 +903,17 @@ void NextNewVessel::Construct()
     return vertex;
   }
 
+  G4bool NextNewVessel::IsInVessel(const G4ThreeVector& vertex) const
+  {
+    // To check its volume, one needs to rotate and shift the vertex
+    // because the check is done using global coordinates
+    G4ThreeVector glob_vtx(vertex);
+    // First rotate, then shift
+    glob_vtx.rotate(pi, G4ThreeVector(0., 1., 0.));
+    glob_vtx = glob_vtx + G4ThreeVector(0, 0, GetELzCoord());
+    G4VPhysicalVolume* VertexVolume =
+      geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+    return VertexVolume->GetName() == "VESSEL";
+  }
+
 }//end namespace nexus
@@ -20,6 +20,7 @@ namespace nexus {
   class CalibrationSource;
   class CylinderPointSampler;
   class SpherePointSampler;
+  class CompositeVolumeSampler;
 
   class NextNewVessel: public GeometryBase
   {
@@ -52,6 +53,9 @@ namespace nexus {
 
 
   private:
+    /// Returns true if a vertex (in local coordinates) is in the vessel
+    G4bool IsInVessel(const G4ThreeVector& vertex) const;
+
     //Dimensions
     G4double  vessel_in_diam_, vessel_body_length_, vessel_tube_length_, vessel_thickness_;
     G4double flange_out_diam_, flange_length_, flange_z_pos_;
@@ -97,8 +101,8 @@ namespace nexus {
     CylinderPointSampler* screw_gen_up_;
     CylinderPointSampler* screw_gen_axial_;
 
-    G4double perc_endcap_vol_;
-    G4double perc_tube_vol_;
+    // Generator of the VESSEL region (body, endcaps and flanges)
+    CompositeVolumeSampler* vessel_gen_;
 
     // Geometry Navigator
     G4Navigator* geom_navigator_;
@@ -20,8 +20,9 @@ using namespace nexus;
 
 
 HDF5Writer::HDF5Writer():
-  file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0)
+  file_(0), irun_(0), ismp_(0), icnt_(0), iwvf_(0), ihit_(0),
+  ipart_(0), ipos_(0), istep_(0), isub_(0), isrc_(0),
+  ievp_(0), ispt_(0), iscn_(0)
 {
 }
 
@@ -47,6 +48,14 @@ void HDF5Writer::Open(std::string fileName, bool debug)
   memtypeSnsData_ = createSensorDataType();
   snsDataTable_ = createTable(group, sns_data_table_name, memtypeSnsData_);
 
+  std::string sns_counts_table_name = "sns_counts";
+  memtypeSnsCounts_ = createSensorCountsType();
+  snsCountsTable_ = createTable(group, sns_counts_table_name, memtypeSnsCounts_);
+
+  std::string sns_wvf_table_name = "sns_waveforms";
+  memtypeSnsWvf_ = createSensorWaveformType();
+  snsWvfTable_ = createTable(group, sns_wvf_table_name, memtypeSnsWvf_);
+
   std::string hit_info_table_name = "hits";
   memtypeHitInfo_ = createHitInfoType();
   hitInfoTable_ = createTable(group, hit_info_table_name, memtypeHitInfo_);
@@ -59,6 +68,26 @@ void HDF5Writer::Open(std::string fileName, bool debug)
   memtypeSnsPos_ = createSensorPosType();
   snsPosTable_ = createTable(group, sns_pos_table_name, memtypeSnsPos_);
 
+  std::string sub_event_table_name = "sub_events";
+  memtypeSubEvent_ = createSubEventType();
+  subEventTable_ = createTable(group, sub_event_table_name, memtypeSubEvent_);
+
+  std::string event_source_table_name = "event_sources";
+  memtypeEventSource_ = createEventSourceType();
+  eventSourceTable_ = createTable(group, event_source_table_name, memtypeEventSource_);
+
+  std::string event_point_table_name = "event_points";
+  memtypeEventPoint_ = createEventPointType();
+  eventPointTable_ = createTable(group, event_point_table_name, memtypeEventPoint_);
+
+  std::string scan_point_table_name = "scan_points";
+  memtypeScanPoint_ = createScanPointType();
+  scanPointTable_ = createTable(group, scan_point_table_name, memtypeScanPoint_);
+
+  std::string scan_counts_table_name = "scan_counts";
+  memtypeScanCounts_ = createScanCountsType();
+  scanCountsTable_ = createTable(group, scan_counts_table_name, memtypeScanCounts_);
+
   if (debug) {
     std::string debug_group_name = "/DEBUG";
     size_t debug_group = createGroup(file_, debug_group_name);
@@ -101,6 +130,29 @@ void HDF5Writer::WriteSensorDataInfo(int evt_number, unsigned int sensor_id, uns
   ismp_++;
 }
 
+void HDF5Writer::WriteSensorCountsInfo(int evt_number, unsigned int sensor_id, unsigned int charge)
+{
+  sns_counts_t snsCounts;
+  snsCounts.event_id = evt_number;
+  snsCounts.sensor_id = sensor_id;
+  snsCounts.charge = charge;
+  writeSnsCounts(&snsCounts, snsCountsTable_, memtypeSnsCounts_, icnt_);
+
+  icnt_++;
+}
+
+void HDF5Writer::WriteSensorWaveformInfo(int evt_number, unsigned int sensor_id, uint64_t time_bin, float amplitude)
+{
+  sns_wvf_t snsWvf;
+  snsWvf.event_id = evt_number;
+  snsWvf.sensor_id = sensor_id;
+  snsWvf.time_bin = time_bin;
+  snsWvf.amplitude = amplitude;
+  writeSnsWaveform(&snsWvf, snsWvfTable_, memtypeSnsWvf_, iwvf_);
+
+  iwvf_++;
+}
+
 void HDF5Writer::WriteHitInfo(int evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label)
 {
   hit_info_t trueInfo;
@@ -203,3 +255,60 @@ void HDF5Writer::WriteStep(int evt_number,
 
   istep_++;
 }
+
+void HDF5Writer::WriteSubEventInfo(int evt_number, int particle_indx, int sub_event)
+{
+  sub_event_t subEvent;
+  subEvent.event_id    = evt_number;
+  subEvent.particle_id = particle_indx;
+  subEvent.sub_event   = sub_event;
+  writeSubEvent(&subEvent, subEventTable_, memtypeSubEvent_, isub_);
+
+  isub_++;
+}
+
+void HDF5Writer::WriteEventSourceInfo(int evt_number, const char* source, float weight)
+{
+  event_source_t eventSource;
+  eventSource.event_id = evt_number;
+  memset(eventSource.source, 0, STRLEN);
+  strcpy(eventSource.source, source);
+  eventSource.weight = weight;
+  writeEventSource(&eventSource, eventSourceTable_, memtypeEventSource_, isrc_);
+
+  isrc_++;
+}
+
+void HDF5Writer::WriteEventPointInfo(int evt_number, int point_id)
+{
+  event_point_t eventPoint;
+  eventPoint.event_id = evt_number;
+  eventPoint.point_id = point_id;
+  writeEventPoint(&eventPoint, eventPointTable_, memtypeEventPoint_, ievp_);
+
+  ievp_++;
+}
+
+void HDF5Writer::WriteScanPointInfo(int point_id, float x, float y, float z, unsigned int events)
+{
+  scan_point_t scanPoint;
+  scanPoint.point_id = point_id;
+  scanPoint.x = x;
+  scanPoint.y = y;
+  scanPoint.z = z;
+  scanPoint.events = events;
+  writeScanPoint(&scanPoint, scanPointTable_, memtypeScanPoint_, ispt_);
+
+  ispt_++;
+}
+
+void HDF5Writer::WriteScanCountsInfo(int point_id, unsigned int sensor_id, uint64_t charge)
+{
+  scan_counts_t scanCounts;
+  scanCounts.point_id = point_id;
+  scanCounts.sensor_id = sensor_id;
+  scanCounts.charge = charge;
+  writeScanCounts(&scanCounts, scanCountsTable_, memtypeScanCounts_, iscn_);
+
+  iscn_++;
+}
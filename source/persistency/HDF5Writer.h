@@ -32,6 +32,8 @@ namespace nexus {
 
     void WriteRunInfo(const char* param_key, const char* param_value);
     void WriteSensorDataInfo(int evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
+    void WriteSensorCountsInfo(int evt_number, unsigned int sensor_id, unsigned int charge);
+    void WriteSensorWaveformInfo(int evt_number, unsigned int sensor_id, uint64_t time_bin, float amplitude);
     void WriteHitInfo(int evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label);
     void WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc);
     void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z);
@@ -43,6 +45,11 @@ namespace nexus {
                    const char*      proc_name,
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z);
+    void WriteSubEventInfo(int evt_number, int particle_indx, int sub_event);
+    void WriteEventSourceInfo(int evt_number, const char* source, float weight);
+    void WriteEventPointInfo(int evt_number, int point_id);
+    void WriteScanPointInfo(int point_id, float x, float y, float z, unsigned int events);
+    void WriteScanCountsInfo(int point_id, unsigned int sensor_id, uint64_t charge);
 
   private:
     size_t file_; ///< HDF5 file
@@ -53,24 +60,45 @@ namespace nexus {
     //Datasets
     size_t runTable_;
     size_t snsDataTable_;
+    size_t snsCountsTable_;
+    size_t snsWvfTable_;
     size_t hitInfoTable_;
     size_t particleInfoTable_;
     size_t snsPosTable_;
     size_t stepTable_;
+    size_t subEventTable_;
+    size_t eventSourceTable_;
+    size_t eventPointTable_;
+    size_t scanPointTable_;
+    size_t scanCountsTable_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
+    size_t memtypeSnsCounts_;
+    size_t memtypeSnsWvf_;
     size_t memtypeHitInfo_;
     size_t memtypeParticleInfo_;
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
+    size_t memtypeSubEvent_;
+    size_t memtypeEventSource_;
+    size_t memtypeEventPoint_;
+    size_t memtypeScanPoint_;
+    size_t memtypeScanCounts_;
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
+    size_t icnt_; ///< counter for sensor photon counts
+    size_t iwvf_; ///< counter for digitized waveform samples
     size_t ihit_; ///< counter for true information
     size_t ipart_; ///< counter for particle information
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
+    size_t isub_; ///< counter for sub-event labels
+    size_t isrc_; ///< counter for event sources
+    size_t ievp_; ///< counter for event scan points
+    size_t ispt_; ///< counter for scan points
+    size_t iscn_; ///< counter for scan sensor counts
 
   };
 
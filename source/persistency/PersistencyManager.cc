@@ -18,11 +18,16 @@
 #include "SaveAllSteppingAction.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
+#include "SubEventInfo.h"
+#include "BackgroundSourceInfo.h"
+#include "ScanPointInfo.h"
 #include "PersistencyManagerBase.h"
 #include "FactoryBase.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4PrimaryParticle.hh>
 #include <G4TrajectoryContainer.hh>
 #include <G4Trajectory.hh>
 #include <G4SDManager.hh>
@@ -46,7 +51,8 @@ PersistencyManager::PersistencyManager():
   store_evt_(true), store_steps_(false),
   interacting_evt_(false), event_type_("other"), saved_evts_(0),
   interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0)
+  nevt_(0), start_id_(0), first_evt_(true), sub_event_warned_(false),
+  h5writer_(0), scan_point_(-1)
 {
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
   msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "");
@@ -121,6 +127,10 @@ G4bool PersistencyManager::Store(const G4Event* event)
     interacting_evts_++;
   }
 
+  // The sensor counts of the points of a light-table scan
+  // are added up whether the event is stored or not
+  AccumulateScanCounts(event);
+
   if (!store_evt_) {
     TrajectoryMap::Clear();
     if (store_steps_) {
@@ -144,6 +154,16 @@ G4bool PersistencyManager::Store(const G4Event* event)
   // Store the trajectories of the event
   StoreTrajectories(event->GetTrajectoryContainer());
 
+  // Store the sub-event of every particle, if the generator set them
+  StoreSubEvents(event);
+
+  // Store the source of the event, if the generator chose one
+  StoreEventSource(event);
+
+  // Store the point of the scan of the event, if any
+  if (scan_point_ >= 0)
+    h5writer_->WriteEventPointInfo(nevt_, scan_point_);
+
   // Store ionization hits and sensor hits
   StoreHits(event->GetHCofThisEvent());
 
@@ -211,6 +231,137 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
 
 
 
+void PersistencyManager::StoreSubEvents(const G4Event* event)
+{
+  // Primary particles take the label of their vertex
+  std::map<G4int, G4int> sub_event;
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+    G4PrimaryVertex* vertex = event->GetPrimaryVertex(i);
+    SubEventInfo* info =
+      dynamic_cast<SubEventInfo*>(vertex->GetUserInformation());
+    if (!info) continue;
+
+    for (G4PrimaryParticle* p = vertex->GetPrimary(); p; p = p->GetNext())
+      sub_event[p->GetTrackID()] = info->GetSubEvent();
+  }
+
+  if (sub_event.empty()) return;
+
+  for (const auto& primary : sub_event)
+    h5writer_->WriteSubEventInfo(nevt_, primary.first, primary.second);
+
+  G4TrajectoryContainer* tc = event->GetTrajectoryContainer();
+  if (!tc) {
+    if (!sub_event_warned_) {
+      G4Exception("[PersistencyManager]", "StoreSubEvents()", JustWarning,
+                  "Trajectories are not stored: only the primary particles "
+                  "are labelled with their sub-event.");
+      sub_event_warned_ = true;
+    }
+    return;
+  }
+
+  // Secondaries take the label of their first labelled ancestor
+  std::map<G4int, G4int> parent;
+  for (size_t i=0; i<tc->entries(); ++i) {
+    Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
+    if (trj) parent[trj->GetTrackID()] = trj->GetParentID();
+  }
+
+  for (const auto& track : parent) {
+    // Labelled primaries are already written
+    if (track.second == 0 && sub_event.count(track.first)) continue;
+
+    std::vector<G4int> chain;
+    G4int id = track.first;
+    G4int label = -1;
+    while (id > 0) {
+      auto it = sub_event.find(id);
+      if (it != sub_event.end()) { label = it->second; break; }
+      chain.push_back(id);
+      auto p = parent.find(id);
+      id = (p != parent.end()) ? p->second : 0;
+    }
+    // Cache the label of the whole chain for the next tracks
+    for (G4int c : chain) sub_event[c] = label;
+
+    h5writer_->WriteSubEventInfo(nevt_, track.first, label);
+  }
+}
+
+
+
+void PersistencyManager::StoreEventSource(const G4Event* event)
+{
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+    BackgroundSourceInfo* info = dynamic_cast<BackgroundSourceInfo*>
+      (event->GetPrimaryVertex(i)->GetUserInformation());
+    if (!info) continue;
+
+    h5writer_->WriteEventSourceInfo(nevt_, info->GetLabel().c_str(),
+                                    (float)info->GetWeight());
+    return;
+  }
+}
+
+
+
+void PersistencyManager::AccumulateScanCounts(const G4Event* event)
+{
+  scan_point_ = -1;
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+    ScanPointInfo* info = dynamic_cast<ScanPointInfo*>
+      (event->GetPrimaryVertex(i)->GetUserInformation());
+    if (!info) continue;
+
+    scan_point_ = info->GetPoint();
+    std::pair<G4ThreeVector, G4int>& point = scan_points_[scan_point_];
+    point.first = info->GetPosition();
+    point.second++;
+    break;
+  }
+
+  G4HCofThisEvent* hce = event->GetHCofThisEvent();
+  if (scan_point_ < 0 || !hce) return;
+
+  G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+  G4HCtable* hct = sdmgr->GetHCtable();
+
+  for (auto i=0; i<hct->entries(); i++) {
+    if (hct->GetHCname(i) != SensorSD::GetCollectionUniqueName()) continue;
+
+    int hcid = sdmgr->GetCollectionID(hct->GetSDname(i)+"/"+hct->GetHCname(i));
+    SensorHitsCollection* hits = dynamic_cast<SensorHitsCollection*>(hce->GetHC(hcid));
+    if (!hits) continue;
+
+    for (size_t j=0; j<hits->entries(); j++) {
+      SensorHit* hit = dynamic_cast<SensorHit*>(hits->GetHit(j));
+      if (hit && hit->GetTotalCounts() > 0)
+        scan_counts_[std::make_pair(scan_point_, hit->GetPmtID())] += hit->GetTotalCounts();
+    }
+  }
+}
+
+
+
+void PersistencyManager::StoreScanCounts()
+{
+  for (const auto& point : scan_points_) {
+    const G4ThreeVector& xyz = point.second.first;
+    h5writer_->WriteScanPointInfo(point.first, (float)xyz.x(), (float)xyz.y(),
+                                  (float)xyz.z(), (unsigned int)point.second.second);
+  }
+
+  for (const auto& counts : scan_counts_)
+    h5writer_->WriteScanCountsInfo(counts.first.first,
+                                   (unsigned int)counts.first.second, counts.second);
+
+  scan_points_.clear();
+  scan_counts_.clear();
+}
+
+
+
 void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
 {
   if (!hce) return;
@@ -235,6 +386,8 @@ void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
       StoreIonizationHits(hits);
     else if (hcname == SensorSD::GetCollectionUniqueName()) {
       StoreSensorHits(hits);
+    } else if (hcname == SensorSD::GetWaveformCollectionUniqueName()) {
+      StoreSensorWaveforms(hits);
     } else {
       G4String msg =
         "Collection of hits '" + sdname + "/" + hcname
@@ -252,36 +405,26 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
     dynamic_cast<IonizationHitsCollection*>(hc);
   if (!hits) return;
 
-  hit_map_.clear();
+  // Hit index of each particle within this collection
+  hit_count_.clear();
 
-  double evt_energy = 0.;
   std::string sdname = hits->GetSDname();
 
-  for (size_t i=0; i<hits->entries(); i++) {
+  const IonizationHitBuffer& buffer = hits->GetBuffer();
+  const std::vector<G4int>&    track_id = buffer.GetTrackID();
+  const std::vector<G4double>& x        = buffer.GetX();
+  const std::vector<G4double>& y        = buffer.GetY();
+  const std::vector<G4double>& z        = buffer.GetZ();
+  const std::vector<G4double>& time     = buffer.GetTime();
+  const std::vector<G4double>& edep     = buffer.GetEnergyDeposit();
 
-    IonizationHit* hit = dynamic_cast<IonizationHit*>(hits->GetHit(i));
-    if (!hit) continue;
+  for (size_t i=0; i<buffer.Size(); i++) {
 
-    G4int trackid = hit->GetTrackID();
+    G4int hit_id = hit_count_[track_id[i]]++;
 
-    std::vector<G4int>* ihits = nullptr;
-    std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
-    if (it != hit_map_.end()) {
-      ihits = it->second;
-    } else {
-       ihits = new std::vector<G4int>;
-      hit_map_[trackid] = ihits;
-    }
-
-    ihits->push_back(1);
-
-    G4ThreeVector xyz = hit->GetPosition();
-    h5writer_->WriteHitInfo(nevt_, trackid,  ihits->size() - 1,
-			    xyz[0], xyz[1], xyz[2],
-			    hit->GetTime(), hit->GetEnergyDeposit(),
+    h5writer_->WriteHitInfo(nevt_, track_id[i], hit_id,
+			    x[i], y[i], z[i], time[i], edep[i],
 			    sdname.c_str());
-
-    evt_energy += hit->GetEnergyDeposit();
   }
 }
 
@@ -301,6 +444,13 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
       if (!hit) continue;
       G4double bin_size = hit->GetBinSize();
       sensdet_bin_[sdname] = bin_size;
+      if (bin_size > 0. && !hit->GetFineWindows().empty()) {
+        std::string windows;
+        for (const auto& w : hit->GetFineWindows())
+          windows += "[" + std::to_string(w.first/microsecond) + ", "
+            + std::to_string(w.second/microsecond) + ") ";
+        sensdet_fine_[sdname] = std::make_pair(hit->GetFineBinSize(), windows + "mus");
+      }
       break;
     }
   }
@@ -313,6 +463,16 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
     G4ThreeVector xyz = hit->GetPosition();
     G4double binsize = hit->GetBinSize();
 
+    // Photon-count-only sensors: a single row per sensor and event
+    if (binsize <= 0.) {
+      h5writer_->WriteSensorCountsInfo(nevt_, (unsigned int)hit->GetPmtID(),
+                                       (unsigned int)hit->GetTotalCounts());
+    }
+
+    // With fine time windows, the time bins are given in units
+    // of the fine binning, so that all bins have an integer index
+    if (!hit->GetFineWindows().empty()) binsize = hit->GetFineBinSize();
+
     const std::map<G4double, G4int>& wvfm = hit->GetHistogram();
     std::map<G4double, G4int>::const_iterator it;
     std::vector< std::pair<unsigned int,float> > data;
@@ -341,6 +501,39 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
 }
 
 
+void PersistencyManager::StoreSensorWaveforms(G4VHitsCollection* hc)
+{
+  // The collection only exists if the digitization of the SD is enabled
+  SensorWaveformsCollection* wvfs = dynamic_cast<SensorWaveformsCollection*>(hc);
+  if (!wvfs) return;
+
+  std::string sdname = wvfs->GetSDname();
+
+  for (size_t i=0; i<wvfs->entries(); i++) {
+
+    SensorWaveform* wvf = dynamic_cast<SensorWaveform*>(wvfs->GetHit(i));
+    if (!wvf) continue;
+
+    if (sensdet_bin_.find(sdname) == sensdet_bin_.end())
+      sensdet_bin_[sdname] = wvf->GetBinSize();
+
+    for (const auto& sample : wvf->GetSamples()) {
+      h5writer_->WriteSensorWaveformInfo(nevt_, (unsigned int)wvf->GetSensorID(),
+                                         (uint64_t)sample.first, (float)sample.second);
+    }
+
+    std::vector<G4int>::iterator pos_it =
+      std::find(sns_posvec_.begin(), sns_posvec_.end(), wvf->GetSensorID());
+    if (pos_it == sns_posvec_.end()) {
+      G4ThreeVector xyz = wvf->GetPosition();
+      h5writer_->WriteSensorPosInfo((unsigned int)wvf->GetSensorID(), sdname.c_str(),
+                                    (float)xyz.x(), (float)xyz.y(), (float)xyz.z());
+      sns_posvec_.push_back(wvf->GetSensorID());
+    }
+  }
+}
+
+
 void PersistencyManager::StoreSteps()
 {
   SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
@@ -393,10 +586,24 @@ G4bool PersistencyManager::Store(const G4Run*)
 
   std::map<G4String, G4double>::const_iterator it;
   for (it = sensdet_bin_.begin(); it != sensdet_bin_.end(); ++it) {
-    h5writer_->WriteRunInfo((it->first + "_binning").c_str(),
-                           (std::to_string(it->second/microsecond)+" mus").c_str());
+    if (it->second <= 0.)
+      h5writer_->WriteRunInfo((it->first + "_binning").c_str(), "photon count only");
+    else
+      h5writer_->WriteRunInfo((it->first + "_binning").c_str(),
+                              (std::to_string(it->second/microsecond)+" mus").c_str());
   }
 
+  std::map<G4String, std::pair<G4double, std::string>>::const_iterator fine_it;
+  for (fine_it = sensdet_fine_.begin(); fine_it != sensdet_fine_.end(); ++fine_it) {
+    G4String fine_binning = std::to_string(fine_it->second.first/microsecond) + " mus";
+    h5writer_->WriteRunInfo((fine_it->first + "_fine_binning").c_str(), fine_binning.c_str());
+    h5writer_->WriteRunInfo((fine_it->first + "_fine_windows").c_str(),
+                            fine_it->second.second.c_str());
+    h5writer_->WriteRunInfo((fine_it->first + "_time_bin_unit").c_str(), fine_binning.c_str());
+  }
+
+  StoreScanCounts();
+
   SaveConfigurationInfo(init_macro_);
   for (unsigned long i=0; i<macros_.size(); i++) {
     SaveConfigurationInfo(macros_[i]);
@@ -13,8 +13,10 @@
 #include "PersistencyManagerBase.h"
 
 #include <G4VPersistencyManager.hh>
+#include <G4ThreeVector.hh>
 #include <map>
 #include <vector>
+#include <cstdint>
 
 
 class G4GenericMessenger;
@@ -24,7 +26,6 @@ class G4VHitsCollection;
 
 namespace nexus {
   class HDF5Writer;
-  class IonizationHit;
 }
 
 namespace nexus {
@@ -61,9 +62,14 @@ namespace nexus {
 
   private:
     void StoreTrajectories(G4TrajectoryContainer*);
+    void StoreSubEvents(const G4Event*);
+    void StoreEventSource(const G4Event*);
+    void AccumulateScanCounts(const G4Event*);
+    void StoreScanCounts();
     void StoreHits(G4HCofThisEvent*);
     void StoreIonizationHits(G4VHitsCollection*);
     void StoreSensorHits(G4VHitsCollection*);
+    void StoreSensorWaveforms(G4VHitsCollection*);
     void StoreSteps();
 
     void SaveConfigurationInfo(G4String history);
@@ -91,13 +97,22 @@ namespace nexus {
     G4int nevt_; ///< Event ID
     G4int start_id_; ///< ID for the first event in file
     G4bool first_evt_; ///< true only for the first event of the run
+    G4bool sub_event_warned_; ///< Secondaries without sub-event label reported
 
     HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
 
-    std::map<G4int, std::vector<G4int>* > hit_map_;
+    std::map<G4int, G4int> hit_count_; ///< Number of hits per particle
     std::vector<G4int> sns_posvec_;
 
     std::map<G4String, G4double> sensdet_bin_;
+    /// Fine binning and fine time windows of the sensors using them
+    std::map<G4String, std::pair<G4double, std::string>> sensdet_fine_;
+
+    G4int scan_point_; ///< Point of the light-table scan of the event, if any
+    /// Position and number of events of every point of the scan
+    std::map<G4int, std::pair<G4ThreeVector, G4int>> scan_points_;
+    /// Photons detected by every sensor, added up per point of the scan
+    std::map<std::pair<G4int, G4int>, uint64_t> scan_counts_;
   };
 
 
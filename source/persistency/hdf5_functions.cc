@@ -33,6 +33,29 @@ hsize_t createSensorDataType()
 }
 
 
+hsize_t createSensorCountsType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_counts_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (sns_counts_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "sensor_id", HOFFSET (sns_counts_t, sensor_id), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "charge", HOFFSET (sns_counts_t, charge), H5T_NATIVE_UINT);
+  return memtype;
+}
+
+
+hsize_t createSensorWaveformType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_wvf_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (sns_wvf_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "sensor_id", HOFFSET (sns_wvf_t, sensor_id), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "time_bin", HOFFSET (sns_wvf_t, time_bin), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "amplitude", HOFFSET (sns_wvf_t, amplitude), H5T_NATIVE_FLOAT);
+  return memtype;
+}
+
+
 hsize_t createHitInfoType()
 {
   hid_t strtype = H5Tcopy(H5T_C_S1);
@@ -134,6 +157,65 @@ hsize_t createStepType()
   return memtype;
 }
 
+hsize_t createSubEventType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sub_event_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (sub_event_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "particle_id", HOFFSET (sub_event_t, particle_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "sub_event", HOFFSET (sub_event_t, sub_event), H5T_NATIVE_INT32);
+  return memtype;
+}
+
+
+hsize_t createEventSourceType()
+{
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size (strtype, STRLEN);
+
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_source_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_source_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "source", HOFFSET (event_source_t, source), strtype);
+  H5Tinsert (memtype, "weight", HOFFSET (event_source_t, weight), H5T_NATIVE_FLOAT);
+  return memtype;
+}
+
+
+hsize_t createEventPointType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_point_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_point_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "point_id", HOFFSET (event_point_t, point_id), H5T_NATIVE_INT32);
+  return memtype;
+}
+
+
+hsize_t createScanPointType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (scan_point_t));
+  H5Tinsert (memtype, "point_id", HOFFSET (scan_point_t, point_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "x", HOFFSET (scan_point_t, x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "y", HOFFSET (scan_point_t, y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "z", HOFFSET (scan_point_t, z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "events", HOFFSET (scan_point_t, events), H5T_NATIVE_UINT32);
+  return memtype;
+}
+
+
+hsize_t createScanCountsType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (scan_counts_t));
+  H5Tinsert (memtype, "point_id", HOFFSET (scan_counts_t, point_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "sensor_id", HOFFSET (scan_counts_t, sensor_id), H5T_NATIVE_UINT32);
+  H5Tinsert (memtype, "charge", HOFFSET (scan_counts_t, charge), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
+
 hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
@@ -211,6 +293,50 @@ void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t cou
   H5Sclose(memspace);
 }
 
+void writeSnsCounts(sns_counts_t* snsCounts, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+  //Create memspace for one more row
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  //Extend dataset
+  dims[0] = counter+1;
+  H5Dset_extent(dataset, dims);
+
+  //Write photon counts
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, snsCounts);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeSnsWaveform(sns_wvf_t* snsWvf, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+  //Create memspace for one more row
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  //Extend dataset
+  dims[0] = counter+1;
+  H5Dset_extent(dataset, dims);
+
+  //Write digitized samples
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, snsWvf);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
 void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter)
 {
   hid_t memspace, file_space;
@@ -292,3 +418,103 @@ void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter)
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void writeSubEvent(sub_event_t* subEvent, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, subEvent);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeEventSource(event_source_t* eventSource, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, eventSource);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeEventPoint(event_point_t* eventPoint, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, eventPoint);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeScanPoint(scan_point_t* scanPoint, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, scanPoint);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeScanCounts(scan_counts_t* scanCounts, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, scanCounts);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
@@ -27,6 +27,19 @@
     unsigned int charge;
   } sns_data_t;
 
+  typedef struct{
+    int32_t event_id;
+    unsigned int sensor_id;
+    unsigned int charge;
+  } sns_counts_t;
+
+  typedef struct{
+    int32_t event_id;
+    unsigned int sensor_id;
+    uint64_t time_bin;
+    float amplitude;
+  } sns_wvf_t;
+
   typedef struct{
         int32_t event_id;
 	float x;
@@ -91,22 +104,67 @@
     float     final_z;
   } step_info_t;
 
+  typedef struct{
+    int32_t event_id;
+    int32_t particle_id;
+    int32_t sub_event;
+  } sub_event_t;
+
+  typedef struct{
+    int32_t event_id;
+    char    source[STRLEN];
+    float   weight;
+  } event_source_t;
+
+  typedef struct{
+    int32_t event_id;
+    int32_t point_id;
+  } event_point_t;
+
+  typedef struct{
+    int32_t point_id;
+    float   x;
+    float   y;
+    float   z;
+    uint32_t events;
+  } scan_point_t;
+
+  typedef struct{
+    int32_t  point_id;
+    uint32_t sensor_id;
+    uint64_t charge;
+  } scan_counts_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
+  hsize_t createSensorCountsType();
+  hsize_t createSensorWaveformType();
   hsize_t createHitInfoType();
   hsize_t createParticleInfoType();
   hsize_t createSensorPosType();
   hsize_t createStepType();
+  hsize_t createSubEventType();
+  hsize_t createEventSourceType();
+  hsize_t createEventPointType();
+  hsize_t createScanPointType();
+  hsize_t createScanCountsType();
 
   hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
   hid_t createGroup(hid_t file, std::string& groupName);
 
   void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSnsCounts(sns_counts_t* snsCounts, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSnsWaveform(sns_wvf_t* snsWvf, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSubEvent(sub_event_t* subEvent, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeEventSource(event_source_t* eventSource, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeEventPoint(event_point_t* eventPoint, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeScanPoint(scan_point_t* scanPoint, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeScanCounts(scan_counts_t* scanCounts, hid_t dataset, hid_t memtype, hsize_t counter);
 
 
 #endif
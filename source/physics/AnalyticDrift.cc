@@ -0,0 +1,200 @@
+// ----------------------------------------------------------------------------
+// nexus | AnalyticDrift.cc
+//
+// This class drifts the ionization electrons of an energy deposition
+// analytically, without tracking them, and produces their EL light.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "AnalyticDrift.h"
+
+#include "BaseDriftField.h"
+#include "Electroluminescence.h"
+#include "ELParamSimulation.h"
+
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4ParticleChange.hh>
+#include <Randomize.hh>
+
+#include <cmath>
+
+
+namespace nexus {
+
+
+  AnalyticDrift::AnalyticDrift():
+    el_(0), el_model_(0), el_region_(0), el_field_(0), el_material_(0)
+  {
+  }
+
+
+
+  AnalyticDrift::~AnalyticDrift()
+  {
+  }
+
+
+
+  void AnalyticDrift::AddDeposit(const G4LorentzVector& xyzt, G4double weight)
+  {
+    x_.push_back(xyzt.x());
+    y_.push_back(xyzt.y());
+    z_.push_back(xyzt.z());
+    t_.push_back(xyzt.t());
+    w_.push_back(weight);
+  }
+
+
+
+  void AnalyticDrift::Clear()
+  {
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    t_.clear();
+    w_.clear();
+  }
+
+
+
+  void AnalyticDrift::FindELRegion()
+  {
+    el_region_ = G4RegionStore::GetInstance()->GetRegion("EL_REGION", false);
+    if (!el_region_) {
+      G4Exception("[AnalyticDrift]", "FindELRegion()", FatalException,
+        "The analytic drift requires a geometry with an EL_REGION.");
+    }
+
+    el_field_ = dynamic_cast<BaseDriftField*>(el_region_->GetUserInformation());
+    if (!el_field_) {
+      G4Exception("[AnalyticDrift]", "FindELRegion()", FatalException,
+        "The EL_REGION has no drift field.");
+    }
+
+    el_material_ = (*el_region_->GetRootLogicalVolumeIterator())->GetMaterial();
+  }
+
+
+
+  G4double AnalyticDrift::GetAttachment(const G4Material* mat)
+  {
+    auto it = attachment_.find(mat);
+    if (it != attachment_.end()) return it->second;
+
+    G4double attach = 0.;
+    const G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+    if (!mpt || !(mpt->ConstPropertyExists("ATTACHMENT"))) {
+      G4Exception("[AnalyticDrift]", "GetAttachment()", JustWarning,
+        ("No attachment found for material " + mat->GetName() +
+         ". Assuming no attachment.").c_str());
+    }
+    else {
+      attach = mpt->GetConstProperty("ATTACHMENT");
+    }
+
+    attachment_[mat] = attach;
+    return attach;
+  }
+
+
+
+  G4int AnalyticDrift::Process(BaseDriftField* field, const G4Material* mat,
+                               G4int parent_id, G4ParticleChange* change)
+  {
+    if (!el_region_) FindELRegion();
+
+    const size_t num_deposits = w_.size();
+    transv_spread_.assign(num_deposits, 0.);
+    time_spread_.assign(num_deposits, 0.);
+    end_.resize(num_deposits);
+    num_photons_.assign(num_deposits, 0);
+
+    // Deposits inside the EL gap start emitting light where they are
+    const G4bool in_el_gap = (field == el_field_);
+    const G4double attach = in_el_gap ? 0. : GetAttachment(mat);
+
+    G4double transv_spread, time_spread;
+
+    for (size_t i=0; i<num_deposits; ++i) {
+
+      G4LorentzVector xyzt(x_[i], y_[i], z_[i], t_[i]);
+
+      if (!in_el_gap) {
+        // The charge is lost if it doesn't move
+        if (field->DriftGroup(xyzt, w_[i], transv_spread, time_spread) <= 0.) {
+          w_[i] = 0.;
+          continue;
+        }
+
+        // Every electron survives the attachment independently
+        if (attach > 0.) {
+          G4double survival = std::exp(-(xyzt.t() - t_[i]) / attach);
+          w_[i] = CLHEP::RandBinomial::shoot(G4int(w_[i] + 0.5), survival);
+          if (w_[i] <= 0.) continue;
+        }
+
+        x_[i] = xyzt.x();
+        y_[i] = xyzt.y();
+        z_[i] = xyzt.z();
+        t_[i] = xyzt.t();
+        transv_spread_[i] = transv_spread;
+        time_spread_[i]   = time_spread;
+      }
+
+      // Drift across the EL gap. The spread gained in
+      // the gap is added to the one of the drift.
+      G4LorentzVector end(xyzt);
+      G4double gap = el_field_->DriftGroup(end, w_[i], transv_spread, time_spread);
+      if (gap <= 0.) {
+        w_[i] = 0.;
+        continue;
+      }
+
+      end_[i] = end;
+      transv_spread_[i] = std::sqrt(transv_spread_[i] * transv_spread_[i] +
+                                    transv_spread * transv_spread);
+      time_spread_[i]   = std::sqrt(time_spread_[i] * time_spread_[i] +
+                                    time_spread * time_spread);
+
+      if (!el_model_ && el_)
+        num_photons_[i] =
+          el_->SampleNumberOfPhotons(el_field_->LightYield(), gap, w_[i]);
+    }
+
+    G4int num_secondaries = 0;
+
+    if (el_model_) {
+      for (size_t i=0; i<num_deposits; ++i) {
+        if (w_[i] <= 0.) continue;
+        el_model_->GenerateLight(G4ThreeVector(x_[i], y_[i], z_[i]), t_[i], w_[i],
+                                 transv_spread_[i], time_spread_[i], el_region_);
+      }
+    }
+    else if (el_) {
+      for (size_t i=0; i<num_deposits; ++i)
+        num_secondaries += num_photons_[i];
+
+      change->SetNumberOfSecondaries(num_secondaries);
+
+      for (size_t i=0; i<num_deposits; ++i) {
+        if (num_photons_[i] == 0) continue;
+        el_->GeneratePhotons(num_photons_[i],
+                             G4LorentzVector(x_[i], y_[i], z_[i], t_[i]), end_[i],
+                             el_field_, el_material_,
+                             transv_spread_[i], time_spread_[i],
+                             parent_id, change);
+      }
+    }
+
+    Clear();
+
+    return num_secondaries;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------
+// nexus | AnalyticDrift.h
+//
+// This class drifts the ionization electrons of an energy deposition
+// analytically, without tracking them, and produces their EL light.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ANALYTIC_DRIFT_H
+#define ANALYTIC_DRIFT_H
+
+#include <G4LorentzVector.hh>
+
+#include <vector>
+#include <map>
+
+class G4Material;
+class G4Region;
+class G4ParticleChange;
+
+
+namespace nexus {
+
+  class BaseDriftField;
+  class Electroluminescence;
+  class ELParamSimulation;
+
+  /// The ionization electrons (or groups of electrons) created in a step
+  /// are stored as a compact array of deposits instead of being stacked
+  /// as G4Tracks. Each deposit is drifted with the field of its region
+  /// to the EL gap, the attachment is applied using its drift time, and
+  /// its EL light is produced right away: either the detected photons,
+  /// with the EL fast simulation, or the optical photons, which are
+  /// added as secondaries of the ionizing particle.
+  ///
+  /// The drift ends at the anode of the drift field, which must be
+  /// inside the EL gap (as in all the geometries, where the gate is
+  /// the cathode of the EL field). Charges ending elsewhere are lost.
+
+  class AnalyticDrift
+  {
+  public:
+    /// Constructor
+    AnalyticDrift();
+    /// Destructor
+    ~AnalyticDrift();
+
+    /// Set the process generating the optical EL photons
+    void SetElectroluminescence(Electroluminescence*);
+    /// Set the EL fast simulation model. If set, the detected
+    /// photons are sampled instead of the optical photons.
+    void SetELParamSimulation(ELParamSimulation*);
+
+    /// Add a deposit of 'weight' ionization electrons
+    void AddDeposit(const G4LorentzVector& xyzt, G4double weight);
+
+    /// Drift the deposits added since the last call with the given field
+    /// (the one of the region where they were created, whose material is
+    /// also given), produce their EL light and clear them. Optical photons
+    /// are added as secondaries to the particle change, whose number of
+    /// secondaries is set. Returns the number of secondaries.
+    G4int Process(BaseDriftField* field, const G4Material* mat,
+                  G4int parent_id, G4ParticleChange* change);
+
+  private:
+    /// Resolve the EL region, its field and its material
+    void FindELRegion();
+
+    /// Returns the attachment (lifetime) of the electrons in a
+    /// material, or zero if there is none
+    G4double GetAttachment(const G4Material*);
+
+    void Clear();
+
+  private:
+    Electroluminescence* el_;
+    ELParamSimulation* el_model_;
+
+    G4Region* el_region_;
+    BaseDriftField* el_field_;
+    const G4Material* el_material_;
+
+    /// Attachment of the electrons per material
+    std::map<const G4Material*, G4double> attachment_;
+
+    // Deposits, as a structure of arrays. After the drift the position
+    // and time are those of the entrance in the EL gap, and the weight
+    // is the number of electrons surviving the attachment.
+    std::vector<G4double> x_, y_, z_, t_, w_;
+    std::vector<G4double> transv_spread_, time_spread_;
+    std::vector<G4LorentzVector> end_; ///< Exit of the EL gap
+    std::vector<G4int> num_photons_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void AnalyticDrift::SetElectroluminescence(Electroluminescence* el)
+  { el_ = el; }
+
+  inline void AnalyticDrift::SetELParamSimulation(ELParamSimulation* model)
+  { el_model_ = model; }
+
+} // end namespace nexus
+
+#endif
@@ -34,6 +34,13 @@ namespace nexus {
     /// drifting under the influence of the field. Returns the step length.
     virtual G4double Drift(G4LorentzVector&) = 0;
 
+    /// Calculates the final position and time of the centroid of a group
+    /// of charge carriers of a given weight (number of carriers), and the
+    /// spread (transverse and time sigmas) of the carriers around it.
+    /// By default the group drifts as a single carrier, without spread.
+    virtual G4double DriftGroup(G4LorentzVector&, G4double weight,
+                                G4double& transv_spread, G4double& time_spread);
+
     /// Returns a random 4D point (space and time) along a drift line
     virtual G4LorentzVector 
       GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&) = 0;
@@ -52,6 +59,14 @@ namespace nexus {
 
   inline G4double BaseDriftField::LightYield() const {return 0.;}
 
+  inline G4double BaseDriftField::DriftGroup(G4LorentzVector& xyzt, G4double,
+                                             G4double& transv_spread,
+                                             G4double& time_spread)
+  {
+    transv_spread = time_spread = 0.;
+    return Drift(xyzt);
+  }
+
   inline void BaseDriftField::Print() const {}
 
 } // end namespace nexus
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | DriftFieldCache.h
+//
+// This class caches the drift fields attached to the regions.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DRIFT_FIELD_CACHE_H
+#define DRIFT_FIELD_CACHE_H
+
+#include "BaseDriftField.h"
+
+#include <G4Region.hh>
+
+#include <vector>
+#include <utility>
+
+
+namespace nexus {
+
+  /// The drift field of a region is stored as its user information,
+  /// which must be cast to BaseDriftField. This class does the cast once
+  /// per region and keeps the result, so that the processes asking for
+  /// the field at every step do a pointer comparison instead. The last
+  /// region found is remembered, since consecutive steps of a charge
+  /// are usually in the same region.
+
+  class DriftFieldCache
+  {
+  public:
+    /// Constructor
+    DriftFieldCache();
+    /// Destructor
+    ~DriftFieldCache();
+
+    /// Returns the drift field of a region, or null if it has none
+    BaseDriftField* GetField(const G4Region*);
+
+    /// Forget the cached fields (e.g. if the geometry has changed)
+    void Clear();
+
+  private:
+    std::vector<std::pair<const G4Region*, BaseDriftField*>> fields_;
+
+    const G4Region* last_region_;
+    BaseDriftField* last_field_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline DriftFieldCache::DriftFieldCache():
+    last_region_(0), last_field_(0) {}
+
+  inline DriftFieldCache::~DriftFieldCache() {}
+
+  inline BaseDriftField* DriftFieldCache::GetField(const G4Region* region)
+  {
+    if (region == last_region_) return last_field_;
+
+    last_region_ = region;
+
+    for (const auto& entry : fields_) {
+      if (entry.first == region) {
+        last_field_ = entry.second;
+        return last_field_;
+      }
+    }
+
+    last_field_ = dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    fields_.push_back(std::make_pair(region, last_field_));
+    return last_field_;
+  }
+
+  inline void DriftFieldCache::Clear()
+  {
+    fields_.clear();
+    last_region_ = 0;
+    last_field_ = 0;
+  }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------
+// nexus | DriftFieldMap.cc
+//
+// This class describes a map of the drift parameters of the ionization
+// electrons (drift velocity, diffusion and displacement) on a grid.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "DriftFieldMap.h"
+
+#include <G4SystemOfUnits.hh>
+
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+
+
+namespace nexus {
+
+
+  namespace {
+
+    const char DRIFT_MAP_MAGIC[8] = {'N','X','D','R','I','F','T','\0'};
+
+    const uint32_t NUM_VALUES = 5;
+
+    struct DriftMapHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t dimensions;
+      double   min[3];
+      double   step[3];
+      uint32_t bins[3];
+      uint32_t num_values;
+    };
+
+  }
+
+
+
+  DriftFieldMap::DriftFieldMap(const G4String& filename):
+    dimensions_(0)
+  {
+    for (G4int i=0; i<3; ++i) {
+      min_[i] = step_[i] = 0.;
+      bins_[i] = 0;
+    }
+
+    ReadFile(filename);
+  }
+
+
+
+  DriftFieldMap::~DriftFieldMap()
+  {
+  }
+
+
+
+  void DriftFieldMap::ReadFile(const G4String& filename)
+  {
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) {
+      G4Exception("[DriftFieldMap]", "ReadFile()", FatalException,
+                  ("Cannot open drift field map " + filename).c_str());
+    }
+
+    DriftMapHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file || std::memcmp(header.magic, DRIFT_MAP_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != 1 || header.num_values != NUM_VALUES ||
+        (header.dimensions != 2 && header.dimensions != 3)) {
+      G4Exception("[DriftFieldMap]", "ReadFile()", FatalException,
+                  ("Wrong header in drift field map " + filename).c_str());
+    }
+
+    dimensions_ = header.dimensions;
+
+    size_t num_nodes = 1;
+    for (G4int i=0; i<3; ++i) {
+      min_[i]  = header.min[i];
+      step_[i] = header.step[i];
+      bins_[i] = header.bins[i];
+      num_nodes *= bins_[i];
+
+      if (bins_[i] < 1 || (bins_[i] > 1 && step_[i] <= 0.)) {
+        G4Exception("[DriftFieldMap]", "ReadFile()", FatalException,
+                    ("Wrong grid in drift field map " + filename).c_str());
+      }
+    }
+
+    if (dimensions_ == 2 && bins_[2] != 1) {
+      G4Exception("[DriftFieldMap]", "ReadFile()", FatalException,
+                  ("2D drift field map " + filename +
+                   " with nodes in the third axis").c_str());
+    }
+
+    values_.resize(num_nodes * NUM_VALUES);
+    file.read(reinterpret_cast<char*>(values_.data()),
+              values_.size() * sizeof(float));
+
+    if (!file) {
+      G4Exception("[DriftFieldMap]", "ReadFile()", FatalException,
+                  ("Drift field map " + filename + " is truncated").c_str());
+    }
+  }
+
+
+
+  DriftParameters DriftFieldMap::Interpolate(const G4ThreeVector& pos) const
+  {
+    G4double coords[3];
+    if (IsRadial()) {
+      coords[0] = pos.perp();
+      coords[1] = pos.z();
+      coords[2] = 0.;
+    }
+    else {
+      coords[0] = pos.x();
+      coords[1] = pos.y();
+      coords[2] = pos.z();
+    }
+
+    // Lower node of the grid cell and position in the cell, clamped
+    // to the grid (axes with a single node are constant)
+    G4int first[3];
+    G4double frac[3];
+    for (G4int i=0; i<3; ++i) {
+      G4double u = (bins_[i] > 1) ? (coords[i] - min_[i]) / step_[i] : 0.;
+      u = std::max(0., std::min(u, bins_[i] - 1.));
+      first[i] = std::min(G4int(u), std::max(bins_[i] - 2, 0));
+      frac[i]  = u - first[i];
+    }
+
+    G4double result[NUM_VALUES] = {0., 0., 0., 0., 0.};
+
+    // Weighted sum over the corners of the cell
+    for (G4int corner=0; corner<8; ++corner) {
+      G4int index[3];
+      G4double weight = 1.;
+      for (G4int i=0; i<3; ++i) {
+        G4int upper = (corner >> i) & 1;
+        index[i] = first[i] + upper;
+        weight *= upper ? frac[i] : 1. - frac[i];
+      }
+      if (weight <= 0.) continue;
+
+      size_t node = (size_t(index[0]) * bins_[1] + index[1]) * bins_[2] + index[2];
+      const float* values = &values_[node * NUM_VALUES];
+      for (uint32_t j=0; j<NUM_VALUES; ++j)
+        result[j] += weight * values[j];
+    }
+
+    DriftParameters params;
+    params.drift_velocity = result[0];
+    params.longit_diff    = result[1];
+    params.transv_diff    = result[2];
+
+    if (IsRadial()) {
+      G4double r = pos.perp();
+      params.dx = (r > 0.) ? result[3] * pos.x() / r : 0.;
+      params.dy = (r > 0.) ? result[3] * pos.y() / r : 0.;
+    }
+    else {
+      params.dx = result[3];
+      params.dy = result[4];
+    }
+
+    return params;
+  }
+
+
+
+  void DriftFieldMap::Print() const
+  {
+    G4cout << "Drift field map: " << dimensions_ << "D grid of "
+           << bins_[0] << " x " << bins_[1];
+    if (dimensions_ == 3) G4cout << " x " << bins_[2];
+    G4cout << " nodes, steps of " << step_[0]/mm << ", " << step_[1]/mm;
+    if (dimensions_ == 3) G4cout << ", " << step_[2]/mm;
+    G4cout << " mm." << G4endl;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------------
+// nexus | DriftFieldMap.h
+//
+// This class describes a map of the drift parameters of the ionization
+// electrons (drift velocity, diffusion and displacement) on a grid.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DRIFT_FIELD_MAP_H
+#define DRIFT_FIELD_MAP_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  /// Drift parameters at a point, interpolated from the map
+  struct DriftParameters
+  {
+    G4double drift_velocity; ///< Drift velocity
+    G4double longit_diff;    ///< Longitudinal diffusion (per sqrt of length)
+    G4double transv_diff;    ///< Transverse diffusion (per sqrt of length)
+    G4double dx;             ///< Displacement in x of the drift endpoint
+    G4double dy;             ///< Displacement in y of the drift endpoint
+  };
+
+
+  /// The map is defined on a regular grid, either 2D in (r, z) for
+  /// fields with cylindrical symmetry or 3D in (x, y, z). Every node
+  /// stores the drift velocity and the longitudinal and transverse
+  /// diffusion at the node, and the displacement (x, y) of the endpoint
+  /// of the drift of an electron starting at the node with respect to
+  /// the straight drift line; in 2D maps the displacement is radial and
+  /// only its first component is used. Values are interpolated linearly
+  /// in every axis (trilinear interpolation) and taken from the closest
+  /// node outside the grid.
+  ///
+  /// Maps are read from the binary format produced by
+  /// scripts/make_drift_field_map.py. The layout (little endian) is:
+  ///   header: char magic[8] = "NXDRIFT", uint32 version, uint32 number
+  ///     of dimensions (2 or 3), float64 minimum[3], float64 step[3],
+  ///     uint32 number of nodes[3], uint32 number of values per node (5)
+  ///   float32 values[number of nodes * 5]: velocity, longitudinal
+  ///     diffusion, transverse diffusion, dx (dr in 2D), dy (unused in 2D)
+  /// with the nodes in x-major (r-major) order. In 2D maps the axes are
+  /// (r, z, -) and the third number of nodes is 1. All values are given
+  /// in the nexus internal units (mm, ns).
+
+  class DriftFieldMap
+  {
+  public:
+    /// Constructor
+    DriftFieldMap(const G4String& filename);
+    /// Destructor
+    ~DriftFieldMap();
+
+    /// Returns the drift parameters at a point
+    DriftParameters Interpolate(const G4ThreeVector&) const;
+
+    /// Returns true for 2D maps in (r, z)
+    G4bool IsRadial() const;
+
+    void Print() const;
+
+  private:
+    void ReadFile(const G4String&);
+
+  private:
+    G4int dimensions_;    ///< Number of dimensions of the grid (2 or 3)
+    G4double min_[3];     ///< Position of the first node in every axis
+    G4double step_[3];    ///< Distance between nodes in every axis
+    G4int bins_[3];       ///< Number of nodes in every axis
+
+    std::vector<float> values_; ///< Values of the nodes
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool DriftFieldMap::IsRadial() const { return dimensions_ == 2; }
+
+} // end namespace nexus
+
+#endif
@@ -8,14 +8,34 @@
 
 #include "ELLookupTable.h"
 
+#include <G4UIcommand.hh>
+#include <G4SystemOfUnits.hh>
+
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <set>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 
 namespace nexus {
 
 
-  ELLookupTable::ELLookupTable(G4String filename)
+  ELLookupTable::ELLookupTable(G4String filename):
+    G4VUserRegionInformation(),
+    // Default geometry of the tables produced before the header
+    // included it: 5-mm pitch grid in a circle of 92.5 mm
+    radius_(92.5*mm), pitch_(5.*mm), num_time_bins_(5), time_bin_width_(0.),
+    num_cells_(0), grid_min_(0.), num_points_(0),
+    point_offsets_(0), sensor_ids_(0), values_(0), half_values_(0),
+    mapped_(0), mapped_size_(0)
   {
     // read the text files and store their content in the transient table
     ReadFiles(filename);
@@ -25,6 +45,119 @@ namespace nexus {
 
   ELLookupTable::~ELLookupTable()
   {
+    if (mapped_) munmap(mapped_, mapped_size_);
+  }
+
+
+
+  namespace {
+
+    const char EL_TABLE_MAGIC[8] = {'N','X','E','L','T','A','B','\0'};
+
+    struct ELTableHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t value_type; // 0 = float32, 1 = float16
+      double   radius;
+      double   pitch;
+      double   time_bin_width;
+      uint32_t num_time_bins;
+      uint32_t num_cells;
+      uint64_t num_points;
+      uint64_t num_entries;
+      uint32_t num_sensors;
+      uint32_t padding;
+    };
+
+  }
+
+
+
+  void ELLookupTable::ReadHeader(std::ifstream& file)
+  {
+    // Header lines start with '*'. Lines of the form
+    // "* <key> <value> [<unit>]" define the table geometry,
+    // any other header line is taken as a comment.
+    G4String line;
+    while (file.peek() == '*') {
+      std::getline(file, line);
+      std::istringstream iss(line.substr(1));
+
+      G4String key, unit;
+      G4double value;
+      if (!(iss >> key >> value)) continue;
+      G4double scale = (iss >> unit) ? G4UIcommand::ValueOf(unit) : 1.;
+
+      if      (key == "radius")         radius_ = value * scale;
+      else if (key == "pitch")          pitch_  = value * scale;
+      else if (key == "time_bins")      num_time_bins_  = size_t(value);
+      else if (key == "time_bin_width") time_bin_width_ = value * scale;
+    }
+
+    if (radius_ <= 0. || pitch_ <= 0. || num_time_bins_ == 0) {
+      G4Exception("[ELLookupTable]", "ReadHeader()", FatalException,
+                  "Wrong radius, pitch or number of time bins in the table header.");
+    }
+  }
+
+
+
+  void ELLookupTable::BuildGrid()
+  {
+    num_cells_ = G4int(2.*radius_/pitch_ + 1.);
+    grid_min_  = -pitch_ * num_cells_/2.;
+
+    std::vector<G4double> centers(num_cells_);
+    for (G4int i=0; i<num_cells_; ++i)
+      centers[i] = grid_min_ + pitch_/2. + i*pitch_;
+
+    // Number the points of the table: the cells whose
+    // centers are inside the circle
+    G4double max_r2 = radius_*radius_ * (1. + 1.e-9);
+    cell_point_.assign(num_cells_*num_cells_, -1);
+    num_points_ = 0;
+    for (G4int ix=0; ix<num_cells_; ++ix)
+      for (G4int iy=0; iy<num_cells_; ++iy)
+        if (centers[ix]*centers[ix] + centers[iy]*centers[iy] <= max_r2)
+          cell_point_[ix*num_cells_ + iy] = num_points_++;
+
+    if (num_points_ == 0) {
+      G4Exception("[ELLookupTable]", "BuildGrid()", FatalException,
+                  "The light table grid has no points.");
+    }
+
+    // Assign the cells outside the circle to their nearest point.
+    // This is searched around the projection of the cell on the
+    // circle, which is always very close to the nearest point.
+    std::vector<G4int> nearest(cell_point_);
+
+    for (G4int ix=0; ix<num_cells_; ++ix) {
+      for (G4int iy=0; iy<num_cells_; ++iy) {
+        if (cell_point_[ix*num_cells_ + iy] >= 0) continue;
+
+        G4double x = centers[ix], y = centers[iy];
+        G4double scale = radius_ / std::max(std::hypot(x, y), 1.e-9);
+        G4int cx = G4int(std::floor((x*scale - grid_min_)/pitch_));
+        G4int cy = G4int(std::floor((y*scale - grid_min_)/pitch_));
+
+        G4double min_dist = -1.;
+        for (G4int range=2; min_dist < 0.; range *= 2) {
+          for (G4int jx=std::max(0, cx-range); jx<=std::min(num_cells_-1, cx+range); ++jx) {
+            for (G4int jy=std::max(0, cy-range); jy<=std::min(num_cells_-1, cy+range); ++jy) {
+              G4int point = cell_point_[jx*num_cells_ + jy];
+              if (point < 0) continue;
+              G4double dist = (jx-ix)*(jx-ix) + (jy-iy)*(jy-iy);
+              if (min_dist < 0. || dist < min_dist) {
+                min_dist = dist;
+                nearest[ix*num_cells_ + iy] = point;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    cell_point_ = nearest;
   }
 
 
@@ -32,178 +165,195 @@ namespace nexus {
   void ELLookupTable::ReadFiles(G4String filename)
   {
     // Open the file containing the light table
-    std::ifstream file(filename, std::ifstream::out);
+    std::ifstream file(filename, std::ios::binary);
 
-    if (!file.is_open())
-      {}
-      //G4Exception("[ELLookupTable] ERROR: cannot open input file!");
+    if (!file.is_open()) {
+      G4Exception("[ELLookupTable]", "ReadFiles()", FatalException,
+                  ("Cannot open light table " + filename).c_str());
+    }
 
-    // Deal with the header file
-    G4String line;
+    // Binary tables are identified by their magic string
+    char magic[8] = {0};
+    file.read(magic, sizeof(magic));
+    file.close();
 
-    do {
-      getline(file, line);
-    } while(line[0] == '*');
+    if (std::memcmp(magic, EL_TABLE_MAGIC, sizeof(magic)) == 0)
+      MapBinaryFile(filename);
+    else
+      ReadTextFile(filename);
+  }
 
-    // Read file and store content in the transient table
 
-    int num_bins = 5;
-    int last_point_id = 0;
-    std::map<int, std::vector<double> > sensor_map;
 
-    while (!file.eof()) {
+  void ELLookupTable::ReadTextFile(const G4String& filename)
+  {
+    std::ifstream file(filename);
 
-      G4int point_id, sensor_id;
-      std::vector<double> probs;
+    ReadHeader(file);
+    BuildGrid();
 
-      file >> point_id >> sensor_id;
+    // Rows are "<point id> <sensor id> <value per time bin>",
+    // sorted by point id
+    offsets_storage_.assign(1, 0);
+    ids_storage_.clear();
+    values_storage_.clear();
 
-      for (G4int i=0; i<num_bins; i++) {
-	G4double prob;
-	file >> prob;
-	probs.push_back(prob);
+    G4int point_id, sensor_id;
+    while (file >> point_id >> sensor_id) {
+
+      G4int current = offsets_storage_.size() - 1;
+      if (point_id < current || point_id >= G4int(num_points_)) {
+        G4Exception("[ELLookupTable]", "ReadTextFile()", FatalException,
+                    ("Wrong point id " + std::to_string(point_id) +
+                     " in light table " + filename).c_str());
       }
 
-      sensor_map.insert(std::make_pair(sensor_id, probs));
+      for (; current < point_id; ++current)
+        offsets_storage_.push_back(ids_storage_.size());
 
-      if (point_id != last_point_id) {
-	ELtable_.push_back(sensor_map);
+      ids_storage_.push_back(sensor_id);
+      for (size_t i=0; i<num_time_bins_; ++i) {
+        G4double value;
+        file >> value;
+        values_storage_.push_back(value);
       }
-
-      last_point_id = point_id;
     }
+
+    // Points without entries at the end of the table
+    while (offsets_storage_.size() < num_points_ + 1)
+      offsets_storage_.push_back(ids_storage_.size());
+
+    std::set<G4int> sensors(ids_storage_.begin(), ids_storage_.end());
+    sensors_.assign(sensors.begin(), sensors.end());
+
+    point_offsets_ = offsets_storage_.data();
+    sensor_ids_    = ids_storage_.data();
+    values_        = values_storage_.data();
+    half_values_   = 0;
   }
 
 
 
-  const std::map<int, std::vector<double> >&
-  ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos)
+  void ELLookupTable::MapBinaryFile(const G4String& filename)
   {
-    /// The EL points must be in the middle of the bins.
-    double radius = 92.5; // mm
-    double binning = 5.; // mm
-    int maxidx = radius*2./binning + 1;
-    /// If the number of bins per axis is odd, a different math must be applied
-    bool even = false;
-    if ((maxidx/2.-floor(maxidx/2.)) == 0.){
-      even = true;
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Cannot open light table " + filename).c_str());
     }
-    std::vector<double> bincenters;
-    std::vector<int> content;
-    /// Fill a vector with the coordinates of the center of bins (they are the same in
-    /// x and y, because it is a regular squared grid)
-    for (int i=0; i<maxidx; i++){
-      double bincenter = -binning*(maxidx/2.) + binning/2.+ i*binning;
-      bincenters.push_back(bincenter);
+
+    // Read-only shared mapping: the pages of the table are
+    // loaded on demand and shared by all the processes using it
+    mapped_size_ = st.st_size;
+    if (mapped_size_ < sizeof(ELTableHeader)) {
+      close(fd);
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Light table " + filename + " is truncated.").c_str());
     }
-    /// For every coordinate in x, a column is built with a number of bins equal
-    /// to the number of EL points which have that x. Remember that only the points
-    /// which falls inside a circle of a fixed radius are taken into account,
-    /// so columns have not all the same number of points
-
-    /// Content of elements for every column in the grid
-    std::vector<int> columns;
-    if (even){
-      for (int i=0; i<maxidx; i++){
-	double y = sqrt(radius*radius - bincenters[i]*bincenters[i]);
-	double col = 0;
-	///If the y coord of the circle falls further than the center of the bin,
-	///that bin is included, otherwise it isn't.
-	if ((y/binning) - floor(y/binning)<0.5){
-	  col = floor(y/binning)*2.;
-	} else {
-	  col = ceil(y/binning)*2.;
-	}
-	columns.push_back(col);
-      }
-    } else {
-      columns.push_back(0);
-      for (int i=1; i<maxidx-1; i++){
-	double y = sqrt(radius*radius - bincenters[i]*bincenters[i]);
-	double col = 0;
-	///If the y coord of the circle falls further than the center of the bin,
-	///that bin is included, otherwise it isn't.
-	if ((y-binning/2.)/binning - floor((y-binning/2.)/binning)<0.5){
-	  col = floor((y-binning/2.)/binning)*2.+1;
-	} else {
-	  if (y < radius){
-	    col = ceil((y-binning/2.)/binning)*2.+1;
-	  } else {
-	    col = ceil((y-binning/2.)/binning)*2.-1;
-	  }
-	}
-	columns.push_back(col);
-      }
-      columns.push_back(0);
+
+    mapped_ = mmap(0, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped_ == MAP_FAILED) {
+      mapped_ = 0;
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Cannot map light table " + filename).c_str());
     }
 
-    for (unsigned int i=0; i<columns.size(); i++){
-      content.push_back(columns[i]);
+    const char* data = static_cast<const char*>(mapped_);
+    ELTableHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.version != 1 || header.value_type > 1) {
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Unknown version or value type of light table " + filename).c_str());
     }
 
-    int id;
-
-    /// Maths to obtain the right ID number of the points
-    int zero = maxidx/2;
-    int binX = zero + ceil(hitpos[0]/5.);
-    int binY = zero + ceil(hitpos[1]/5.);
-    if (!even) {
-      zero = floor(maxidx/2)+1;
-      if (hitpos[0]/binning-floor(hitpos[0]/binning) >= 0.5){
-	binX = zero + ceil(hitpos[0]/binning);
-      } else {
-	binX = zero + floor(hitpos[0]/binning);
-      }
-      if (hitpos[1]/binning-floor(hitpos[1]/binning) >= 0.5){
-	binY = zero + ceil(hitpos[1]/binning);
-      } else {
-	binY = zero + floor(hitpos[1]/binning);
-      }
+    radius_         = header.radius * mm;
+    pitch_          = header.pitch  * mm;
+    time_bin_width_ = header.time_bin_width * ns;
+    num_time_bins_  = header.num_time_bins;
+
+    BuildGrid();
+
+    if (G4int(header.num_cells) != num_cells_ || header.num_points != num_points_) {
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("The grid of light table " + filename +
+                   " does not match its radius and pitch.").c_str());
     }
-    // "binX-1" is due to the fact that content is a vector (starting from 0),
-    // while binX and binY starts from 1
-
-    // number of empty bins starting from below
-    int base = (maxidx - content[binX-1])/2;
-
-    // Check if the point is in a bin which does not correspond to any
-    // EL point. In this case the closest bin is chosen.
-    if (binY > base + content[binX-1] || binY < base+1){
-      double centerX = bincenters[binX-1];
-      double centerY = bincenters[binY-1];
-      double min_dist = 1.E6;
-      int min_xbin = 100;
-      int min_ybin = 100;
-      for (int i=0; i<maxidx; i++){
-	double x = bincenters[i];
-	for (int j=0; j<maxidx; j++){
-	  double y = bincenters[j];
-	  int bx = zero + ceil(x/5.);
-	  int by = zero + ceil(y/5.);
-	  int ped = (maxidx - content[bx-1])/2;;
-	  if (!(by > ped + content[bx-1] || by < ped+1)){
-	    double dist = sqrt(pow(centerX-x,2)+pow(centerY-y,2));
-	    if (dist < min_dist){
-	      min_dist = dist;
-	      min_xbin = bx;
-	      min_ybin = by;
-	    }
-	  }
-	}
-      }
-      binX = min_xbin;
-      binY = min_ybin;
-      base = (maxidx - content[binX-1])/2;
+
+    // Sections of the file, aligned to 8 bytes
+    size_t offset = sizeof(header);
+    const int32_t* sensors = reinterpret_cast<const int32_t*>(data + offset);
+    offset += (header.num_sensors * sizeof(int32_t) + 7) / 8 * 8;
+
+    point_offsets_ = reinterpret_cast<const uint64_t*>(data + offset);
+    offset += (header.num_points + 1) * sizeof(uint64_t);
+
+    sensor_ids_ = reinterpret_cast<const int32_t*>(data + offset);
+    offset += header.num_entries * sizeof(int32_t);
+
+    size_t value_size = (header.value_type == 0) ? sizeof(float) : sizeof(uint16_t);
+    size_t values_end = offset + header.num_entries * num_time_bins_ * value_size;
+
+    if (values_end > mapped_size_) {
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Light table " + filename + " is truncated.").c_str());
     }
 
-    int sum = 0;
-    for (int i=0; i<binX-1; i++){
-      sum = sum + content[i];
+    // The entries of every point are read through its offsets,
+    // which must be a non-decreasing partition of the entries
+    G4bool valid_offsets = (point_offsets_[0] == 0 &&
+                            point_offsets_[num_points_] == header.num_entries);
+    for (size_t i=0; valid_offsets && i<num_points_; ++i)
+      valid_offsets = (point_offsets_[i] <= point_offsets_[i+1]);
+
+    if (!valid_offsets) {
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException,
+                  ("Light table " + filename + " is corrupt: wrong point offsets.").c_str());
     }
-    // The "-1" comes because the EL point IDs start from 0
-    id = sum + binY - base - 1;
 
-    return ELtable_[id];
+    if (header.value_type == 0) {
+      values_      = reinterpret_cast<const float*>(data + offset);
+      half_values_ = 0;
+    } else {
+      values_      = 0;
+      half_values_ = reinterpret_cast<const uint16_t*>(data + offset);
+    }
+
+    sensors_.assign(sensors, sensors + header.num_sensors);
+  }
+
+
+
+  ELSensorEntries ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos) const
+  {
+    G4int ix = G4int(std::floor((hitpos.x() - grid_min_)/pitch_));
+    G4int iy = G4int(std::floor((hitpos.y() - grid_min_)/pitch_));
+    ix = std::min(std::max(ix, 0), num_cells_-1);
+    iy = std::min(std::max(iy, 0), num_cells_-1);
+
+    G4int point = cell_point_[ix*num_cells_ + iy];
+
+    uint64_t first = point_offsets_[point];
+    uint64_t last  = point_offsets_[point+1];
+
+    return ELSensorEntries(last - first, num_time_bins_,
+                           sensor_ids_ + first,
+                           values_ ? values_ + first*num_time_bins_ : 0,
+                           half_values_ ? half_values_ + first*num_time_bins_ : 0);
+  }
+
+
+
+  void ELLookupTable::Print() const
+  {
+    G4cout << "EL light table: " << num_points_ << " points, radius "
+           << radius_/mm << " mm, pitch " << pitch_/mm << " mm, "
+           << num_time_bins_ << " time bins of " << time_bin_width_/ns
+           << " ns, " << point_offsets_[num_points_] << " entries"
+           << (half_values_ ? " (half precision)." : ".") << G4endl;
   }
 
 
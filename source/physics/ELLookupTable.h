@@ -14,11 +14,72 @@
 #include <globals.hh>
 
 #include <vector>
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
 
 
 namespace nexus {
 
+  /// Light-table entries of a point of the EL gap: sensors that
+  /// detect light and their probability of detecting an EL photon
+  /// emitted from the point in every time bin. It points to memory
+  /// owned by the ELLookupTable.
+
+  class ELSensorEntries
+  {
+  public:
+    /// Constructor for values stored in single (values) or half
+    /// precision (half_values); only one of them is used.
+    ELSensorEntries(size_t num_sensors, size_t num_time_bins,
+                    const int32_t* sensor_ids, const float* values,
+                    const uint16_t* half_values=0);
+
+    /// Returns the number of sensors that detect light from the point
+    size_t GetNumSensors() const;
+    /// Returns the number of time bins of the table
+    size_t GetNumTimeBins() const;
+    /// Returns the id of the i-th sensor
+    G4int GetSensorID(size_t i) const;
+    /// Returns the value of the i-th sensor in a given time bin
+    G4double GetValue(size_t i, size_t time_bin) const;
+
+    /// Converts an IEEE 754 half-precision number to single precision
+    static float HalfToFloat(uint16_t);
+
+  private:
+    size_t num_sensors_;
+    size_t num_time_bins_;
+    const int32_t* sensor_ids_;
+    const float* values_;
+    const uint16_t* half_values_;
+  };
+
+
+  /// The table is defined on a regular (x, y) grid of points inside
+  /// a circle. Points are numbered column by column (increasing x),
+  /// and by increasing y within a column, only counting the points
+  /// whose centers are inside the circle. The radius of the circle,
+  /// the grid pitch and the time binning are read from the header
+  /// of the table. Every cell of the grid (including those outside
+  /// the circle) is assigned at load time to its nearest point,
+  /// so that finding the entries of a position is a direct lookup.
+  ///
+  /// Tables can be given in text format or in the binary format
+  /// produced by scripts/convert_el_table.py, which is memory-mapped
+  /// (read-only and shared, so that concurrent jobs on the same node
+  /// share the pages) and can store the values in half precision.
+  /// The binary layout (little endian) is:
+  ///   header: char magic[8] = "NXELTAB", uint32 version, uint32 value
+  ///     type (0 = float32, 1 = float16), float64 radius [mm], float64
+  ///     pitch [mm], float64 time bin width [ns], uint32 number of time
+  ///     bins, uint32 number of cells per axis, uint64 number of points,
+  ///     uint64 number of entries, uint32 number of sensors, uint32 pad
+  ///   int32 sensor ids[number of sensors], padded to 8 bytes
+  ///   uint64 point offsets[number of points + 1]
+  ///   int32 sensor id of every entry[number of entries]
+  ///   values[number of entries * number of time bins]
+
   class ELLookupTable: public G4VUserRegionInformation
   {
   public:
@@ -30,17 +91,116 @@ namespace nexus {
     /// Read input files and store their content in the transient table
     void ReadFiles(G4String);
 
-    /// Returns the appropiate sensor map for a given point in the EL gap
-    virtual const std::map<int, std::vector<double> >&
-    GetSensorsMap(const G4ThreeVector&);
+    /// Returns the light-table entries for a given point in the EL gap
+    ELSensorEntries GetSensorsMap(const G4ThreeVector&) const;
 
+    /// Returns the number of points of the table
+    size_t GetNumPoints() const;
+    /// Returns the number of time bins of the table
+    size_t GetNumTimeBins() const;
+    /// Returns the width of the time bins
+    G4double GetTimeBinWidth() const;
+    /// Returns the ids of the sensors present in the table
+    const std::vector<G4int>& GetSensorIDs() const;
+
+    void Print() const;
+
+  private:
+    /// Read a table in text format
+    void ReadTextFile(const G4String&);
+    /// Map a table in binary format
+    void MapBinaryFile(const G4String&);
+    /// Read the table header (lines starting with '*')
+    void ReadHeader(std::ifstream&);
+    /// Compute the points of the grid and the cell -> point map
+    void BuildGrid();
 
   private:
+    G4double radius_;  ///< Radius of the tabulated region
+    G4double pitch_;   ///< Distance between grid points
+    size_t num_time_bins_;     ///< Number of time bins per sensor
+    G4double time_bin_width_;  ///< Width of the time bins
 
-    std::vector<std::map<int, std::vector<double> > > ELtable_;
+    G4int num_cells_;  ///< Number of grid cells per axis
+    G4double grid_min_; ///< Lower edge of the grid (same in x and y)
 
+    /// Point assigned to every cell of the grid (x-major order)
+    std::vector<G4int> cell_point_;
+    /// Number of points of the table (grid cells inside the circle)
+    size_t num_points_;
+
+    std::vector<G4int> sensors_; ///< Ids of the sensors in the table
+
+    /// Entries of point i are [point_offsets_[i], point_offsets_[i+1])
+    const uint64_t* point_offsets_;
+    const int32_t* sensor_ids_; ///< Sensor id of every entry
+    /// num_time_bins_ values per entry, in single or half precision
+    const float* values_;
+    const uint16_t* half_values_;
+
+    // Storage of the tables read from text files
+    std::vector<uint64_t> offsets_storage_;
+    std::vector<int32_t> ids_storage_;
+    std::vector<float> values_storage_;
+
+    void* mapped_;       ///< Memory-mapped binary file
+    size_t mapped_size_; ///< Size of the memory-mapped file
   };
 
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline ELSensorEntries::ELSensorEntries(size_t num_sensors, size_t num_time_bins,
+                                          const int32_t* sensor_ids,
+                                          const float* values,
+                                          const uint16_t* half_values):
+    num_sensors_(num_sensors), num_time_bins_(num_time_bins),
+    sensor_ids_(sensor_ids), values_(values), half_values_(half_values)
+  {}
+
+  inline size_t ELSensorEntries::GetNumSensors() const { return num_sensors_; }
+  inline size_t ELSensorEntries::GetNumTimeBins() const { return num_time_bins_; }
+  inline G4int ELSensorEntries::GetSensorID(size_t i) const
+  { return sensor_ids_[i]; }
+  inline G4double ELSensorEntries::GetValue(size_t i, size_t time_bin) const
+  {
+    if (values_) return values_[i*num_time_bins_ + time_bin];
+    return HalfToFloat(half_values_[i*num_time_bins_ + time_bin]);
+  }
+
+  inline float ELSensorEntries::HalfToFloat(uint16_t half)
+  {
+    uint32_t sign = uint32_t(half & 0x8000) << 16;
+    uint32_t exp  = (half >> 10) & 0x1f;
+    uint32_t mant = half & 0x3ff;
+    uint32_t bits;
+
+    if (exp == 0) {
+      if (mant == 0) {
+        bits = sign;
+      } else {
+        // Subnormal half: normalize it
+        exp = 127 - 15 + 1;
+        while (!(mant & 0x400)) { mant <<= 1; --exp; }
+        bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+      }
+    } else if (exp == 31) {
+      bits = sign | 0x7f800000 | (mant << 13);
+    } else {
+      bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  inline size_t ELLookupTable::GetNumPoints() const { return num_points_; }
+  inline size_t ELLookupTable::GetNumTimeBins() const { return num_time_bins_; }
+  inline G4double ELLookupTable::GetTimeBinWidth() const { return time_bin_width_; }
+  inline const std::vector<G4int>& ELLookupTable::GetSensorIDs() const
+  { return sensors_; }
+
 } // end namespace nexus
 
 #endif
@@ -1,7 +1,9 @@
 // ----------------------------------------------------------------------------
 // nexus | ELParamSimulation.cc
 //
-// This class (WIP) implements a parametrized simulation .
+// This class implements a parametrized simulation of the EL light:
+// ionization electrons reaching the EL region are replaced by the photons
+// detected by the sensors, sampled from a light table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -10,35 +12,36 @@
 
 #include "ELLookupTable.h"
 #include "IonizationElectron.h"
+#include "UniformElectricDriftField.h"
+#include "IonizationGroupInformation.h"
+#include "SensorSD.h"
 
-#include <G4RunManager.hh>
+#include <G4Poisson.hh>
+#include <Randomize.hh>
 
-#include <TRandom2.h>
-#include <TVector3.h>
+#include <algorithm>
+#include <cmath>
 
 
 
 namespace nexus {
 
 
-  ELParamSimulation::ELParamSimulation(G4Region* region):
+  ELParamSimulation::ELParamSimulation(G4Region* region, ELLookupTable* table):
     G4VFastSimulationModel("ELParamSimulation", region),
-    table_(0)
+    table_(table), photons_per_electron_(0.)
   {
-    // check whether the region has an EL look-up table attached
-    table_ = dynamic_cast<ELLookupTable*>(region->GetUserInformation());
-    // if (!table_) {
-    //   G4String msg = "ERROR: no EL lookup table attached to the region!";
-    //   G4Exception("[ELParamSimulation]", "ELParamSimulation()",
-    // 		  FatalException, msg);
-    // }
-
+    if (!table_) {
+      G4Exception("[ELParamSimulation]", "ELParamSimulation()",
+                  FatalException, "No EL light table given to the model.");
+    }
   }
 
 
 
   ELParamSimulation::~ELParamSimulation()
   {
+    delete table_;
   }
 
 
@@ -57,43 +60,97 @@ namespace nexus {
 
 
 
-  void ELParamSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& /*fstep*/)
+  void ELParamSimulation::AddSensitiveDetector(const G4String& sdname)
   {
-    // Get spatial coordinates
-    G4ThreeVector position = ftrack.GetPrimaryTrack()->GetPosition();
-
-    G4cout << "position = " << position << G4endl;
+    sensdets_.AddSensitiveDetector(sdname);
+  }
 
 
-    //table_->GetSensorsMap()
 
-    //if (HCE_.size() == 0) {
+  G4double ELParamSimulation::PhotonsPerElectron(const G4Region* region) const
+  {
+    if (photons_per_electron_ > 0.) return photons_per_electron_;
 
-      G4HCofThisEvent* hce =
-	G4RunManager::GetRunManager()->GetCurrentEvent()->GetHCofThisEvent();
+    // The light yield of the field is given per unit length,
+    // so it is integrated over the width of the EL gap
+    const UniformElectricDriftField* field =
+      dynamic_cast<const UniformElectricDriftField*>(region->GetUserInformation());
 
-      //}
+    if (!field) {
+      G4Exception("[ELParamSimulation]", "PhotonsPerElectron()", FatalException,
+                  ("Region " + region->GetName() + " has no uniform EL field: "
+                   "the number of photons per electron must be given.").c_str());
+    }
 
+    return field->LightYield() *
+      std::abs(field->GetAnodePosition() - field->GetCathodePosition());
+  }
 
-    G4cout << "No of collections: " << hce->GetNumberOfCollections() << G4endl;
 
 
-    G4cout << "here" << G4endl;
+  void ELParamSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
 
+    const IonizationGroupInformation* group =
+      dynamic_cast<const IonizationGroupInformation*>(track->GetUserInformation());
+    G4double transv_spread = group ? group->GetTransverseSpread() : 0.;
+    G4double time_spread   = group ? group->GetTimeSpread() : 0.;
 
-    ///FIXME. Parameters to be put in some other place
-    // G4int fNum_tbins = 5;
-    // G4double fBinWidth = 200.;
-    // G4int gain = 1170;
+    GenerateLight(track->GetPosition(), track->GetGlobalTime(),
+                  track->GetWeight(), transv_spread, time_spread,
+                  track->GetVolume()->GetLogicalVolume()->GetRegion());
 
-    // Get track coordinates
-    // ...
+    // The ionization electron ends in the EL region
+    fstep.KillPrimaryTrack();
+    fstep.ProposePrimaryTrackPathLength(0.);
+  }
 
-    // Ask table for the right sensor map
-    // ...
 
-    // Fill SensorHits according to this map
 
+  void ELParamSimulation::GenerateLight(const G4ThreeVector& position,
+                                        G4double time, G4double weight,
+                                        G4double transv_spread,
+                                        G4double time_spread,
+                                        const G4Region* region)
+  {
+    G4double yield = PhotonsPerElectron(region);
+
+    G4double bin_width = table_->GetTimeBinWidth();
+
+    // Groups of ionization electrons (weight larger than one) are split
+    // into their electrons, spread around the centroid, if they have
+    // diffused. Otherwise they are sampled once, with all their light.
+    G4bool spread = (transv_spread > 0. || time_spread > 0.);
+    G4int num_points = spread ? std::max(1, G4int(weight + 0.5)) : 1;
+    yield *= weight / num_points;
+
+    for (G4int n=0; n<num_points; ++n) {
+      G4ThreeVector point = position;
+      G4double point_time = time;
+      if (spread) {
+        point.setX(point.x() + G4RandGauss::shoot(0., transv_spread));
+        point.setY(point.y() + G4RandGauss::shoot(0., transv_spread));
+        point_time += G4RandGauss::shoot(0., time_spread);
+      }
+
+      ELSensorEntries entries = table_->GetSensorsMap(point);
+
+      for (size_t i=0; i<entries.GetNumSensors(); ++i) {
+        G4int sensor_id = entries.GetSensorID(i);
+        SensorSD* sd = sensdets_.Find(sensor_id);
+        if (!sd) continue;
+
+        for (size_t tbin=0; tbin<entries.GetNumTimeBins(); ++tbin) {
+          G4double mean = entries.GetValue(i, tbin) * yield;
+          if (mean <= 0.) continue;
+          G4int counts = G4Poisson(mean);
+          if (counts > 0)
+            sd->AddDetectedPhotons(sensor_id, point_time + (tbin + 0.5) * bin_width,
+                                   counts);
+        }
+      }
+    }
   }
 
 
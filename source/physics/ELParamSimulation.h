@@ -1,7 +1,9 @@
 // ----------------------------------------------------------------------------
 // nexus | ELParamSimulation.h
 //
-// This class (WIP) implements a parametrized simulation .
+// This class implements a parametrized simulation of the EL light:
+// ionization electrons reaching the EL region are replaced by the photons
+// detected by the sensors, sampled from a light table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -9,9 +11,9 @@
 #ifndef EL_PARAM_SIMULATION_H
 #define EL_PARAM_SIMULATION_H
 
+#include "SensorSDLookup.h"
+
 #include <G4VFastSimulationModel.hh>
-#include "SensorHit.h"
-#include <vector>
 
 
 namespace nexus {
@@ -21,49 +23,59 @@ namespace nexus {
   class ELParamSimulation: public G4VFastSimulationModel
   {
   public:
-    /// Constructor
-    ELParamSimulation(G4Region* region);
+    /// Constructor taking the EL region and the light table,
+    /// which is owned by the model from then on
+    ELParamSimulation(G4Region* region, ELLookupTable* table);
     /// Destructor
     ~ELParamSimulation();
 
     // This model is only valid for ionization electrons
     G4bool IsApplicable(const G4ParticleDefinition&);
 
-    // You have to return "true" when the dynamics conditions to trigger your
-    // parameterisation are fulfilled. The G4FastTrack provides you access to
-    // the current G4Track, gives simple access to envelope related features
-    // (G4LogicalVolume, G4VSolid, G4AffineTransform references between the
-    // global and the envelope local coordinates systems) and simple access to
-    // the position, momentum expressed in the envelope coordinate system.
-    // Using those quantities and the G4VSolid methods, you can for example
-    // easily check how far you are from the envelope boundary.
-    G4bool ModelTrigger(const G4FastTrack &);
-
-    // Your parameterisation properly said. The G4FastTrack reference provides
-    // input informations. The final state of the particles after parameterisation
-    // has to be returned through the G4FastStep reference. This final state is
-    // described has "requests" the tracking will apply after your
-    // parameterisation has been invoked.
+    // The model is triggered as soon as the ionization
+    // electron enters the EL region
+    G4bool ModelTrigger(const G4FastTrack&);
+
+    // The photons detected by every sensor in every time bin of the
+    // table are sampled from a Poisson distribution whose mean is the
+    // table value times the number of EL photons per electron, and
+    // added to the hits of the sensors. The electron is then killed.
     void DoIt(const G4FastTrack&, G4FastStep&);
 
-    //To load EL table
-    // void ReadELTable(const char* filename,
-    // 		     std::map<int, std::map<int, std::vector<double> > >& eltable);
+    /// Add a sensitive detector (full path name) whose sensors
+    /// are read from the light table
+    void AddSensitiveDetector(const G4String& sdname);
 
+    /// Set the number of EL photons emitted per ionization electron.
+    /// If zero (the default), it is computed from the light yield
+    /// and the width of the EL gap of the region drift field.
+    void SetPhotonsPerElectron(G4double);
 
-  private:
-    //BaseELGrid* elgrid_;
-    // std::map<G4int, std::map<G4int, std::vector<G4double> > >  eltable_;
+    /// Sample the photons detected by the sensors for an ionization
+    /// electron, or a group of 'weight' electrons with the given
+    /// spreads around its centroid, entering the EL gap of the
+    /// region at the given point and time
+    void GenerateLight(const G4ThreeVector& position, G4double time,
+                       G4double weight, G4double transv_spread,
+                       G4double time_spread, const G4Region* region);
 
-    // bool timebinning_;
-    // int num_tbins_;
+  private:
+    /// Return the number of EL photons per electron in the region
+    G4double PhotonsPerElectron(const G4Region*) const;
 
+  private:
     ELLookupTable* table_;
 
-    std::vector<SensorHitsCollection*> HCE_;
+    G4double photons_per_electron_; ///< EL photons per electron (0 = from field)
 
+    SensorSDLookup sensdets_; ///< Sensitive detectors of the table sensors
   };
 
+  // INLINE DEFINITIONS ////////////////////////////////////////////////
+
+  inline void ELParamSimulation::SetPhotonsPerElectron(G4double n)
+  { photons_per_electron_ = n; }
+
 } // end namespace nexus
 
 #endif
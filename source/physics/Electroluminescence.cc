@@ -10,9 +10,9 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "IonizationGroupInformation.h"
 
 #include <G4MaterialPropertiesTable.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
 #include <G4ParticleChange.hh>
 #include <G4OpticalPhoton.hh>
 #include <Randomize.hh>
@@ -21,6 +21,8 @@
 
 #include <CLHEP/Units/PhysicalConstants.h>
 
+#include <algorithm>
+
 using namespace nexus;
 using namespace CLHEP;
 
@@ -28,10 +30,11 @@ using namespace CLHEP;
 
 Electroluminescence::Electroluminescence(const G4String& process_name,
 					                               G4ProcessType type):
-  G4VDiscreteProcess(process_name, type), theFastIntegralTable_(0),
-  table_generation_(false), photons_per_point_(0)
+  G4VDiscreteProcess(process_name, type),
+  table_generation_(false), photons_per_point_(0), photon_weight_(1)
 {
   ParticleChange_ = new G4ParticleChange();
+  ParticleChange_->SetSecondaryWeightByProcess(true);
   pParticleChange = ParticleChange_;
 
   BuildThePhysicsTable();
@@ -44,13 +47,19 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
   msg_->DeclareProperty("photons_per_point", photons_per_point_,
 			"Photon per point");
 
+  G4GenericMessenger::Command& weight_cmd =
+    msg_->DeclareProperty("photon_weight", photon_weight_,
+                          "Number of EL photons carried by each optical photon tracked.");
+  weight_cmd.SetParameterName("photon_weight", false);
+  weight_cmd.SetRange("photon_weight>=1");
+
  }
 
 
 
 Electroluminescence::~Electroluminescence()
 {
-  delete theFastIntegralTable_;
+  delete msg_;
 }
 
 
@@ -71,8 +80,7 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   // Get the current region and its associated drift field.
   // If no drift field is defined, kill the track and leave
   G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
-  BaseDriftField* field =
-    dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+  BaseDriftField* field = fields_.GetField(region);
   if (!field) {
     ParticleChange_->ProposeTrackStatus(fStopAndKill);
     return G4VDiscreteProcess::PostStepDoIt(track, step);
@@ -85,29 +93,13 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   if (yield <= 0.)
     return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  // Generate a random number of photons around mean 'yield'
-  G4double mean = yield * step_length;
-
-  G4int num_photons;
-
-  if (yield < 10.) { // Poissonian regime
-    num_photons = G4int(G4Poisson(mean));
-  }
-  else {             // Gaussian regime
-    G4double sigma = sqrt(mean);
-    num_photons = G4int(G4RandGauss::shoot(mean, sigma) + 0.5);
-  }
-
-  if (table_generation_)
-    num_photons = photons_per_point_;
-
-  ParticleChange_->SetNumberOfSecondaries(num_photons);
+  G4int num_photons =
+    SampleNumberOfPhotons(yield, step_length, track.GetWeight());
 
   // Track secondaries first to avoid a memory bloat
   if ((num_photons > 0) && (track.GetTrackStatus() == fAlive))
     ParticleChange_->ProposeTrackStatus(fSuspend);
 
-
   //////////////////////////////////////////////////////////////////
 
   G4ThreeVector position = step.GetPreStepPoint()->GetPosition();
@@ -118,19 +110,74 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   G4double time_end = step.GetPostStepPoint()->GetGlobalTime();
   G4LorentzVector final_position(position_end, time_end);
 
-  // Energy is sampled from integral (like it is
-  // done in G4Scintillation)
   G4Material* mat = step.GetPostStepPoint()->GetTouchable()->GetVolume()->GetLogicalVolume()->GetMaterial();
-  G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
-  const G4MaterialPropertyVector* spectrum = mpt->GetProperty("ELSPECTRUM");
 
-  if (!spectrum) return G4VDiscreteProcess::PostStepDoIt(track, step);
+  // Spread of the electrons of a group around its centroid
+  const IonizationGroupInformation* group =
+    dynamic_cast<const IonizationGroupInformation*>(track.GetUserInformation());
+  G4double transv_spread = group ? group->GetTransverseSpread() : 0.;
+  G4double time_spread   = group ? group->GetTimeSpread() : 0.;
+
+  ParticleChange_->SetNumberOfSecondaries(num_photons);
+  GeneratePhotons(num_photons, initial_position, final_position, field, mat,
+                  transv_spread, time_spread, track.GetTrackID(), ParticleChange_);
+
+  return G4VDiscreteProcess::PostStepDoIt(track, step);
+}
+
 
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    (G4PhysicsOrderedFreeVector*)(*theFastIntegralTable_)(mat->GetIndex());
 
+G4int Electroluminescence::SampleNumberOfPhotons(G4double yield,
+                                                 G4double length,
+                                                 G4double weight) const
+{
+  // Generate a random number of photons around mean 'yield'.
+  // Groups of ionization electrons (tracks with weight) emit
+  // the light of all their electrons.
+  G4double mean = yield * length * weight;
 
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  G4int num_photons;
+
+  if (yield < 10.) { // Poissonian regime
+    num_photons = G4int(G4Poisson(mean));
+  }
+  else {             // Gaussian regime
+    G4double sigma = sqrt(mean);
+    num_photons = G4int(G4RandGauss::shoot(mean, sigma) + 0.5);
+  }
+
+  if (table_generation_)
+    num_photons = photons_per_point_;
+
+  // Macro-photons: each track carries photon_weight_ photons. The
+  // number of tracks is rounded stochastically to keep the mean.
+  if (photon_weight_ > 1) {
+    G4int num_tracks = num_photons / photon_weight_;
+    if (G4UniformRand() * photon_weight_ < num_photons % photon_weight_)
+      ++num_tracks;
+    num_photons = num_tracks;
+  }
+
+  return std::max(num_photons, 0);
+}
+
+
+
+void Electroluminescence::GeneratePhotons(G4int num_photons,
+                                          const G4LorentzVector& initial_position,
+                                          const G4LorentzVector& final_position,
+                                          BaseDriftField* field,
+                                          const G4Material* mat,
+                                          G4double transv_spread,
+                                          G4double time_spread,
+                                          G4int parent_id,
+                                          G4ParticleChange* change)
+{
+  // Energy is sampled from the EL spectrum of the material
+  if (mat->GetIndex() >= el_spectra_.size()) return;
+  const SpectrumSampler& spectrum = el_spectra_[mat->GetIndex()];
+
+  if (spectrum.IsEmpty()) return;
 
   for (G4int i=0; i<num_photons; i++) {
     // Generate a random direction for the photon
@@ -171,80 +218,48 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
       SetPolarization(polarization.x(), polarization.y(), polarization.z());
 
     // Determine photon energy
-    G4double sc_value = G4UniformRand()*sc_max;
-    G4double sampled_energy = spectrum_integral->GetEnergy(sc_value);
-    photon->SetKineticEnergy(sampled_energy);
+    photon->SetKineticEnergy(spectrum.Shoot());
 
     G4LorentzVector xyzt =
       field->GeneratePointAlongDriftLine(initial_position, final_position);
 
+    // Spread of the electrons of a group around its centroid,
+    // transverse to the drift (along z in all the geometries)
+    if (transv_spread > 0. || time_spread > 0.) {
+      xyzt.setX(xyzt.x() + G4RandGauss::shoot(0., transv_spread));
+      xyzt.setY(xyzt.y() + G4RandGauss::shoot(0., transv_spread));
+      xyzt.setT(xyzt.t() + G4RandGauss::shoot(0., time_spread));
+    }
+
     // Create the track
     G4Track* secondary = new G4Track(photon, xyzt.t(), xyzt.v());
-    secondary->SetParentID(track.GetTrackID());
-    ParticleChange_->AddSecondary(secondary);
+    secondary->SetParentID(parent_id);
+    secondary->SetWeight(photon_weight_);
+    change->AddSecondary(secondary);
 
   }
 
-  return G4VDiscreteProcess::PostStepDoIt(track, step);
 }
 
 
 
 void Electroluminescence::BuildThePhysicsTable()
 {
-  if (theFastIntegralTable_) return;
+  if (!el_spectra_.empty()) return;
 
-  const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
-  G4int numOfMaterials = G4Material::GetNumberOfMaterials();
+  // Build the sampler of the EL spectrum of every material,
+  // stored according to the position of the material in
+  // the material table (empty if it has no ELSPECTRUM)
 
-  // create new physics table
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  el_spectra_.resize(materials->size());
 
-  if(!theFastIntegralTable_)
-    theFastIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+  for (size_t i=0; i<materials->size(); ++i) {
+    G4MaterialPropertiesTable* mpt = (*materials)[i]->GetMaterialPropertiesTable();
+    if (!mpt) continue;
 
-  for (G4int i=0 ; i<numOfMaterials; i++) {
-
-  	G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-  	  new G4PhysicsOrderedFreeVector();
-
-  	// Retrieve vector of scintillation wavelength intensity for
-  	// the material from the material's optical properties table.
-
-  	G4Material* material = (*theMaterialTable)[i];
-
-    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
-
-    if (mpt) {
-
-  	  G4MaterialPropertyVector* theFastLightVector =
-  	    mpt->GetProperty("ELSPECTRUM");
-
-  	  if (theFastLightVector) {
-        ComputeCumulativeDistribution(*theFastLightVector, *aPhysicsOrderedFreeVector);
-		  }
-  	}
-
-  	// The scintillation integral(s) for a given material
-  	// will be inserted in the table(s) according to the
-  	// position of the material in the material table.
-
-  	theFastIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
-  }
-}
-
-
-
-void Electroluminescence::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
-{
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+    G4MaterialPropertyVector* spectrum = mpt->GetProperty("ELSPECTRUM");
+    if (spectrum) el_spectra_[i] = SpectrumSampler(*spectrum);
   }
 }
 
@@ -9,15 +9,24 @@
 #ifndef ELECTROLUMINESCENCE_H
 #define ELECTROLUMINESCENCE_H
 
+#include "DriftFieldCache.h"
+#include "SpectrumSampler.h"
+
 #include <G4VDiscreteProcess.hh>
+#include <G4LorentzVector.hh>
+
+#include <vector>
 
 
 class G4ParticleChange;
 class G4GenericMessenger;
+class G4Material;
 
 
 namespace nexus {
 
+  class BaseDriftField;
+
   class Electroluminescence: public G4VDiscreteProcess
   {
   public:
@@ -36,6 +45,24 @@ namespace nexus {
     /// secondaries at the end of the step.
     G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
 
+    /// Sample the number of photon tracks emitted by an ionization
+    /// electron, or a group of 'weight' electrons, drifting a given
+    /// length with the given light yield. Macro-photons are accounted for.
+    G4int SampleNumberOfPhotons(G4double yield, G4double length,
+                                G4double weight) const;
+
+    /// Generate photons between the initial and final points of the
+    /// drift of the electrons across the EL gap and add them as
+    /// secondaries to the given particle change. The transverse and time
+    /// spreads of a group of electrons around its centroid, if any, are
+    /// applied to each photon.
+    void GeneratePhotons(G4int num_photons,
+                         const G4LorentzVector& initial_position,
+                         const G4LorentzVector& final_position,
+                         BaseDriftField* field, const G4Material* mat,
+                         G4double transv_spread, G4double time_spread,
+                         G4int parent_id, G4ParticleChange* change);
+
   private:
 
     /// Returns infinity; i.e., the process does not limit the step,
@@ -44,18 +71,21 @@ namespace nexus {
     G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
 
   private:
     G4ParticleChange* ParticleChange_;
 
-    G4PhysicsTable* theFastIntegralTable_;
+    /// Sampler of the EL spectrum of each material (by index),
+    /// empty if the material has none
+    std::vector<SpectrumSampler> el_spectra_;
+
+    DriftFieldCache fields_; ///< Drift fields of the regions
 
     G4GenericMessenger* msg_;
 
     G4bool table_generation_;
     G4int photons_per_point_;
+    G4int photon_weight_; ///< Photons carried by each tracked photon
   };
 
 } // end namespace nexus
@@ -11,6 +11,7 @@
 #include "BaseDriftField.h"
 #include "IonizationElectron.h"
 #include "SegmentPointSampler.h"
+#include "AnalyticDrift.h"
 
 #include <G4ParticleDefinition.hh>
 #include <G4OpticalPhoton.hh>
@@ -18,9 +19,12 @@
 #include <Randomize.hh>
 #include <G4LorentzVector.hh>
 #include <G4Gamma.hh>
+#include <G4GenericMessenger.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+
 
 namespace nexus {
 
@@ -29,20 +33,33 @@ namespace nexus {
 
   IonizationClustering::IonizationClustering(const G4String& process_name,
                                              G4ProcessType type):
-    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0)
+    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0),
+    msg_(0), group_size_(1), analytic_drift_(0)
   {
     // Create particle change object
     ParticleChange_ = new G4ParticleChange();
+    ParticleChange_->SetSecondaryWeightByProcess(true);
     pParticleChange = ParticleChange_;
 
     // Create a segment point sample
     rnd_ = new SegmentPointSampler();
+
+    msg_ = new G4GenericMessenger(this, "/Physics/IonizationClustering/",
+      "Control commands of the ionization clustering process.");
+
+    G4GenericMessenger::Command& group_cmd =
+      msg_->DeclareProperty("group_size", group_size_,
+        "Number of ionization electrons tracked together as a weighted track.");
+    group_cmd.SetParameterName("group_size", false);
+    group_cmd.SetRange("group_size>=1");
   }
 
 
 
   IonizationClustering::~IonizationClustering()
   {
+    delete analytic_drift_;
+    delete msg_;
     delete rnd_;
     delete ParticleChange_;
   }
@@ -95,8 +112,7 @@ namespace nexus {
 
     G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
 
-    BaseDriftField* field =
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    BaseDriftField* field = fields_.GetField(region);
 
     if (!field) return G4VRestDiscreteProcess::PostStepDoIt(track, step);
 
@@ -131,16 +147,9 @@ namespace nexus {
       num_charges = G4int(G4Poisson(mean));
     }
 
-    ParticleChange_->SetNumberOfSecondaries(num_charges);
-
-    // Track secondaries first
-    if ((track.GetTrackStatus() == fAlive) && num_charges > 0)
-      ParticleChange_->ProposeTrackStatus(fSuspend);
-
-    //////////////////////////////////////////////////////////////////
-
-    G4ThreeVector momentum_direction(0.,0.,1.);
-    G4double kinetic_energy = 1.*eV;
+    // The charges are tracked in groups of group_size_, the weight
+    // of the tracks, plus a last group with the remaining ones
+    G4int num_tracks = (num_charges + group_size_ - 1) / group_size_;
 
     // Set pre and post points of the step in the random generator
     G4LorentzVector pre_point(step.GetPreStepPoint()->GetPosition(),
@@ -149,9 +158,41 @@ namespace nexus {
                   			       step.GetPostStepPoint()->GetGlobalTime());
     rnd_->SetPoints(pre_point, post_point);
 
+    //////////////////////////////////////////////////////////////////
+    // In the analytic drift mode the groups are drifted without being
+    // tracked, and the secondaries are their EL photons, if any.
+
+    if (analytic_drift_) {
+      for (G4int i=0; i<num_tracks; i++) {
+        G4LorentzVector point;
+        if (track.GetDefinition() == G4Gamma::Definition()) point = post_point;
+        else point = rnd_->Shoot();
+        analytic_drift_->AddDeposit(point, std::min(group_size_, num_charges - i*group_size_));
+      }
+
+      G4int num_photons =
+        analytic_drift_->Process(field, track.GetMaterial(),
+                                 track.GetTrackID(), ParticleChange_);
 
-    for (G4int i=0; i<num_charges; i++) {
+      // Track secondaries first
+      if ((track.GetTrackStatus() == fAlive) && num_photons > 0)
+        ParticleChange_->ProposeTrackStatus(fSuspend);
 
+      return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+    }
+
+    //////////////////////////////////////////////////////////////////
+
+    ParticleChange_->SetNumberOfSecondaries(num_tracks);
+
+    // Track secondaries first
+    if ((track.GetTrackStatus() == fAlive) && num_tracks > 0)
+      ParticleChange_->ProposeTrackStatus(fSuspend);
+
+    G4ThreeVector momentum_direction(0.,0.,1.);
+    G4double kinetic_energy = 1.*eV;
+
+    for (G4int i=0; i<num_tracks; i++) {
       G4DynamicParticle* ionielectron =
         new G4DynamicParticle(IonizationElectron::Definition(),
           momentum_direction, kinetic_energy);
@@ -168,6 +209,8 @@ namespace nexus {
 
       aSecondaryTrack->
         SetTouchableHandle(step.GetPreStepPoint()->GetTouchableHandle());
+      aSecondaryTrack->
+        SetWeight(std::min(group_size_, num_charges - i*group_size_));
 
       ParticleChange_->AddSecondary(aSecondaryTrack);
     }
@@ -9,12 +9,16 @@
 #ifndef IONIZATION_CLUSTERING_H
 #define IONIZATION_CLUSTERING_H
 
+#include "DriftFieldCache.h"
+
 #include <G4VRestDiscreteProcess.hh>
 
+class G4GenericMessenger;
 
 namespace nexus {
 
   class SegmentPointSampler;
+  class AnalyticDrift;
 
   class IonizationClustering: public G4VRestDiscreteProcess
   {
@@ -43,6 +47,11 @@ namespace nexus {
     /// by particles at rest
     G4VParticleChange* AtRestDoIt(const G4Track&, const G4Step&);
 
+    /// Set the engine drifting the ionization electrons analytically,
+    /// which is owned by the process from then on. If set, no
+    /// ionization electrons are tracked.
+    void SetAnalyticDrift(AnalyticDrift*);
+
   private:
 
     /// Returns infinity; i. e. the process does not limit the step,
@@ -58,8 +67,21 @@ namespace nexus {
   private:
     G4ParticleChange* ParticleChange_;
     SegmentPointSampler* rnd_;
+    DriftFieldCache fields_; ///< Drift fields of the regions
+
+    G4GenericMessenger* msg_;
+    /// Number of ionization electrons tracked together as a single
+    /// track with weight (the last group of a step can be smaller)
+    G4int group_size_;
+
+    AnalyticDrift* analytic_drift_;
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void IonizationClustering::SetAnalyticDrift(AnalyticDrift* drift)
+  { analytic_drift_ = drift; }
+
 } // end namespace nexus
 
 #endif
@@ -11,19 +11,26 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "IonizationGroupInformation.h"
 
 #include <G4ParticleChangeForTransport.hh>
 #include <G4RegionStore.hh>
 #include <G4TransportationManager.hh>
 #include <G4TouchableHandle.hh>
 #include <G4Navigator.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <Randomize.hh>
+
+#include <cmath>
 
 
 namespace nexus {
 
 
   IonizationDrift::IonizationDrift(const G4String& name, G4ProcessType type):
-    G4VContinuousDiscreteProcess(name, type)
+    G4VContinuousDiscreteProcess(name, type),
+    transv_spread_(0.), time_spread_(0.)
   {
     ParticleChange_ = new G4ParticleChangeForTransport();
     pParticleChange = ParticleChange_;
@@ -55,16 +62,20 @@ namespace nexus {
     G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
     
     // Get the drift field attached to this region
-    BaseDriftField* field = 
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    BaseDriftField* field = fields_.GetField(region);
 
     // If the region has no field, the particle won't move 
     // and therefore the step length is zero.
     if (!field) return step_length;
 
-    // Get displacement from current position due to drift field
+    // Get displacement from current position due to drift field.
+    // Groups of electrons (tracks with weight) drift as their centroid.
     xyzt_.set(track.GetGlobalTime(), track.GetPosition());
-    step_length = field->Drift(xyzt_);
+    if (track.GetWeight() > 1.)
+      step_length = field->DriftGroup(xyzt_, track.GetWeight(),
+                                      transv_spread_, time_spread_);
+    else
+      step_length = field->Drift(xyzt_);
     
     return step_length;
   }
@@ -81,19 +92,34 @@ namespace nexus {
     if (step.GetStepLength() > 0) {
 
       // Simulate attachment by impurities
-      
-      G4MaterialPropertiesTable* mpt = 
-        track.GetMaterial()->GetMaterialPropertiesTable();
-
-      if (!mpt || !(mpt->ConstPropertyExists("ATTACHMENT"))) { 
-        G4Exception("[IonizationDrift]", "AlongStepDoIt()", JustWarning,
-          "No material properties table found. Assuming no attachment.");
+      const G4double attach = GetAttachment(track.GetMaterial());
+
+      if (attach > 0.) {
+        if (track.GetWeight() > 1.) {
+          // Every electron of a group survives independently
+          G4int survivors = G4int(CLHEP::RandBinomial::shoot
+            (G4int(track.GetWeight() + 0.5), std::exp(-xyzt_.t()/attach)));
+          if (survivors == 0)
+            ParticleChange_->ProposeTrackStatus(fStopAndKill);
+          else
+            ParticleChange_->ProposeWeight(survivors);
+        }
+        else {
+          G4double rnd = -attach * log(G4UniformRand());
+          if (xyzt_.t() > rnd)
+            ParticleChange_->ProposeTrackStatus(fStopAndKill);
+        }
       }
-      else {
-        const G4double attach = mpt->GetConstProperty("ATTACHMENT");
-        G4double rnd = -attach * log(G4UniformRand());
-        if (xyzt_.t() > rnd) 
-          ParticleChange_->ProposeTrackStatus(fStopAndKill);
+
+      // Accumulate the spread of the electrons of a group
+      if (track.GetWeight() > 1. && (transv_spread_ > 0. || time_spread_ > 0.)) {
+        IonizationGroupInformation* info =
+          dynamic_cast<IonizationGroupInformation*>(track.GetUserInformation());
+        if (!info) {
+          info = new IonizationGroupInformation();
+          track.SetUserInformation(info);
+        }
+        info->AddSpread(transv_spread_, time_spread_);
       }
 
       ParticleChange_->ProposeGlobalTime(xyzt_.t());
@@ -109,6 +135,36 @@ namespace nexus {
   
   
   
+  G4double IonizationDrift::GetAttachment(const G4Material* mat)
+  {
+    // The attachment of all the materials is read from their property
+    // tables the first time it is needed (or when new materials exist)
+    if (mat->GetIndex() >= attachment_.size()) {
+      const G4MaterialTable* materials = G4Material::GetMaterialTable();
+      attachment_.assign(materials->size(), -1.);
+
+      for (const G4Material* material : *materials) {
+        G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+        if (mpt && mpt->ConstPropertyExists("ATTACHMENT"))
+          attachment_[material->GetIndex()] = mpt->GetConstProperty("ATTACHMENT");
+      }
+    }
+
+    G4double attach = attachment_[mat->GetIndex()];
+
+    if (attach < 0.) {
+      G4Exception("[IonizationDrift]", "GetAttachment()", JustWarning,
+        ("No attachment found for material " + mat->GetName() +
+         ". Assuming no attachment.").c_str());
+      // Warn only once per material
+      attachment_[mat->GetIndex()] = attach = 0.;
+    }
+
+    return attach;
+  }
+
+
+
   G4double IonizationDrift::GetMeanFreePath(const G4Track&, G4double, 
     G4ForceCondition* condition)
   {
@@ -10,11 +10,15 @@
 #ifndef IONIZATION_DRIFT_H
 #define IONIZATION_DRIFT_H
 
+#include "DriftFieldCache.h"
+
 #include <G4VContinuousDiscreteProcess.hh>
 
+#include <vector>
 
 class G4Navigator;
 class G4ParticleChangeForTransport;
+class G4Material;
 
 namespace nexus {
 
@@ -45,11 +49,21 @@ namespace nexus {
     /// Returns zero if no electric field is defined for the region.
     G4double GetContinuousStepLimit(const G4Track&, G4double, 
 				    G4double, G4double&);
+
+    /// Returns the attachment (lifetime) of the electrons in a
+    /// material, zero meaning no attachment
+    G4double GetAttachment(const G4Material*);
     
   private:
     G4LorentzVector xyzt_;
+    G4double transv_spread_; ///< Transverse spread of a group in the step
+    G4double time_spread_;   ///< Time spread of a group in the step
     G4ParticleChangeForTransport* ParticleChange_;
     G4Navigator* nav_; ///< Pointer to the G4 navigator for tracking
+
+    DriftFieldCache fields_; ///< Drift fields of the regions
+    /// Attachment of each material (by index), negative if not read yet
+    std::vector<G4double> attachment_;
   };
 
 } // end namespace nexus
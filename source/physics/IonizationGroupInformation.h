@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------------
+// nexus | IonizationGroupInformation.h
+//
+// This class stores the spread of the electrons of a group of ionization
+// electrons tracked together, due to the diffusion along their drift.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef IONIZATION_GROUP_INFORMATION_H
+#define IONIZATION_GROUP_INFORMATION_H
+
+#include <G4VUserTrackInformation.hh>
+#include <globals.hh>
+
+#include <cmath>
+
+
+namespace nexus {
+
+  /// A group of ionization electrons (a track with weight larger
+  /// than one) drifts as a single point, its centroid. The diffusion
+  /// of its electrons around the centroid is accumulated here and
+  /// applied when the group produces light.
+
+  class IonizationGroupInformation: public G4VUserTrackInformation
+  {
+  public:
+    /// Constructor
+    IonizationGroupInformation();
+    /// Destructor
+    ~IonizationGroupInformation();
+
+    /// Add the spread (sigmas) of the electrons around the
+    /// centroid of the group gained in a drift step
+    void AddSpread(G4double transv_sigma, G4double time_sigma);
+
+    /// Returns the transverse spread (sigma) of the electrons
+    G4double GetTransverseSpread() const;
+    /// Returns the spread (sigma) of the arrival time of the electrons
+    G4double GetTimeSpread() const;
+
+    void Print() const;
+
+  private:
+    G4double transv_var_; ///< Variance of the transverse spread
+    G4double time_var_;   ///< Variance of the time spread
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline IonizationGroupInformation::IonizationGroupInformation():
+    G4VUserTrackInformation(), transv_var_(0.), time_var_(0.) {}
+
+  inline IonizationGroupInformation::~IonizationGroupInformation() {}
+
+  inline void IonizationGroupInformation::AddSpread(G4double transv_sigma,
+                                                    G4double time_sigma)
+  {
+    transv_var_ += transv_sigma * transv_sigma;
+    time_var_   += time_sigma * time_sigma;
+  }
+
+  inline G4double IonizationGroupInformation::GetTransverseSpread() const
+  { return std::sqrt(transv_var_); }
+
+  inline G4double IonizationGroupInformation::GetTimeSpread() const
+  { return std::sqrt(time_var_); }
+
+  inline void IonizationGroupInformation::Print() const {}
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// nexus | MapDriftField.cc
+//
+// This class defines a drift field described by a map of the drift
+// parameters, with drift lines from cathode to anode along the z axis.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "MapDriftField.h"
+#include "DriftFieldMap.h"
+#include "SegmentPointSampler.h"
+
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include "CLHEP/Units/SystemOfUnits.h"
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  MapDriftField::MapDriftField(DriftFieldMap* map,
+                               G4double anode_position,
+                               G4double cathode_position):
+    BaseDriftField(), map_(map),
+    anode_pos_(anode_position), cathode_pos_(cathode_position),
+    segment_length_(1.*cm), light_yield_(0.)
+  {
+    if (!map_) {
+      G4Exception("[MapDriftField]", "MapDriftField()",
+                  FatalException, "No drift field map given to the field.");
+    }
+
+    rnd_ = new SegmentPointSampler();
+  }
+
+
+
+  MapDriftField::~MapDriftField()
+  {
+    delete rnd_;
+    delete map_;
+  }
+
+
+
+  G4double MapDriftField::Drift(G4LorentzVector& xyzt)
+  {
+    G4double transv_spread, time_spread;
+    return DriftGroup(xyzt, 1., transv_spread, time_spread);
+  }
+
+
+
+  G4double MapDriftField::DriftGroup(G4LorentzVector& xyzt, G4double weight,
+                                     G4double& transv_spread,
+                                     G4double& time_spread)
+  {
+    transv_spread = time_spread = 0.;
+
+    // If the origin is not between anode and cathode,
+    // the charge carrier doesn't move.
+    if (!CheckCoordinate(xyzt.z()))
+      return 0.;
+
+    // Set the offset according to relative anode-cathode pos
+    G4double secmargin = -1. * micrometer;
+    if (anode_pos_ > cathode_pos_) secmargin = -secmargin;
+
+    const G4ThreeVector origin = xyzt.vect();
+    const G4double drift_length = std::abs(anode_pos_ - origin.z());
+    const G4double direction = (anode_pos_ > origin.z()) ? 1. : -1.;
+
+    // Displacement of the endpoint due to the field distortions
+    DriftParameters params = map_->Interpolate(origin);
+    const G4double dx = params.dx;
+    const G4double dy = params.dy;
+
+    // Integrate the drift over coarse segments, following
+    // the displaced drift line
+    G4int num_segments =
+      std::max(1, G4int(std::ceil(drift_length / segment_length_)));
+    G4double length = drift_length / num_segments;
+
+    G4double drift_time = 0.;
+    G4double transv_var = 0.;
+    G4double time_var   = 0.;
+
+    for (G4int i=0; i<num_segments; ++i) {
+      G4double f = (i + 0.5) / num_segments;
+      G4ThreeVector midpoint(origin.x() + f * dx, origin.y() + f * dy,
+                             origin.z() + direction * f * drift_length);
+      params = map_->Interpolate(midpoint);
+
+      // The charge doesn't move where there is no field
+      if (params.drift_velocity <= 0.) return 0.;
+
+      drift_time += length / params.drift_velocity;
+      transv_var += params.transv_diff * params.transv_diff * length;
+      time_var   += params.longit_diff * params.longit_diff * length /
+        (params.drift_velocity * params.drift_velocity);
+    }
+
+    G4double transv_sigma = std::sqrt(transv_var);
+    G4double time_sigma   = std::sqrt(time_var);
+
+    // For a group of electrons, the centroid diffuses with the
+    // single-electron sigma over sqrt(weight), and the electrons
+    // spread around it with the rest of the variance
+    if (weight > 1.) {
+      G4double spread = std::sqrt(1. - 1./weight);
+      transv_spread = transv_sigma * spread;
+      time_spread   = time_sigma * spread;
+      transv_sigma /= std::sqrt(weight);
+      time_sigma   /= std::sqrt(weight);
+    }
+
+    G4ThreeVector position(G4RandGauss::shoot(origin.x() + dx, transv_sigma),
+                           G4RandGauss::shoot(origin.y() + dy, transv_sigma),
+                           anode_pos_ + secmargin);
+
+    G4double time = xyzt.t() + drift_time + G4RandGauss::shoot(0., time_sigma);
+    if (time < 0.) time = xyzt.t() + drift_time;
+
+    G4double step_length = (position - origin).mag();
+
+    // Set the new time and position of the drifting charge
+    xyzt.set(time, position);
+
+    return step_length;
+  }
+
+
+
+  G4LorentzVector MapDriftField::GeneratePointAlongDriftLine(
+    const G4LorentzVector& origin, const G4LorentzVector& end)
+  {
+    rnd_->SetPoints(origin, end);
+    return rnd_->Shoot();
+  }
+
+
+
+  G4bool MapDriftField::CheckCoordinate(G4double coord) const
+  {
+    G4double max_coord = std::max(anode_pos_, cathode_pos_);
+    G4double min_coord = std::min(anode_pos_, cathode_pos_);
+    return !((coord > max_coord) || (coord < min_coord));
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+// nexus | MapDriftField.h
+//
+// This class defines a drift field described by a map of the drift
+// parameters, with drift lines from cathode to anode along the z axis.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef MAP_DRIFT_FIELD_H
+#define MAP_DRIFT_FIELD_H
+
+#include "BaseDriftField.h"
+
+
+namespace nexus {
+
+  class DriftFieldMap;
+  class SegmentPointSampler;
+
+  /// The drift from the starting point to the anode is computed in
+  /// coarse segments along z instead of per Geant4 step: the drift time
+  /// and the longitudinal and transverse variances are integrated over
+  /// the segments with the velocity and diffusion interpolated from the
+  /// map at their midpoints. The endpoint is displaced in (x, y) by the
+  /// displacement of the map at the starting point, which describes the
+  /// distortions of the field (e.g. near the field cage). The map is
+  /// given in global coordinates.
+
+  class MapDriftField: public BaseDriftField
+  {
+  public:
+    /// Constructor taking the map, which is owned by the field from
+    /// then on, and the position in z of the anode and cathode
+    MapDriftField(DriftFieldMap* map,
+                  G4double anode_position=0., G4double cathode_position=0.);
+    /// Destructor
+    ~MapDriftField();
+
+    /// Calculate the final position and time of an ionization electron
+    G4double Drift(G4LorentzVector& xyzt);
+
+    /// Drift of a group of ionization electrons: the diffusion of the
+    /// centroid is reduced by the square root of the number of electrons
+    G4double DriftGroup(G4LorentzVector& xyzt, G4double weight,
+                        G4double& transv_spread, G4double& time_spread);
+
+    G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
+
+    // Setters/getters
+
+    void SetAnodePosition(G4double);
+    G4double GetAnodePosition() const;
+
+    void SetCathodePosition(G4double);
+    G4double GetCathodePosition() const;
+
+    /// Maximum length of the segments in which the drift is integrated
+    void SetSegmentLength(G4double);
+    G4double GetSegmentLength() const;
+
+    void SetLightYield(G4double);
+    virtual G4double LightYield() const;
+
+  private:
+    /// Returns true if coordinate is between anode and cathode
+    G4bool CheckCoordinate(G4double) const;
+
+  private:
+    DriftFieldMap* map_;
+
+    G4double anode_pos_;   ///< Anode position in z
+    G4double cathode_pos_; ///< Cathode position in z
+
+    G4double segment_length_; ///< Maximum length of the drift segments
+    G4double light_yield_;
+
+    SegmentPointSampler* rnd_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void MapDriftField::SetAnodePosition(G4double p)
+  { anode_pos_ = p; }
+
+  inline G4double MapDriftField::GetAnodePosition() const
+  { return anode_pos_; }
+
+  inline void MapDriftField::SetCathodePosition(G4double p)
+  { cathode_pos_ = p; }
+
+  inline G4double MapDriftField::GetCathodePosition() const
+  { return cathode_pos_; }
+
+  inline void MapDriftField::SetSegmentLength(G4double l)
+  { segment_length_ = l; }
+
+  inline G4double MapDriftField::GetSegmentLength() const
+  { return segment_length_; }
+
+  inline void MapDriftField::SetLightYield(G4double ly)
+  { light_yield_ = ly; }
+
+  inline G4double MapDriftField::LightYield() const
+  { return light_yield_; }
+
+} // end namespace nexus
+
+#endif
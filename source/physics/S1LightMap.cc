@@ -0,0 +1,186 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightMap.cc
+//
+// This class describes a 3D map of the response of the sensors to the
+// primary scintillation light emitted in each voxel of the detector.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "S1LightMap.h"
+
+#include <G4UIcommand.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace nexus {
+
+
+  S1LightMap::S1LightMap(const G4String& filename):
+    min_(0., 0., 0.), voxel_size_(0., 0., 0.), num_voxels_(0),
+    num_time_bins_(0), time_bin_width_(0.)
+  {
+    bins_[0] = bins_[1] = bins_[2] = 0;
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+      G4Exception("[S1LightMap]", "S1LightMap()", FatalException,
+                  ("Cannot open S1 light map " + filename).c_str());
+    }
+
+    ReadHeader(file);
+    ReadRows(file, filename);
+  }
+
+
+
+  S1LightMap::~S1LightMap()
+  {
+  }
+
+
+
+  void S1LightMap::ReadHeader(std::ifstream& file)
+  {
+    G4String line;
+    while (file.peek() == '*') {
+      std::getline(file, line);
+      std::istringstream iss(line.substr(1));
+
+      G4String key, unit;
+      if (!(iss >> key)) continue;
+
+      if (key == "min" || key == "voxel_size") {
+        G4double x, y, z;
+        if (!(iss >> x >> y >> z)) continue;
+        G4double scale = (iss >> unit) ? G4UIcommand::ValueOf(unit) : 1.;
+        G4ThreeVector value(x*scale, y*scale, z*scale);
+        if (key == "min") min_ = value;
+        else              voxel_size_ = value;
+      }
+      else if (key == "bins") {
+        iss >> bins_[0] >> bins_[1] >> bins_[2];
+      }
+      else if (key == "time_bins") {
+        iss >> num_time_bins_;
+      }
+      else if (key == "time_bin_width") {
+        G4double value;
+        if (!(iss >> value)) continue;
+        G4double scale = (iss >> unit) ? G4UIcommand::ValueOf(unit) : 1.;
+        time_bin_width_ = value * scale;
+      }
+    }
+
+    if (bins_[0] <= 0 || bins_[1] <= 0 || bins_[2] <= 0 ||
+        voxel_size_.x() <= 0. || voxel_size_.y() <= 0. || voxel_size_.z() <= 0.) {
+      G4Exception("[S1LightMap]", "ReadHeader()", FatalException,
+                  "Wrong voxel size or number of voxels in the map header.");
+    }
+
+    num_voxels_ = size_t(bins_[0]) * bins_[1] * bins_[2];
+  }
+
+
+
+  void S1LightMap::ReadRows(std::ifstream& file, const G4String& filename)
+  {
+    offsets_.assign(1, 0);
+    sensor_ids_.clear();
+    probs_.clear();
+    time_cdf_.clear();
+
+    G4int voxel, sensor_id;
+    while (file >> voxel >> sensor_id) {
+
+      G4int current = offsets_.size() - 1;
+      if (voxel < current || voxel >= G4int(num_voxels_)) {
+        G4Exception("[S1LightMap]", "ReadRows()", FatalException,
+                    ("Wrong voxel id " + std::to_string(voxel) +
+                     " in S1 light map " + filename).c_str());
+      }
+
+      for (; current < voxel; ++current)
+        offsets_.push_back(sensor_ids_.size());
+
+      if (sensor_id >= 0) {
+        G4double prob;
+        file >> prob;
+        sensor_ids_.push_back(sensor_id);
+        probs_.push_back(prob);
+        continue;
+      }
+
+      // Arrival-time distribution of the voxel, stored as a
+      // cumulative distribution for the sampling
+      if (time_cdf_.empty()) time_cdf_.assign(num_voxels_ * num_time_bins_, 0.);
+      G4double sum = 0.;
+      for (size_t i=0; i<num_time_bins_; ++i) {
+        G4double value;
+        file >> value;
+        sum += std::max(value, 0.);
+        time_cdf_[voxel*num_time_bins_ + i] = sum;
+      }
+    }
+
+    if (file.fail() && !file.eof()) {
+      G4Exception("[S1LightMap]", "ReadRows()", FatalException,
+                  ("Wrong format of S1 light map " + filename).c_str());
+    }
+
+    // Voxels without entries at the end of the map
+    while (offsets_.size() < num_voxels_ + 1)
+      offsets_.push_back(sensor_ids_.size());
+  }
+
+
+
+  G4int S1LightMap::GetVoxel(const G4ThreeVector& pos) const
+  {
+    G4int ix = G4int(std::floor((pos.x() - min_.x())/voxel_size_.x()));
+    G4int iy = G4int(std::floor((pos.y() - min_.y())/voxel_size_.y()));
+    G4int iz = G4int(std::floor((pos.z() - min_.z())/voxel_size_.z()));
+
+    if (ix < 0 || ix >= bins_[0] || iy < 0 || iy >= bins_[1] ||
+        iz < 0 || iz >= bins_[2]) return -1;
+
+    return (ix*bins_[1] + iy)*bins_[2] + iz;
+  }
+
+
+
+  G4double S1LightMap::SampleArrivalTime(G4int voxel) const
+  {
+    if (time_cdf_.empty()) return 0.;
+
+    const float* cdf = &time_cdf_[voxel*num_time_bins_];
+    G4double total = cdf[num_time_bins_-1];
+    if (total <= 0.) return 0.;
+
+    G4double value = G4UniformRand() * total;
+    size_t bin = std::upper_bound(cdf, cdf + num_time_bins_, value) - cdf;
+    bin = std::min(bin, num_time_bins_-1);
+
+    return (bin + G4UniformRand()) * time_bin_width_;
+  }
+
+
+
+  void S1LightMap::Print() const
+  {
+    G4cout << "S1 light map: " << bins_[0] << " x " << bins_[1] << " x "
+           << bins_[2] << " voxels of " << voxel_size_/mm << " mm from "
+           << min_/mm << " mm, " << sensor_ids_.size() << " entries, "
+           << num_time_bins_ << " time bins of " << time_bin_width_/ns
+           << " ns." << G4endl;
+  }
+
+
+} // end namespace nexus
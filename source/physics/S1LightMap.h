@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightMap.h
+//
+// This class describes a 3D map of the response of the sensors to the
+// primary scintillation light emitted in each voxel of the detector.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef S1_LIGHT_MAP_H
+#define S1_LIGHT_MAP_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+
+namespace nexus {
+
+  /// The map is defined on a regular grid of voxels. For every voxel it
+  /// stores the probability that a scintillation photon emitted in it is
+  /// detected by each sensor, and the distribution of the arrival time of
+  /// the detected photons (relative to their emission) in a number of
+  /// time bins, common to all the sensors.
+  ///
+  /// The map is read from a text file with a header of lines
+  ///   * min <x> <y> <z> <unit>         lower corner of the grid
+  ///   * voxel_size <x> <y> <z> <unit>  size of the voxels
+  ///   * bins <nx> <ny> <nz>            number of voxels per axis
+  ///   * time_bins <n>                  number of arrival-time bins
+  ///   * time_bin_width <w> <unit>      width of the arrival-time bins
+  /// followed by rows "<voxel id> <sensor id> <probability>" and, for the
+  /// arrival-time distribution, "<voxel id> -1 <value per time bin>",
+  /// sorted by voxel id. Voxels are numbered (ix*ny + iy)*nz + iz.
+  /// Such maps are produced with the ScintillationGenerator in voxel-map
+  /// mode and scripts/make_s1_light_map.py.
+
+  class S1LightMap
+  {
+  public:
+    /// Constructor reading the map from a file
+    S1LightMap(const G4String& filename);
+    /// Destructor
+    ~S1LightMap();
+
+    /// Returns the voxel containing a position, or -1 if outside the map
+    G4int GetVoxel(const G4ThreeVector&) const;
+
+    /// Returns the number of sensors that detect light from a voxel
+    size_t GetNumSensors(G4int voxel) const;
+    /// Returns the id of the i-th sensor of a voxel
+    G4int GetSensorID(G4int voxel, size_t i) const;
+    /// Returns the detection probability of the i-th sensor of a voxel
+    G4double GetProbability(G4int voxel, size_t i) const;
+
+    /// Samples the arrival time of a detected photon emitted in a voxel,
+    /// relative to its emission (0 if the voxel has no time distribution)
+    G4double SampleArrivalTime(G4int voxel) const;
+
+    /// Returns the number of voxels of the map
+    size_t GetNumVoxels() const;
+    /// Returns the number of arrival-time bins
+    size_t GetNumTimeBins() const;
+    /// Returns the width of the arrival-time bins
+    G4double GetTimeBinWidth() const;
+
+    void Print() const;
+
+  private:
+    /// Read the map header (lines starting with '*')
+    void ReadHeader(std::ifstream&);
+    /// Read the map rows
+    void ReadRows(std::ifstream&, const G4String& filename);
+
+  private:
+    G4ThreeVector min_;        ///< Lower corner of the grid
+    G4ThreeVector voxel_size_; ///< Size of the voxels
+    G4int bins_[3];            ///< Number of voxels per axis
+    size_t num_voxels_;        ///< Total number of voxels
+
+    size_t num_time_bins_;     ///< Number of arrival-time bins
+    G4double time_bin_width_;  ///< Width of the arrival-time bins
+
+    /// Entries of voxel i are [offsets_[i], offsets_[i+1])
+    std::vector<uint64_t> offsets_;
+    std::vector<G4int> sensor_ids_; ///< Sensor id of every entry
+    std::vector<float> probs_;      ///< Detection probability of every entry
+
+    /// Cumulative arrival-time distribution of every voxel
+    /// (num_time_bins_ values per voxel, all zero if not given)
+    std::vector<float> time_cdf_;
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t S1LightMap::GetNumSensors(G4int voxel) const
+  { return offsets_[voxel+1] - offsets_[voxel]; }
+
+  inline G4int S1LightMap::GetSensorID(G4int voxel, size_t i) const
+  { return sensor_ids_[offsets_[voxel] + i]; }
+
+  inline G4double S1LightMap::GetProbability(G4int voxel, size_t i) const
+  { return probs_[offsets_[voxel] + i]; }
+
+  inline size_t S1LightMap::GetNumVoxels() const { return num_voxels_; }
+  inline size_t S1LightMap::GetNumTimeBins() const { return num_time_bins_; }
+  inline G4double S1LightMap::GetTimeBinWidth() const { return time_bin_width_; }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,177 @@
+// ----------------------------------------------------------------------------
+// nexus | S1ParamSimulation.cc
+//
+// This class implements a parametrized simulation of the primary
+// scintillation light: the photons detected by the sensors are sampled
+// from an S1 light map instead of being tracked.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "S1ParamSimulation.h"
+
+#include "S1LightMap.h"
+#include "IonizationElectron.h"
+#include "SensorSD.h"
+
+#include <G4ParticleChange.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4Poisson.hh>
+#include <Randomize.hh>
+
+#include <cmath>
+
+
+namespace nexus {
+
+
+  S1ParamSimulation::S1ParamSimulation(S1LightMap* map,
+                                       const G4String& process_name,
+                                       G4ProcessType type):
+    G4VRestDiscreteProcess(process_name, type), map_(map)
+  {
+    if (!map_) {
+      G4Exception("[S1ParamSimulation]", "S1ParamSimulation()",
+                  FatalException, "No S1 light map given to the process.");
+    }
+
+    ParticleChange_ = new G4ParticleChange();
+    pParticleChange = ParticleChange_;
+  }
+
+
+
+  S1ParamSimulation::~S1ParamSimulation()
+  {
+    delete map_;
+    delete ParticleChange_;
+  }
+
+
+
+  G4bool S1ParamSimulation::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (pdef.GetPDGCharge() != 0. && !pdef.IsShortLived() &&
+            &pdef != IonizationElectron::Definition());
+  }
+
+
+
+  void S1ParamSimulation::AddSensitiveDetector(const G4String& sdname)
+  {
+    sensdets_.AddSensitiveDetector(sdname);
+  }
+
+
+
+  G4double S1ParamSimulation::GetMeanFreePath(const G4Track&, G4double,
+                                              G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+
+
+  G4double S1ParamSimulation::GetMeanLifeTime(const G4Track&,
+                                              G4ForceCondition* condition)
+  {
+    *condition = Forced;
+    return DBL_MAX;
+  }
+
+
+
+  G4VParticleChange* S1ParamSimulation::AtRestDoIt(const G4Track& track,
+                                                   const G4Step& step)
+  {
+    return S1ParamSimulation::PostStepDoIt(track, step);
+  }
+
+
+
+  G4VParticleChange* S1ParamSimulation::PostStepDoIt(const G4Track& track,
+                                                     const G4Step& step)
+  {
+    ParticleChange_->Initialize(track);
+
+    G4double edep = step.GetTotalEnergyDeposit();
+    G4MaterialPropertiesTable* mpt =
+      track.GetMaterial()->GetMaterialPropertiesTable();
+
+    if (edep <= 0. || !mpt || !mpt->ConstPropertyExists("SCINTILLATIONYIELD"))
+      return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+
+    // Steps outside the map produce no detected light
+    const G4StepPoint* pre  = step.GetPreStepPoint();
+    const G4StepPoint* post = step.GetPostStepPoint();
+    G4int voxel = map_->GetVoxel(0.5 * (pre->GetPosition() + post->GetPosition()));
+    if (voxel < 0)
+      return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+
+    // Number of photons emitted, as in G4Scintillation
+    G4double mean = mpt->GetConstProperty("SCINTILLATIONYIELD") * edep;
+    G4double resolution = mpt->ConstPropertyExists("RESOLUTIONSCALE") ?
+      mpt->GetConstProperty("RESOLUTIONSCALE") : 1.;
+
+    G4int num_photons;
+    if (mean > 10.) {
+      G4double sigma = resolution * std::sqrt(mean);
+      num_photons = std::max(0, G4int(G4RandGauss::shoot(mean, sigma) + 0.5));
+    }
+    else {
+      num_photons = G4int(G4Poisson(mean));
+    }
+
+    // Share the photons among the sensors of the voxel (multinomial
+    // sampling, the rest being undetected) and register them
+    G4double t0 = pre->GetGlobalTime();
+    G4double dt = post->GetGlobalTime() - t0;
+
+    G4int remaining = num_photons;
+    G4double prob_left = 1.;
+
+    for (size_t i=0; i<map_->GetNumSensors(voxel) && remaining > 0; ++i) {
+      G4double prob = map_->GetProbability(voxel, i);
+      if (prob <= 0.) continue;
+
+      G4int detected = (prob >= prob_left) ? remaining :
+        G4int(CLHEP::RandBinomial::shoot(remaining, prob/prob_left));
+      remaining -= detected;
+      prob_left -= prob;
+
+      if (detected == 0) continue;
+
+      G4int sensor_id = map_->GetSensorID(voxel, i);
+      SensorSD* sd = sensdets_.Find(sensor_id);
+      if (!sd) continue;
+
+      for (G4int j=0; j<detected; ++j) {
+        G4double time = t0 + G4UniformRand() * dt +
+          SampleEmissionDelay(mpt) + map_->SampleArrivalTime(voxel);
+        sd->AddDetectedPhotons(sensor_id, time, 1);
+      }
+    }
+
+    return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+  }
+
+
+
+  G4double S1ParamSimulation::SampleEmissionDelay(G4MaterialPropertiesTable* mpt) const
+  {
+    if (!mpt->ConstPropertyExists("FASTTIMECONSTANT")) return 0.;
+
+    G4double tau = mpt->GetConstProperty("FASTTIMECONSTANT");
+
+    // Fraction of the photons emitted by the fast component
+    if (mpt->ConstPropertyExists("SLOWTIMECONSTANT") &&
+        mpt->ConstPropertyExists("YIELDRATIO") &&
+        G4UniformRand() >= mpt->GetConstProperty("YIELDRATIO"))
+      tau = mpt->GetConstProperty("SLOWTIMECONSTANT");
+
+    return (tau > 0.) ? G4RandExponential::shoot(tau) : 0.;
+  }
+
+
+} // end namespace nexus
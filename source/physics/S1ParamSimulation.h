@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+// nexus | S1ParamSimulation.h
+//
+// This class implements a parametrized simulation of the primary
+// scintillation light: the photons detected by the sensors are sampled
+// from an S1 light map instead of being tracked.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef S1_PARAM_SIMULATION_H
+#define S1_PARAM_SIMULATION_H
+
+#include "SensorSDLookup.h"
+
+#include <G4VRestDiscreteProcess.hh>
+
+class G4ParticleChange;
+
+
+namespace nexus {
+
+  class S1LightMap;
+
+  class S1ParamSimulation: public G4VRestDiscreteProcess
+  {
+  public:
+    /// Constructor taking the light map, which is
+    /// owned by the process from then on
+    S1ParamSimulation(S1LightMap* map,
+                      const G4String& process_name = "S1Parametrization",
+                      G4ProcessType type=fUserDefined);
+    /// Destructor
+    ~S1ParamSimulation();
+
+    /// Returns true for charged particles other than ionization electrons
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Add a sensitive detector (full path name) whose
+    /// sensors are read from the light map
+    void AddSensitiveDetector(const G4String& sdname);
+
+  public:
+    /// The number of scintillation photons emitted in the step is
+    /// computed as in G4Scintillation from the scintillation yield of
+    /// the material. They are shared among the sensors following the
+    /// detection probabilities of the voxel of the step midpoint, and
+    /// the detected photons are added to the sensor hits with the time
+    /// of emission plus an arrival time sampled from the map.
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+    G4VParticleChange* AtRestDoIt(const G4Track&, const G4Step&);
+
+  private:
+    /// Return infinity; i.e., the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the DoIt to be
+    /// invoked at every step.
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+    /// Return infinity, with the 'Forced' condition for the DoIt
+    /// to be invoked for every stopping particle.
+    G4double GetMeanLifeTime(const G4Track&, G4ForceCondition*);
+
+    /// Sample the emission delay of a photon from the
+    /// scintillation time constants of the material
+    G4double SampleEmissionDelay(G4MaterialPropertiesTable*) const;
+
+  private:
+    G4ParticleChange* ParticleChange_;
+
+    S1LightMap* map_;
+
+    SensorSDLookup sensdets_; ///< Sensitive detectors of the map sensors
+  };
+
+} // end namespace nexus
+
+#endif
@@ -13,6 +13,7 @@
 #include <Randomize.hh>
 
 #include <math.h>
+#include <cmath>
 #include "CLHEP/Units/SystemOfUnits.h"
 
 
@@ -43,6 +44,19 @@ namespace nexus {
 
   G4double UniformElectricDriftField::Drift(G4LorentzVector& xyzt)
   {
+    G4double transv_spread, time_spread;
+    return DriftGroup(xyzt, 1., transv_spread, time_spread);
+  }
+
+
+
+  G4double UniformElectricDriftField::DriftGroup(G4LorentzVector& xyzt,
+                                                 G4double weight,
+                                                 G4double& transv_spread,
+                                                 G4double& time_spread)
+  {
+    transv_spread = time_spread = 0.;
+
     // If the origin is not between anode and cathode,
     // the charge carrier, obviously, doesn't move.
     if (!CheckCoordinate(xyzt[axis_]))
@@ -61,6 +75,17 @@ namespace nexus {
     G4double longit_sigma = longit_diff_ * sqrt(drift_length);
     G4double time_sigma = longit_sigma / drift_velocity_;
 
+    // For a group of electrons, the centroid diffuses with the
+    // single-electron sigma over sqrt(weight), and the electrons
+    // spread around it with the rest of the variance
+    if (weight > 1.) {
+      G4double spread = std::sqrt(1. - 1./weight);
+      transv_spread = transv_sigma * spread;
+      time_spread   = time_sigma * spread;
+      transv_sigma /= std::sqrt(weight);
+      time_sigma   /= std::sqrt(weight);
+    }
+
     G4ThreeVector position;
     G4double time;
 
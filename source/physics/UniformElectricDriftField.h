@@ -36,6 +36,11 @@ namespace nexus {
     /// of an ionization electron
     G4double Drift(G4LorentzVector& xyzt);
 
+    /// Drift of a group of ionization electrons: the diffusion of the
+    /// centroid is reduced by the square root of the number of electrons
+    G4double DriftGroup(G4LorentzVector& xyzt, G4double weight,
+                        G4double& transv_spread, G4double& time_spread);
+
     G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
 
     // Setters/getters
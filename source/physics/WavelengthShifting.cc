@@ -22,7 +22,7 @@ namespace nexus {
   using namespace CLHEP;
 
   WavelengthShifting::WavelengthShifting(const G4String& name, G4ProcessType type):
-    G4VDiscreteProcess(name, type), wlsIntegralTable_(0)
+    G4VDiscreteProcess(name, type)
   {
     ParticleChange_ = new G4ParticleChange();
     pParticleChange = ParticleChange_;
@@ -36,10 +36,6 @@ namespace nexus {
   WavelengthShifting::~WavelengthShifting()
   {
     delete ParticleChange_;
-    if (wlsIntegralTable_ != 0) {
-      wlsIntegralTable_->clearAndDestroy();
-      delete wlsIntegralTable_;
-    }
     delete WLSTimeGeneratorProfile_;
   }
 
@@ -53,19 +49,10 @@ namespace nexus {
     ParticleChange_->Initialize(track);
     ParticleChange_->ProposeTrackStatus(fStopAndKill);
 
-    const G4Material* material = track.GetMaterial();
-
     G4StepPoint* pPostStepPoint = step.GetPostStepPoint();
 
-   G4MaterialPropertiesTable* aMaterialPropertiesTable =
-     material->GetMaterialPropertiesTable();
-   if (!aMaterialPropertiesTable)
-     return G4VDiscreteProcess::PostStepDoIt(track, step);
-
-   G4MaterialPropertyVector* WLS_Conversion_Efficiency=
-     aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
-
-   if (!WLS_Conversion_Efficiency) {
+   const MaterialWLS* wls = GetMaterialWLS(track.GetMaterial());
+   if (!wls) {
      return G4VDiscreteProcess::PostStepDoIt(track, step);
    }
 
@@ -73,7 +60,7 @@ namespace nexus {
 
    G4double thePhotonEnergy = particle->GetTotalEnergy();
    G4double conversion_efficiency =
-     WLS_Conversion_Efficiency->Value(thePhotonEnergy);
+     wls->conversion_efficiency->Value(thePhotonEnergy);
 
    G4double rndm = G4UniformRand();
    if (rndm > conversion_efficiency) {
@@ -81,14 +68,8 @@ namespace nexus {
    }
    ParticleChange_->SetNumberOfSecondaries(1);
 
-   G4int materialIndex = material->GetIndex();
-   G4PhysicsOrderedFreeVector* WLSIntegral  =
-     (G4PhysicsOrderedFreeVector*)((*wlsIntegralTable_)(materialIndex));
-
    // Sample the energy randomly
-   G4double wls_max = WLSIntegral->GetMaxValue();
-   G4double wls_value = G4UniformRand()*wls_max;
-   G4double sampledEnergy = WLSIntegral->GetEnergy(wls_value);
+   G4double sampledEnergy = wls->spectrum.Shoot();
 
    // Generate random photon direction
    G4double costheta = 1. - 2.*G4UniformRand();
@@ -131,8 +112,7 @@ namespace nexus {
    aWLSPhoton->SetKineticEnergy(sampledEnergy);
 
     // Generate new G4Track object and give position of WLS optical photon
-   G4double WLSTime = aMaterialPropertiesTable->GetConstProperty("WLSTIMECONSTANT");
-   G4double TimeDelay = WLSTimeGeneratorProfile_->GenerateTime(WLSTime);
+   G4double TimeDelay = WLSTimeGeneratorProfile_->GenerateTime(wls->time_constant);
    G4double aSecondaryTime = (pPostStepPoint->GetGlobalTime()) + TimeDelay;
    G4ThreeVector aSecondaryPosition = pPostStepPoint->GetPosition();
 
@@ -148,21 +128,17 @@ namespace nexus {
 
   void WavelengthShifting::BuildThePhysicsTable()
   {
-    if (wlsIntegralTable_) return;
+    if (!materials_.empty()) return;
 
     const G4MaterialTable* theMaterialTable =
       G4Material::GetMaterialTable();
     G4int numOfMaterials = G4Material::GetNumberOfMaterials();
 
-    // create new physics table
-    if(!wlsIntegralTable_)
-      wlsIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+    materials_.assign(numOfMaterials, MaterialWLS());
 
     // loop for materials
 
     for (G4int i=0 ; i < numOfMaterials; i++) {
-      G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-	new G4PhysicsOrderedFreeVector();
 
       // Retrieve vector of WLS wavelength intensity for
       // the material from the material's optical properties table.
@@ -172,16 +148,22 @@ namespace nexus {
 	aMaterial->GetMaterialPropertiesTable();
 
       if (aMaterialPropertiesTable) {
+	// Properties needed at every step, so that they are
+	// not looked up by name in the tracking
+	MaterialWLS& wls = materials_[i];
+	wls.conversion_efficiency =
+	  aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
+
 	G4MaterialPropertyVector* theWLSVector =
 	  aMaterialPropertiesTable->GetProperty("WLSCOMPONENT");
 	if (theWLSVector) {
-	  ComputeCumulativeDistribution(*theWLSVector, *aPhysicsOrderedFreeVector);
+	  wls.spectrum = SpectrumSampler(*theWLSVector);
 	}
+
+	if (aMaterialPropertiesTable->ConstPropertyExists("WLSTIMECONSTANT"))
+	  wls.time_constant =
+	    aMaterialPropertiesTable->GetConstProperty("WLSTIMECONSTANT");
       }
-      // The WLS integral for a given material
-      // will be inserted in the table according to the
-      // position of the material in the material table.
-      wlsIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
     }
   }
 
@@ -189,45 +171,22 @@ namespace nexus {
   {
     G4double AttenuationLength = DBL_MAX;
 
-     const G4Material* material = track.GetMaterial();
-     G4MaterialPropertiesTable* aMaterialPropertiesTable = material->GetMaterialPropertiesTable();
-     if (aMaterialPropertiesTable) {
-       G4MaterialPropertyVector* WLS_Conversion_Efficiency=
-	 aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
-       if (WLS_Conversion_Efficiency) {
-	 const G4DynamicParticle* particle = track.GetDynamicParticle();
-
-	 G4double thePhotonEnergy = particle->GetTotalEnergy();
-	 G4double conversion_efficiency =
-	   WLS_Conversion_Efficiency->Value(thePhotonEnergy);
-
-	 // If the photon has zero conversion efficiency, it must not enter the process at all.
-	 if (conversion_efficiency == 0.) {
-	   return AttenuationLength;
-	 }
-	 // ParticleChange_->SetNumberOfSecondaries(1);
-	 AttenuationLength = DBL_MIN;
+     const MaterialWLS* wls = GetMaterialWLS(track.GetMaterial());
+     if (wls) {
+       const G4DynamicParticle* particle = track.GetDynamicParticle();
+
+       G4double thePhotonEnergy = particle->GetTotalEnergy();
+       G4double conversion_efficiency =
+	 wls->conversion_efficiency->Value(thePhotonEnergy);
+
+       // If the photon has zero conversion efficiency, it must not enter the process at all.
+       if (conversion_efficiency == 0.) {
+	 return AttenuationLength;
        }
+       AttenuationLength = DBL_MIN;
      }
 
      return AttenuationLength;
   }
 
-  void WavelengthShifting::ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf,
-							 G4PhysicsOrderedFreeVector& cdf)
-  {
-    if (pdf[0] >= 0.0) {
-      // The first entry of the cumulative distribution function is zero.
-      cdf.InsertValues(pdf.Energy(0), 0.0);
-
-      G4double area_sum = 0.;
-      // loop over all (photon energy, intensity) pairs stored for this material
-      // and add the areas calculated with the trapezoidal rule
-      for (size_t j = 1; j < pdf.GetVectorLength(); j++) {
-	area_sum = cdf[j-1] + (pdf[j-1] + pdf[j]) * (pdf.Energy(j) - pdf.Energy(j-1)) * 0.5 ;
-	cdf.InsertValues(pdf.Energy(j), area_sum);
-      }
-    }
-  }
-
 }
@@ -12,7 +12,12 @@
 #ifndef WLS_H
 #define WLS_H
 
+#include "SpectrumSampler.h"
+
 #include <G4VDiscreteProcess.hh>
+#include <G4Material.hh>
+
+#include <vector>
 
 class G4ParticleChange;
 class G4VWLSTimeGeneratorProfile;
@@ -32,16 +37,38 @@ namespace nexus {
     G4double GetMeanFreePath(const G4Track& track, G4double, G4ForceCondition*);
 
   private:
+    /// WLS properties of a material, cached when the physics table is built
+    struct MaterialWLS {
+      G4MaterialPropertyVector* conversion_efficiency = 0;
+      SpectrumSampler spectrum; ///< Sampler of the WLS spectrum
+      G4double time_constant = 0.;
+    };
+
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf, G4PhysicsOrderedFreeVector& cdf);
+
+    /// Returns the WLS properties of a material, or null if
+    /// it has no conversion efficiency or WLS spectrum
+    const MaterialWLS* GetMaterialWLS(const G4Material*) const;
 
   private:
     G4ParticleChange* ParticleChange_;
-    G4PhysicsTable* wlsIntegralTable_;
     G4VWLSTimeGeneratorProfile*  WLSTimeGeneratorProfile_;
+    std::vector<MaterialWLS> materials_; ///< WLS properties by material index
 
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline const WavelengthShifting::MaterialWLS*
+  WavelengthShifting::GetMaterialWLS(const G4Material* material) const
+  {
+    size_t index = material->GetIndex();
+    if (index >= materials_.size() || !materials_[index].conversion_efficiency ||
+        materials_[index].spectrum.IsEmpty())
+      return 0;
+    return &materials_[index];
+  }
+
 }
 
 #endif
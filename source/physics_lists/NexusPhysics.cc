@@ -14,6 +14,11 @@
 #include "Electroluminescence.h"
 #include "WavelengthShifting.h"
 #include "OpPhotoelectricEffect.h"
+#include "ELLookupTable.h"
+#include "ELParamSimulation.h"
+#include "S1LightMap.h"
+#include "S1ParamSimulation.h"
+#include "AnalyticDrift.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4OpticalPhoton.hh>
@@ -21,6 +26,7 @@
 #include <G4ProcessTable.hh>
 #include <G4StepLimiter.hh>
 #include <G4FastSimulationManagerProcess.hh>
+#include <G4RegionStore.hh>
 #include <G4PhysicsConstructorFactory.hh>
 
 
@@ -34,7 +40,9 @@ namespace nexus {
 
   NexusPhysics::NexusPhysics():
     G4VPhysicsConstructor("NexusPhysics"),
-    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false)
+    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false),
+    analytic_drift_(false),
+    el_table_(""), el_photons_per_electron_(0.), s1_map_("")
   {
     msg_ = new G4GenericMessenger(this, "/PhysicsList/Nexus/",
       "Control commands of the nexus physics list.");
@@ -51,6 +59,27 @@ namespace nexus {
     msg_->DeclareProperty("photoelectric", photoelectric_,
       "Switch on/off the photoelectric effect.");
 
+    msg_->DeclareProperty("analytic_drift", analytic_drift_,
+      "Drift the ionization electrons analytically instead of tracking them.");
+
+    msg_->DeclareProperty("el_table", el_table_,
+      "Light table for the fast simulation of the EL (none by default).");
+
+    msg_->DeclareMethod("el_table_sensdet", &NexusPhysics::AddELTableSensitiveDetector,
+      "Sensitive detector (full path name) of the sensors of the EL light table.");
+
+    G4GenericMessenger::Command& yield_cmd =
+      msg_->DeclareProperty("el_photons_per_electron", el_photons_per_electron_,
+      "EL photons per electron in the fast simulation (0 = from the EL field).");
+    yield_cmd.SetParameterName("el_photons_per_electron", false);
+    yield_cmd.SetRange("el_photons_per_electron>=0.");
+
+    msg_->DeclareProperty("s1_map", s1_map_,
+      "Light map for the fast simulation of the S1 (none by default).");
+
+    msg_->DeclareMethod("s1_map_sensdet", &NexusPhysics::AddS1MapSensitiveDetector,
+      "Sensitive detector (full path name) of the sensors of the S1 light map.");
+
   }
 
 
@@ -62,6 +91,20 @@ namespace nexus {
 
 
 
+  void NexusPhysics::AddELTableSensitiveDetector(G4String sdname)
+  {
+    el_table_sds_.push_back(sdname);
+  }
+
+
+
+  void NexusPhysics::AddS1MapSensitiveDetector(G4String sdname)
+  {
+    s1_map_sds_.push_back(sdname);
+  }
+
+
+
   void NexusPhysics::ConstructParticle()
   {
     IonizationElectron::Definition();
@@ -104,11 +147,35 @@ namespace nexus {
       pmanager->AddDiscreteProcess(drift);
     }
 
+    Electroluminescence* el = 0;
     if (electroluminescence_) {
-      Electroluminescence* el = new Electroluminescence();
+      el = new Electroluminescence();
       pmanager->AddDiscreteProcess(el);
     }
 
+    // Fast simulation of the EL light from a light table: the ie-
+    // entering the EL region are replaced by the detected photons
+
+    ELParamSimulation* model = 0;
+    if (el_table_ != "") {
+      G4Region* region =
+        G4RegionStore::GetInstance()->GetRegion("EL_REGION", false);
+      if (!region) {
+        G4Exception("[NexusPhysics]", "ConstructProcess()", FatalException,
+          "The EL fast simulation requires a geometry with an EL_REGION.");
+      }
+
+      ELLookupTable* table = new ELLookupTable(el_table_);
+      table->Print();
+
+      model = new ELParamSimulation(region, table);
+      model->SetPhotonsPerElectron(el_photons_per_electron_);
+      for (const auto& sdname : el_table_sds_)
+        model->AddSensitiveDetector(sdname);
+
+      pmanager->AddDiscreteProcess(new G4FastSimulationManagerProcess());
+    }
+
 
     // Add clustering to all pertinent particles
 
@@ -116,6 +183,17 @@ namespace nexus {
 
       IonizationClustering* clust = new IonizationClustering();
 
+      // In the analytic drift mode the ionization electrons are not
+      // tracked: they are drifted by the clustering process, which
+      // produces their EL light (or the detected photons directly,
+      // with the EL fast simulation)
+      if (analytic_drift_) {
+        AnalyticDrift* analytic = new AnalyticDrift();
+        analytic->SetElectroluminescence(el);
+        analytic->SetELParamSimulation(model);
+        clust->SetAnalyticDrift(analytic);
+      }
+
       auto aParticleIterator = GetParticleIterator();
       aParticleIterator->reset();
       while ((*aParticleIterator)()) {
@@ -129,6 +207,32 @@ namespace nexus {
       }
     }
 
+    // Fast simulation of the S1 light from a light map: the photons
+    // detected are sampled at every step with energy deposition.
+    // The scintillation process of the optical physics should be
+    // switched off (/process/inactivate Scintillation).
+
+    if (s1_map_ != "") {
+      S1LightMap* map = new S1LightMap(s1_map_);
+      map->Print();
+
+      S1ParamSimulation* s1 = new S1ParamSimulation(map);
+      for (const auto& sdname : s1_map_sds_)
+        s1->AddSensitiveDetector(sdname);
+
+      auto aParticleIterator = GetParticleIterator();
+      aParticleIterator->reset();
+      while ((*aParticleIterator)()) {
+        G4ParticleDefinition* particle = aParticleIterator->value();
+
+        if (s1->IsApplicable(*particle)) {
+          pmanager = particle->GetProcessManager();
+          pmanager->AddDiscreteProcess(s1);
+          pmanager->AddRestProcess(s1);
+        }
+      }
+    }
+
     // Add photoelectric effect to optical photons
 
     if (photoelectric_) {
@@ -11,6 +11,8 @@
 
 #include <G4VPhysicsConstructor.hh>
 
+#include <vector>
+
 class G4GenericMessenger;
 
 
@@ -29,11 +31,26 @@ namespace nexus {
     /// Construct all required physics processes (Geant4 mandatory method)
     virtual void ConstructProcess();
 
+    /// Add a sensitive detector whose sensors are read from
+    /// the light table of the EL fast simulation
+    void AddELTableSensitiveDetector(G4String);
+    /// Add a sensitive detector whose sensors are read from
+    /// the light map of the S1 fast simulation
+    void AddS1MapSensitiveDetector(G4String);
+
   private:
     G4bool clustering_;          ///< Switch on/of the ionization clustering
     G4bool drift_;               ///< Switch on/of the ionization drift
     G4bool electroluminescence_; ///< Switch on/off the electroluminescence
     G4bool photoelectric_;       ///< Switch on/off the photoelectric effect
+    G4bool analytic_drift_;      ///< Switch on/off the analytic drift of the ie-
+
+    G4String el_table_; ///< Light table of the EL fast simulation
+    std::vector<G4String> el_table_sds_; ///< Sensitive detectors of the table
+    G4double el_photons_per_electron_;  ///< EL photons per ie- (0 = from field)
+
+    G4String s1_map_; ///< Light map of the S1 fast simulation
+    std::vector<G4String> s1_map_sds_; ///< Sensitive detectors of the map
 
     G4GenericMessenger* msg_;
   };
@@ -1,8 +1,8 @@
 // ----------------------------------------------------------------------------
 // nexus | IonizationHit.cc
 //
-// This class describes the ionization deposit left by a particle
-// in a sensitive volume.
+// These classes describe the ionization deposits left by particles
+// in a sensitive volume during an event.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,44 +13,49 @@
 namespace nexus {
 
 
-  G4Allocator<IonizationHit> IonizationHitAllocator;
-
-
-
-  IonizationHit::IonizationHit(): G4VHit()
+  IonizationHitBuffer::IonizationHitBuffer(size_t capacity)
   {
+    track_id_  .reserve(capacity);
+    x_         .reserve(capacity);
+    y_         .reserve(capacity);
+    z_         .reserve(capacity);
+    time_      .reserve(capacity);
+    energy_dep_.reserve(capacity);
   }
 
 
 
-  IonizationHit::IonizationHit(const IonizationHit& other): G4VHit()
+  IonizationHitBuffer::~IonizationHitBuffer()
   {
-    *this = other;
   }
 
 
 
-  IonizationHit::~IonizationHit()
+  void IonizationHitBuffer::Clear()
   {
+    // std::vector::clear() keeps the capacity of the vectors,
+    // so no memory is released or reallocated between events.
+    track_id_  .clear();
+    x_         .clear();
+    y_         .clear();
+    z_         .clear();
+    time_      .clear();
+    energy_dep_.clear();
   }
 
 
 
-  const IonizationHit& IonizationHit::operator=(const IonizationHit& other)
+  IonizationHitsCollection::IonizationHitsCollection(const G4String& sdname,
+                                                     const G4String& colname,
+                                                     const IonizationHitBuffer* buffer):
+    G4VHitsCollection(sdname, colname), buffer_(buffer)
   {
-    track_id_   = other.track_id_;
-    time_       = other.time_;
-    energy_dep_ = other.energy_dep_;
-    position_   = other.position_;
-
-    return *this;
   }
 
 
 
-  G4int IonizationHit::operator==(const IonizationHit& other) const
+  IonizationHitsCollection::~IonizationHitsCollection()
   {
-    return (this==&other) ? 1 : 0;
   }
 
 
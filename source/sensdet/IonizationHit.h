@@ -1,8 +1,8 @@
 // ----------------------------------------------------------------------------
 // nexus | IonizationHit.h
 //
-// This class describes the ionization deposit left by a particle
-// in a sensitive volume.
+// These classes describe the ionization deposits left by particles
+// in a sensitive volume during an event.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -10,82 +10,111 @@
 #ifndef IONIZATION_HIT_H
 #define IONIZATION_HIT_H
 
-#include <G4VHit.hh>
-#include <G4THitsCollection.hh>
-#include <G4Allocator.hh>
+#include <G4VHitsCollection.hh>
 #include <G4ThreeVector.hh>
 
+#include <vector>
+
 
 namespace nexus {
 
-  /// Ionization deposit left by a particle in an active volume
+  /// Ionization deposits left by particles in an active volume,
+  /// stored as a structure of arrays of plain data. The buffer is owned
+  /// by the sensitive detector and reused from event to event: Clear()
+  /// resets its size but keeps the allocated capacity, so the arrays only
+  /// grow (geometrically) in the first events with many deposits.
 
-  class IonizationHit: public G4VHit
+  class IonizationHitBuffer
   {
   public:
-    /// Constructor
-    IonizationHit();
-    /// Copy constructor
-    IonizationHit(const IonizationHit&);
+    /// Constructor reserving room for a given number of deposits
+    IonizationHitBuffer(size_t capacity=1024);
     /// Destructor
-    virtual ~IonizationHit();
+    ~IonizationHitBuffer();
 
-    /// Assignement operator
-    const IonizationHit& operator=(const IonizationHit&);
-    /// Equality operator
-    G4int operator==(const IonizationHit&) const;
-    /// Memory allocation
-    void* operator new(size_t);
-    /// Memory deallocation
-    void operator delete(void*);
-
-  public:
-    G4int GetTrackID();
-    void SetTrackID(G4int);
+    /// Appends a deposit to the buffer
+    void Add(G4int track_id, const G4ThreeVector& xyz,
+             G4double time, G4double energy_dep);
 
-    G4double GetTime();
-    void SetTime(G4double);
+    /// Removes all deposits without releasing memory
+    void Clear();
 
-    G4double GetEnergyDeposit();
-    void SetEnergyDeposit(G4double);
+    /// Returns the number of deposits stored
+    size_t Size() const;
 
-    G4ThreeVector GetPosition();
-    void SetPosition(G4ThreeVector);
+    const std::vector<G4int>&    GetTrackID()       const;
+    const std::vector<G4double>& GetX()             const;
+    const std::vector<G4double>& GetY()             const;
+    const std::vector<G4double>& GetZ()             const;
+    const std::vector<G4double>& GetTime()          const;
+    const std::vector<G4double>& GetEnergyDeposit() const;
 
   private:
-    G4int track_id_;
-    G4double time_;
-    G4double energy_dep_;
-    G4ThreeVector position_;
+    std::vector<G4int>    track_id_;
+    std::vector<G4double> x_, y_, z_;
+    std::vector<G4double> time_;
+    std::vector<G4double> energy_dep_;
   };
 
 
-  typedef G4THitsCollection<IonizationHit> IonizationHitsCollection;
-  extern G4Allocator<IonizationHit> IonizationHitAllocator;
+  /// Collection of hits that gives access to the deposit buffer of an
+  /// IonizationSD. It does not own the buffer, so its deletion at the
+  /// end of the event does not free the deposits memory. The name of the
+  /// sensitive detector (GetSDname()) is the label of all its deposits.
 
+  class IonizationHitsCollection: public G4VHitsCollection
+  {
+  public:
+    /// Constructor
+    IonizationHitsCollection(const G4String& sdname, const G4String& colname,
+                             const IonizationHitBuffer* buffer);
+    /// Destructor
+    virtual ~IonizationHitsCollection();
 
-  // INLINE DEFINITIONS //////////////////////////////////////////////
-
-  inline void* IonizationHit::operator new(size_t)
-  { return ((void*) IonizationHitAllocator.MallocSingle()); }
-
-  inline void IonizationHit::operator delete(void* aHit)
-  { IonizationHitAllocator.FreeSingle((IonizationHit*) aHit); }
+    /// Returns the number of deposits in the collection
+    virtual size_t GetSize() const;
 
-  inline G4int IonizationHit::GetTrackID() { return track_id_; }
-  inline void IonizationHit::SetTrackID(G4int id) { track_id_ = id; }
+    /// Returns the buffer holding the deposits
+    const IonizationHitBuffer& GetBuffer() const;
 
-  inline G4double IonizationHit::GetTime() { return time_; }
-  inline void IonizationHit::SetTime(G4double t) { time_ = t; }
+  private:
+    const IonizationHitBuffer* buffer_;
+  };
 
-  inline G4double IonizationHit::GetEnergyDeposit() { return energy_dep_; }
-  inline void IonizationHit::SetEnergyDeposit(G4double edep)
-  { energy_dep_ = edep; }
 
-  inline G4ThreeVector IonizationHit::GetPosition() { return position_; }
-  inline void IonizationHit::SetPosition(G4ThreeVector xyz)
-  { position_ = xyz; }
+  // INLINE DEFINITIONS //////////////////////////////////////////////
 
+  inline void IonizationHitBuffer::Add(G4int track_id, const G4ThreeVector& xyz,
+                                       G4double time, G4double energy_dep)
+  {
+    track_id_  .push_back(track_id);
+    x_         .push_back(xyz.x());
+    y_         .push_back(xyz.y());
+    z_         .push_back(xyz.z());
+    time_      .push_back(time);
+    energy_dep_.push_back(energy_dep);
+  }
+
+  inline size_t IonizationHitBuffer::Size() const { return track_id_.size(); }
+
+  inline const std::vector<G4int>& IonizationHitBuffer::GetTrackID() const
+  { return track_id_; }
+  inline const std::vector<G4double>& IonizationHitBuffer::GetX() const
+  { return x_; }
+  inline const std::vector<G4double>& IonizationHitBuffer::GetY() const
+  { return y_; }
+  inline const std::vector<G4double>& IonizationHitBuffer::GetZ() const
+  { return z_; }
+  inline const std::vector<G4double>& IonizationHitBuffer::GetTime() const
+  { return time_; }
+  inline const std::vector<G4double>& IonizationHitBuffer::GetEnergyDeposit() const
+  { return energy_dep_; }
+
+  inline size_t IonizationHitsCollection::GetSize() const
+  { return buffer_->Size(); }
+
+  inline const IonizationHitBuffer& IonizationHitsCollection::GetBuffer() const
+  { return *buffer_; }
 
 } // end namespace nexus
 
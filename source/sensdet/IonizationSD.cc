@@ -24,7 +24,8 @@ using namespace nexus;
 
 
 IonizationSD::IonizationSD(const G4String& name):
-  G4VSensitiveDetector(name), include_(true)
+  G4VSensitiveDetector(name), include_(true),
+  last_track_id_(-1), last_trj_(0)
 {
   collectionName.insert(GetCollectionUniqueName());
 }
@@ -47,15 +48,19 @@ G4String IonizationSD::GetCollectionUniqueName()
 
 void IonizationSD::Initialize(G4HCofThisEvent* hce)
 {
-  // Create a collection of ionization hits and add it to
-  // the collection of hits of the event
+  // Reset the buffer of deposits (keeping its memory) and add
+  // a collection giving access to it to the collections of the event
 
-  IHC_ =
-    new IonizationHitsCollection(SensitiveDetectorName, collectionName[0]);
+  buffer_.Clear();
+  last_track_id_ = -1;
+  last_trj_      = 0;
+
+  IonizationHitsCollection* IHC =
+    new IonizationHitsCollection(SensitiveDetectorName, collectionName[0], &buffer_);
 
   G4int hcid =
     G4SDManager::GetSDMpointer()->GetCollectionID(SensitiveDetectorName+"/"+collectionName[0]);
-  hce->AddHitsCollection(hcid, IHC_);
+  hce->AddHitsCollection(hcid, IHC);
 
 }
 
@@ -74,24 +79,23 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   // Discard steps where no energy was deposited in the detector
   if (edep <= 0.) return false;
 
-  // Create a hit and set its properties
-  IonizationHit* hit = new IonizationHit();
-  hit->SetTrackID(step->GetTrack()->GetTrackID());
-  hit->SetTime(step->GetTrack()->GetGlobalTime());
-  hit->SetEnergyDeposit(edep);
-  hit->SetPosition(step->GetPostStepPoint()->GetPosition());
+  G4int track_id = track->GetTrackID();
 
-  // Add hit to collection
-  IHC_->insert(hit);
+  // Store the deposit in the buffer
+  buffer_.Add(track_id, step->GetPostStepPoint()->GetPosition(),
+              track->GetGlobalTime(), edep);
 
   // Add energy deposit to the trajectory associated
-  // to the current track
+  // to the current track. Consecutive steps usually belong to the
+  // same track, so the trajectory is only looked up when it changes.
   if (include_) {
-    Trajectory* trj =
-      (Trajectory*) TrajectoryMap::Get(step->GetTrack()->GetTrackID());
-    if (trj) {
-      edep += trj->GetEnergyDeposit();
-      trj->SetEnergyDeposit(edep);
+    if (track_id != last_track_id_) {
+      last_trj_      = (Trajectory*) TrajectoryMap::Get(track_id);
+      last_track_id_ = track_id;
+    }
+    if (last_trj_) {
+      edep += last_trj_->GetEnergyDeposit();
+      last_trj_->SetEnergyDeposit(edep);
     }
   }
 
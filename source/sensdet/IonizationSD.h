@@ -19,6 +19,8 @@ class G4TouchableHistory;
 
 namespace nexus {
 
+  class Trajectory;
+
   /// Sensitive detector to create ionization hits
 
   class IonizationSD: public G4VSensitiveDetector
@@ -47,9 +49,12 @@ namespace nexus {
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
   private:
-    IonizationHitsCollection* IHC_;
+    IonizationHitBuffer buffer_; ///< Deposits of the current event
     G4String det_name_;
     G4bool include_;
+
+    G4int last_track_id_;   ///< ID of the track that made the last deposit
+    Trajectory* last_trj_;  ///< Trajectory of that track
   };
 
   inline void IonizationSD::IncludeInTotalEnergyDeposit(G4bool inc)
@@ -0,0 +1,251 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDigitizer.cc
+//
+// This class applies the response of the sensor electronics (gain,
+// dark counts, crosstalk, afterpulsing and pulse shape) to the photons
+// detected by a type of photosensor and produces digitized waveforms.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorDigitizer.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4Poisson.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace nexus {
+
+
+  SensorDigitizer::SensorDigitizer(const G4String& msg_dir):
+    msg_(0), enabled_(false), keep_photons_(true),
+    gain_(1.), gain_spread_(0.), dark_rate_(0.), crosstalk_(0.),
+    afterpulse_prob_(0.), afterpulse_time_(0.), rise_time_(0.),
+    fall_time_(0.), window_(0.), threshold_(0.), pde_(1.), pulse_bin_size_(0.)
+  {
+    msg_ = new G4GenericMessenger(this, msg_dir,
+                                  "Control commands of the sensor digitization.");
+
+    msg_->DeclareProperty("enable", enabled_,
+                          "Digitize the photons detected by the sensors.");
+
+    msg_->DeclareProperty("keep_photons", keep_photons_,
+                          "Store also the histograms of detected photons.");
+
+    G4GenericMessenger::Command& gain_cmd =
+      msg_->DeclareProperty("gain", gain_, "ADC counts per photoelectron.");
+    gain_cmd.SetParameterName("gain", false);
+    gain_cmd.SetRange("gain>=0.");
+
+    G4GenericMessenger::Command& spread_cmd =
+      msg_->DeclareProperty("gain_spread", gain_spread_,
+                            "Relative spread (sigma) of the gain.");
+    spread_cmd.SetParameterName("gain_spread", false);
+    spread_cmd.SetRange("gain_spread>=0.");
+
+    G4GenericMessenger::Command& dark_cmd =
+      msg_->DeclareProperty("dark_rate", dark_rate_, "Dark count rate per sensor.");
+    dark_cmd.SetUnitCategory("Frequency");
+    dark_cmd.SetParameterName("dark_rate", false);
+    dark_cmd.SetRange("dark_rate>=0.");
+
+    G4GenericMessenger::Command& xtalk_cmd =
+      msg_->DeclareProperty("crosstalk", crosstalk_,
+                            "Probability of optical crosstalk per avalanche.");
+    xtalk_cmd.SetParameterName("crosstalk", false);
+    xtalk_cmd.SetRange("crosstalk>=0. && crosstalk<1.");
+
+    G4GenericMessenger::Command& ap_cmd =
+      msg_->DeclareProperty("afterpulse_prob", afterpulse_prob_,
+                            "Probability of afterpulse per avalanche.");
+    ap_cmd.SetParameterName("afterpulse_prob", false);
+    ap_cmd.SetRange("afterpulse_prob>=0. && afterpulse_prob<=1.");
+
+    G4GenericMessenger::Command& ap_time_cmd =
+      msg_->DeclareProperty("afterpulse_time", afterpulse_time_,
+                            "Mean delay of the afterpulses.");
+    ap_time_cmd.SetUnitCategory("Time");
+    ap_time_cmd.SetParameterName("afterpulse_time", false);
+    ap_time_cmd.SetRange("afterpulse_time>=0.");
+
+    G4GenericMessenger::Command& rise_cmd =
+      msg_->DeclareProperty("pulse_rise_time", rise_time_,
+                            "Rise time constant of the single-photoelectron pulse.");
+    rise_cmd.SetUnitCategory("Time");
+    rise_cmd.SetParameterName("pulse_rise_time", false);
+    rise_cmd.SetRange("pulse_rise_time>=0.");
+
+    G4GenericMessenger::Command& fall_cmd =
+      msg_->DeclareProperty("pulse_fall_time", fall_time_,
+                            "Fall time constant of the single-photoelectron pulse "
+                            "(0 means no pulse shaping).");
+    fall_cmd.SetUnitCategory("Time");
+    fall_cmd.SetParameterName("pulse_fall_time", false);
+    fall_cmd.SetRange("pulse_fall_time>=0.");
+
+    G4GenericMessenger::Command& window_cmd =
+      msg_->DeclareProperty("window", window_,
+                            "Acquisition window for dark counts "
+                            "(0 means up to the last detected photon).");
+    window_cmd.SetUnitCategory("Time");
+    window_cmd.SetParameterName("window", false);
+    window_cmd.SetRange("window>=0.");
+
+    G4GenericMessenger::Command& threshold_cmd =
+      msg_->DeclareProperty("threshold", threshold_,
+                            "Minimum amplitude (ADC counts) of the samples stored.");
+    threshold_cmd.SetParameterName("threshold", false);
+    threshold_cmd.SetRange("threshold>=0.");
+
+    G4GenericMessenger::Command& pde_cmd =
+      msg_->DeclareProperty("pde", pde_,
+                            "Probability of a detected photon to give a photoelectron.");
+    pde_cmd.SetParameterName("pde", false);
+    pde_cmd.SetRange("pde>=0. && pde<=1.");
+  }
+
+
+
+  SensorDigitizer::~SensorDigitizer()
+  {
+    delete msg_;
+  }
+
+
+
+  void SensorDigitizer::ComputePulseShape(G4double bin_size)
+  {
+    pulse_.clear();
+    pulse_bin_size_ = bin_size;
+    pulse_pars_ = {rise_time_, fall_time_};
+
+    // No shaping: all the charge goes to the bin of the photoelectron
+    if (fall_time_ <= 0.) {
+      pulse_.push_back(1.);
+      return;
+    }
+
+    if (rise_time_ >= fall_time_) {
+      G4Exception("[SensorDigitizer]", "ComputePulseShape()", FatalException,
+                  "The pulse rise time must be smaller than the fall time.");
+    }
+
+    // Double exponential pulse, sampled at the center of the bins
+    // up to five times its time constants
+    G4double length = 5. * (rise_time_ + fall_time_);
+    G4int nbins = std::max(1, G4int(std::ceil(length/bin_size)));
+
+    G4double norm = 0.;
+    for (G4int i=0; i<nbins; ++i) {
+      G4double t = (i + 0.5) * bin_size;
+      G4double value = std::exp(-t/fall_time_);
+      if (rise_time_ > 0.) value -= std::exp(-t/rise_time_);
+      pulse_.push_back(value);
+      norm += value;
+    }
+
+    for (auto& value : pulse_) value /= norm;
+  }
+
+
+
+  void SensorDigitizer::AddAvalanches(G4double time,
+                                      std::vector<G4double>& pes) const
+  {
+    // The primary avalanche can trigger further ones in neighbouring
+    // cells (optical crosstalk), which can trigger others in turn
+    G4int num_avalanches = 1;
+    while (G4UniformRand() < crosstalk_) ++num_avalanches;
+
+    for (G4int i=0; i<num_avalanches; ++i) {
+      pes.push_back(time);
+      if (afterpulse_prob_ > 0. && G4UniformRand() < afterpulse_prob_)
+        pes.push_back(time + G4RandExponential::shoot(afterpulse_time_));
+    }
+  }
+
+
+
+  void SensorDigitizer::Digitize(const SensorHitsCollection* hits,
+                                 const std::map<G4int, SensorChannel>& channels,
+                                 G4double bin_size,
+                                 SensorWaveformsCollection* waveforms)
+  {
+    if (bin_size <= 0.) {
+      G4Exception("[SensorDigitizer]", "Digitize()", FatalException,
+                  "Sensors without time binning cannot be digitized.");
+    }
+
+    std::vector<G4double> pars = {rise_time_, fall_time_};
+    if (pulse_.empty() || bin_size != pulse_bin_size_ || pars != pulse_pars_)
+      ComputePulseShape(bin_size);
+
+    // Times of the photoelectrons of each sensor
+    std::map<G4int, std::vector<G4double>> pes;
+    std::map<G4int, G4ThreeVector> positions;
+    G4double last_time = 0.;
+
+    for (size_t i=0; i<hits->entries(); ++i) {
+      const SensorHit* hit = (*hits)[i];
+      G4int id = hit->GetPmtID();
+      positions[id] = hit->GetPosition();
+      std::vector<G4double>& times = pes[id];
+
+      for (const auto& bin : hit->GetHistogram()) {
+        G4double width = hit->GetBinWidth(bin.first);
+        for (G4int j=0; j<bin.second; ++j) {
+          if (pde_ < 1. && G4UniformRand() >= pde_) continue;
+          G4double time = bin.first + G4UniformRand() * width;
+          AddAvalanches(time, times);
+        }
+        last_time = std::max(last_time, bin.first + width);
+      }
+    }
+
+    if (dark_rate_ > 0.) {
+      G4double window = (window_ > 0.) ? window_ : last_time;
+      G4double mean = dark_rate_ * window;
+      for (const auto& channel : channels) {
+        G4long num_dark = G4Poisson(mean * channel.second.num_sensors);
+        if (num_dark == 0) continue;
+        positions.insert(std::make_pair(channel.first, channel.second.position));
+        std::vector<G4double>& times = pes[channel.first];
+        for (G4long j=0; j<num_dark; ++j)
+          AddAvalanches(window * G4UniformRand(), times);
+      }
+    }
+
+    std::vector<G4double> wvf;
+    for (const auto& sensor : pes) {
+      const std::vector<G4double>& times = sensor.second;
+      if (times.empty()) continue;
+
+      // Dense buffer covering all the photoelectrons and their pulses
+      auto range = std::minmax_element(times.begin(), times.end());
+      G4long first = G4long(std::floor(*range.first /bin_size));
+      G4long last  = G4long(std::floor(*range.second/bin_size)) + pulse_.size();
+      wvf.assign(last - first, 0.);
+
+      for (G4double time : times) {
+        G4double amplitude =
+          gain_ * std::max(0., G4RandGauss::shoot(1., gain_spread_));
+        G4long bin = G4long(std::floor(time/bin_size)) - first;
+        for (size_t k=0; k<pulse_.size(); ++k)
+          wvf[bin+k] += amplitude * pulse_[k];
+      }
+
+      SensorWaveform* waveform =
+        new SensorWaveform(sensor.first, positions[sensor.first], bin_size);
+      for (size_t k=0; k<wvf.size(); ++k) {
+        if (wvf[k] > threshold_) waveform->AddSample(first + k, wvf[k]);
+      }
+      waveforms->insert(waveform);
+    }
+  }
+
+
+} // end namespace nexus
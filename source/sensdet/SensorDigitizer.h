@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDigitizer.h
+//
+// This class applies the response of the sensor electronics (gain,
+// dark counts, crosstalk, afterpulsing and pulse shape) to the photons
+// detected by a type of photosensor and produces digitized waveforms.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_DIGITIZER_H
+#define SENSOR_DIGITIZER_H
+
+#include "SensorHit.h"
+#include "SensorWaveform.h"
+
+#include <map>
+#include <vector>
+
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  /// Readout channel of a sensitive detector: a single sensor or
+  /// a group of sensors whose signals are summed
+  struct SensorChannel
+  {
+    G4ThreeVector position; ///< Mean position of the sensors
+    G4int num_sensors = 0;  ///< Number of sensors summed
+  };
+
+  class SensorDigitizer
+  {
+  public:
+    /// Constructor. The configuration commands are placed in
+    /// the messenger directory given.
+    SensorDigitizer(const G4String& msg_dir);
+    /// Destructor
+    ~SensorDigitizer();
+
+    /// Return whether the digitization is enabled
+    G4bool IsEnabled() const;
+    /// Return whether the detected photons are also stored
+    G4bool KeepPhotons() const;
+    /// Return whether dark counts have to be simulated
+    G4bool HasDarkCounts() const;
+
+    /// Digitize the photons detected in the event. Every photon gives
+    /// a photoelectron with probability pde (applied on top of the
+    /// efficiency of the optical surface of the sensor). Dark counts are
+    /// generated in all the readout channels given, whether they
+    /// detected photons or not, with a rate proportional to their
+    /// number of sensors. Waveforms are sampled with the coarse time
+    /// binning of the sensors.
+    void Digitize(const SensorHitsCollection* hits,
+                  const std::map<G4int, SensorChannel>& channels,
+                  G4double bin_size,
+                  SensorWaveformsCollection* waveforms);
+
+  private:
+    /// Compute the pulse shape sampled with a given bin size
+    void ComputePulseShape(G4double bin_size);
+
+    /// Add to the list the avalanches (crosstalk and afterpulses)
+    /// triggered by a primary photoelectron
+    void AddAvalanches(G4double time, std::vector<G4double>& pes) const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4bool enabled_;      ///< Digitization switched on
+    G4bool keep_photons_; ///< Store also the detected-photon histograms
+
+    G4double gain_;        ///< ADC counts per photoelectron
+    G4double gain_spread_; ///< Relative spread of the gain
+    G4double dark_rate_;   ///< Dark count rate per sensor
+    G4double crosstalk_;   ///< Optical crosstalk probability
+    G4double afterpulse_prob_; ///< Afterpulsing probability
+    G4double afterpulse_time_; ///< Mean delay of afterpulses
+    G4double rise_time_;   ///< Rise time constant of the pulse
+    G4double fall_time_;   ///< Fall time constant of the pulse
+    G4double window_;      ///< Acquisition window for dark counts
+    G4double threshold_;   ///< Minimum amplitude of stored samples
+    G4double pde_;         ///< Photon detection efficiency
+
+    /// Pulse shape of a single photoelectron, normalized to unit area
+    std::vector<G4double> pulse_;
+    G4double pulse_bin_size_; ///< Bin size used to sample the pulse shape
+    std::vector<G4double> pulse_pars_; ///< Parameters of the pulse shape
+  };
+
+  // INLINE DEFINITIONS ////////////////////////////////////////////////
+
+  inline G4bool SensorDigitizer::IsEnabled() const { return enabled_; }
+  inline G4bool SensorDigitizer::KeepPhotons() const { return keep_photons_; }
+  inline G4bool SensorDigitizer::HasDarkCounts() const { return dark_rate_ > 0.; }
+
+} // namespace nexus
+
+#endif
@@ -17,14 +17,15 @@ G4Allocator<SensorHit> SensorHitAllocator;
 
 
 SensorHit::SensorHit():
-  G4VHit(), pmt_id_(-1.), bin_size_(0.)
+  G4VHit(), pmt_id_(-1.), bin_size_(0.), total_counts_(0), fine_bin_size_(0.)
 {
 }
 
 
 
 SensorHit::SensorHit(G4int id, const G4ThreeVector& position, G4double bin_size):
-  G4VHit(), pmt_id_(id),  bin_size_(bin_size), position_(position)
+  G4VHit(), pmt_id_(id),  bin_size_(bin_size), position_(position),
+  total_counts_(0), fine_bin_size_(0.)
 {
 }
 
@@ -49,6 +50,9 @@ const SensorHit& SensorHit::operator=(const SensorHit& other)
   bin_size_  = other.bin_size_;
   position_  = other.position_;
   histogram_ = other.histogram_;
+  total_counts_ = other.total_counts_;
+  fine_bin_size_ = other.fine_bin_size_;
+  fine_windows_  = other.fine_windows_;
 
   return *this;
 }
@@ -75,8 +79,70 @@ void SensorHit::SetBinSize(G4double bin_size)
 
 
 
+void SensorHit::SetFineBinning(G4double bin_size,
+                               const std::vector<std::pair<G4double, G4double>>& windows)
+{
+  if (histogram_.size() != 0) {
+    G4String msg = "A SensorHit cannot be rebinned once it has been filled.";
+    G4Exception("[SensorHit]", "SetFineBinning()", JustWarning, msg);
+    return;
+  }
+
+  fine_bin_size_ = bin_size;
+  fine_windows_.clear();
+  for (const auto& window : windows) {
+    G4double nbins = ceil((window.second - window.first)/bin_size - 1.e-6);
+    fine_windows_.push_back(std::make_pair(window.first,
+                                           window.first + nbins * bin_size));
+  }
+}
+
+
+
+G4double SensorHit::GetBinStart(G4double time) const
+{
+  G4double start = floor(time/bin_size_) * bin_size_;
+
+  for (const auto& window : fine_windows_) {
+    if (time >= window.first && time < window.second)
+      return window.first +
+        floor((time - window.first)/fine_bin_size_) * fine_bin_size_;
+
+    // Coarse bins are cut at the end of the fine windows
+    if (window.second <= time && window.second > start) start = window.second;
+  }
+
+  return start;
+}
+
+
+
+G4double SensorHit::GetBinWidth(G4double bin_start) const
+{
+  if (bin_size_ <= 0.) return 0.;
+
+  // Next edge of the coarse binning
+  G4double end = (floor(bin_start/bin_size_ + 1.e-6) + 1.) * bin_size_;
+
+  for (const auto& window : fine_windows_) {
+    if (bin_start >= window.first && bin_start < window.second)
+      return fine_bin_size_;
+
+    // Coarse bins are cut at the start of the fine windows
+    if (window.first > bin_start && window.first < end) end = window.first;
+  }
+
+  return end - bin_start;
+}
+
+
+
 void SensorHit::Fill(G4double time, G4int counts)
 {
-  G4double time_bin = floor(time/bin_size_) * bin_size_;
-  histogram_[time_bin] += counts;
+  total_counts_ += counts;
+
+  // Photon-count-only hit: no time histogram
+  if (bin_size_ <= 0.) return;
+
+  histogram_[GetBinStart(time)] += counts;
 }
@@ -14,6 +14,9 @@
 #include <G4Allocator.hh>
 #include <G4ThreeVector.hh>
 
+#include <map>
+#include <vector>
+
 
 namespace nexus {
 
@@ -53,17 +56,43 @@ namespace nexus {
     G4double GetBinSize() const;
     /// Sets the bin size of the histogram. This can only be done
     /// while the histogram is empty (rebinning is not supported).
+    /// A bin size of zero means that the hit only counts photons,
+    /// without filling any time histogram.
     void SetBinSize(G4double);
 
+    /// Sets a finer bin size used inside the given time windows
+    /// (e.g. around the S1 signal). As the coarse binning, this can
+    /// only be done while the histogram is empty. The windows are
+    /// extended to contain an integer number of fine bins, and coarse
+    /// bins are cut at their edges.
+    void SetFineBinning(G4double bin_size,
+                        const std::vector<std::pair<G4double, G4double>>& windows);
+    /// Returns the bin size used inside the fine time windows
+    G4double GetFineBinSize() const;
+    /// Returns the time windows with fine binning
+    const std::vector<std::pair<G4double, G4double>>& GetFineWindows() const;
+
+    /// Returns the start of the time bin containing a given time
+    G4double GetBinStart(G4double time) const;
+    /// Returns the width of the time bin starting at a given time
+    G4double GetBinWidth(G4double bin_start) const;
+
     /// Adds counts to a given time bin
     void Fill(G4double time, G4int counts=1);
 
     const std::map<G4double, G4int>& GetHistogram() const;
 
+    /// Returns the total number of counts of the hit
+    G4int GetTotalCounts() const;
+
   private:
     G4int pmt_id_;           ///< Detector ID number
     G4double bin_size_;      ///< Size of time bin
     G4ThreeVector position_; ///< Detector position
+    G4int total_counts_;     ///< Total number of photons detected
+
+    G4double fine_bin_size_; ///< Size of time bin inside the fine windows
+    std::vector<std::pair<G4double, G4double>> fine_windows_;
 
     /// Sparse histogram with number of photons detected per time bin
     std::map<G4double, G4int> histogram_;
@@ -97,6 +126,13 @@ namespace nexus {
   inline const std::map<G4double, G4int>& SensorHit::GetHistogram() const
   { return histogram_; }
 
+  inline G4int SensorHit::GetTotalCounts() const { return total_counts_; }
+
+  inline G4double SensorHit::GetFineBinSize() const { return fine_bin_size_; }
+
+  inline const std::vector<std::pair<G4double, G4double>>&
+  SensorHit::GetFineWindows() const { return fine_windows_; }
+
 } // namespace nexus
 
 #endif
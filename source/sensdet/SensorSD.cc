@@ -14,7 +14,19 @@
 #include <G4ProcessManager.hh>
 #include <G4OpBoundaryProcess.hh>
 #include <G4RunManager.hh>
-#include <G4RunManager.hh>
+#include <G4GenericMessenger.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4NavigationHistory.hh>
+#include <G4TouchableHistory.hh>
+#include <G4LogicalVolume.hh>
+#include <G4UIcommand.hh>
+#include <Randomize.hh>
+
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
 
 
 namespace nexus {
@@ -23,16 +35,54 @@ namespace nexus {
   SensorSD::SensorSD(G4String sdname):
     G4VSensitiveDetector(sdname),
     naming_order_(0), sensor_depth_(0), mother_depth_(0),
-    boundary_(0)
+    timebinning_(0.), fine_timebinning_(0.), count_only_(false),
+    weighted_efficiency_(1.),
+    group_by_mother_(false), boundary_(0), HC_(0), WC_(0)
   {
-    // Register the name of the collection of hits
+    // Register the name of the collections of hits
     collectionName.insert(GetCollectionUniqueName());
+    collectionName.insert(GetWaveformCollectionUniqueName());
+
+    // The sensitive detectors are built during the initialization
+    // of the run manager, so these commands can only be used in
+    // delayed macros.
+    msg_ = new G4GenericMessenger(this, "/nexus/sensdet" + GetFullPathName() + "/",
+                                  "Control commands of the sensitive detector.");
+    msg_->DeclareProperty("photon_count_only", count_only_,
+                          "Record only the number of photons detected per sensor.");
+
+    G4GenericMessenger::Command& fine_binning_cmd =
+      msg_->DeclareProperty("fine_time_binning", fine_timebinning_,
+                            "Time binning inside the fine time windows.");
+    fine_binning_cmd.SetUnitCategory("Time");
+    fine_binning_cmd.SetParameterName("fine_time_binning", false);
+    fine_binning_cmd.SetRange("fine_time_binning>0.");
+
+    msg_->DeclareMethod("fine_time_window", &SensorSD::AddFineTimeWindow,
+                        "Add a time window with fine binning (start end unit).");
+
+    G4GenericMessenger::Command& eff_cmd =
+      msg_->DeclareProperty("weighted_photon_efficiency", weighted_efficiency_,
+                            "Detection probability of each photon carried by "
+                            "a detected weighted photon.");
+    eff_cmd.SetParameterName("weighted_photon_efficiency", false);
+    eff_cmd.SetRange("weighted_photon_efficiency>0. && weighted_photon_efficiency<=1.");
+
+    msg_->DeclareMethod("group_by_mother", &SensorSD::SetGroupByMother,
+                        "Sum the signals of the sensors with the same mother volume.");
+
+    msg_->DeclareMethod("grouping_table", &SensorSD::ReadGroupingTable,
+                        "File with the sensor id - channel id pairs to be summed.");
+
+    digitizer_ = new SensorDigitizer("/nexus/sensdet" + GetFullPathName() + "/digitizer/");
   }
 
 
 
   SensorSD::~SensorSD()
   {
+    delete digitizer_;
+    delete msg_;
   }
 
 
@@ -44,8 +94,103 @@ namespace nexus {
 
 
 
+  G4String SensorSD::GetWaveformCollectionUniqueName()
+  {
+    return "SensorWaveformsCollection";
+  }
+
+
+
+  void SensorSD::AddFineTimeWindow(G4String window)
+  {
+    std::istringstream iss(window);
+    G4double start, end;
+    G4String unit;
+    if (!(iss >> start >> end >> unit) || !(start < end)) {
+      G4Exception("[SensorSD]", "AddFineTimeWindow()", FatalErrorInArgument,
+                  ("Wrong fine time window '" + window +
+                   "', expected 'start end unit'.").c_str());
+    }
+
+    G4double value = G4UIcommand::ValueOf(unit);
+    fine_windows_.push_back(std::make_pair(start*value, end*value));
+    std::sort(fine_windows_.begin(), fine_windows_.end());
+
+    for (size_t i=1; i<fine_windows_.size(); ++i) {
+      if (fine_windows_[i].first < fine_windows_[i-1].second)
+        G4Exception("[SensorSD]", "AddFineTimeWindow()", FatalErrorInArgument,
+                    "Fine time windows cannot overlap.");
+    }
+  }
+
+
+
+  void SensorSD::SetGroupByMother(G4bool group)
+  {
+    group_by_mother_ = group;
+    // The channel positions must be recomputed
+    channels_.clear();
+  }
+
+
+
+  void SensorSD::ReadGroupingTable(G4String filename)
+  {
+    std::ifstream table(filename);
+    if (!table.is_open()) {
+      G4Exception("[SensorSD]", "ReadGroupingTable()", FatalErrorInArgument,
+                  ("Cannot open grouping table " + filename).c_str());
+    }
+
+    group_map_.clear();
+
+    G4String line;
+    while (std::getline(table, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream iss(line);
+      G4int sensor_id, channel_id;
+      if (!(iss >> sensor_id >> channel_id)) {
+        G4Exception("[SensorSD]", "ReadGroupingTable()", FatalErrorInArgument,
+                    ("Wrong line in grouping table " + filename + ": " + line).c_str());
+      }
+      group_map_[sensor_id] = channel_id;
+    }
+
+    // The channel positions must be recomputed
+    channels_.clear();
+  }
+
+
+
   void SensorSD::Initialize(G4HCofThisEvent* HCE)
   {
+    if (group_by_mother_ && naming_order_ == 0) {
+      G4Exception("[SensorSD]", "Initialize()", FatalException,
+                  ("Sensors of " + GetFullPathName() + " have no naming order "
+                   "and cannot be grouped by mother volume.").c_str());
+    }
+
+    // Channel positions are needed for grouped sensors and dark counts
+    G4bool grouped = group_by_mother_ || !group_map_.empty();
+    if ((grouped || digitizer_->HasDarkCounts()) && channels_.empty())
+      FindChannels();
+
+    // The edges of all the bins must be multiples of the fine binning,
+    // so that bins can be identified with an integer index
+    if (!fine_windows_.empty() && !count_only_) {
+      G4bool aligned = fine_timebinning_ > 0.;
+      G4double ratio = timebinning_/fine_timebinning_;
+      aligned = aligned && std::abs(ratio - std::round(ratio)) < 1.e-6;
+      for (const auto& window : fine_windows_) {
+        ratio = window.first/fine_timebinning_;
+        aligned = aligned && std::abs(ratio - std::round(ratio)) < 1.e-6;
+      }
+      if (!aligned)
+        G4Exception("[SensorSD]", "Initialize()", FatalException,
+                    ("The time binning and the start of the fine windows of " +
+                     GetFullPathName() + " must be multiples of the fine binning.").c_str());
+    }
+
     // Create a new collection of PMT hits
     HC_ = new SensorHitsCollection(this->GetName(), this->GetCollectionName(0));
 
@@ -53,6 +198,22 @@ namespace nexus {
       GetCollectionID(this->GetName()+"/"+this->GetCollectionName(0));
 
     HCE->AddHitsCollection(HCID, HC_);
+
+    hit_map_.clear();
+
+    // Create the collection of digitized waveforms only if needed
+    WC_ = 0;
+    if (digitizer_->IsEnabled()) {
+      if (count_only_)
+        G4Exception("[SensorSD]", "Initialize()", FatalException,
+                    ("Sensors of " + GetFullPathName() + " count photons only "
+                     "and cannot be digitized.").c_str());
+
+      WC_ = new SensorWaveformsCollection(this->GetName(), this->GetCollectionName(1));
+      G4int WCID = G4SDManager::GetSDMpointer()->
+        GetCollectionID(this->GetName()+"/"+this->GetCollectionName(1));
+      HCE->AddHitsCollection(WCID, WC_);
+    }
   }
 
 
@@ -85,28 +246,17 @@ namespace nexus {
 	const G4VTouchable* touchable =
 	  step->GetPostStepPoint()->GetTouchable();
 
-	G4int pmt_id = FindPmtID(touchable);
-
- 	SensorHit* hit = 0;
-	for (size_t i=0; i<HC_->entries(); i++) {
- 	  if ((*HC_)[i]->GetPmtID() == pmt_id) {
- 	    hit = (*HC_)[i];
-	    break;
-	  }
- 	}
-
- 	// If no hit associated to this sensor exists already,
- 	// create it and set main properties
- 	if (!hit) {
- 	  hit = new SensorHit();
- 	  hit->SetPmtID(pmt_id);
- 	  hit->SetBinSize(timebinning_);
- 	  hit->SetPosition(touchable->GetTranslation());
- 	  HC_->insert(hit);
- 	}
+	G4int counts = DetectedPhotons(step->GetTrack()->GetWeight());
+	if (counts == 0) return true;
+
+	G4int pmt_id = FindChannelID(FindPmtID(touchable));
+	G4bool grouped = group_by_mother_ || !group_map_.empty();
+
+ 	SensorHit* hit = GetHit(pmt_id, grouped ? channels_[pmt_id].position
+ 	                                        : touchable->GetTranslation());
 
  	G4double time = step->GetPostStepPoint()->GetGlobalTime();
- 	hit->Fill(time);
+ 	hit->Fill(time, counts);
       }
     }
 
@@ -115,6 +265,63 @@ namespace nexus {
 
 
 
+  G4int SensorSD::DetectedPhotons(G4double weight) const
+  {
+    // Weighted (macro) photons carry several photons, all of which are
+    // detected unless an efficiency is given for the individual photons
+    G4int num_photons = std::max(1, G4int(weight + 0.5));
+    if (num_photons == 1 || weighted_efficiency_ >= 1.) return num_photons;
+
+    return G4int(CLHEP::RandBinomial::shoot(num_photons, weighted_efficiency_));
+  }
+
+
+
+  SensorHit* SensorSD::GetHit(G4int channel_id, const G4ThreeVector& position)
+  {
+    SensorHit*& hit = hit_map_[channel_id];
+
+    // If no hit associated to this channel exists already,
+    // create it and set main properties. A null bin size
+    // makes the hit count photons without time information.
+    if (!hit) {
+      hit = new SensorHit();
+      hit->SetPmtID(channel_id);
+      hit->SetBinSize(count_only_ ? 0. : timebinning_);
+      if (!count_only_ && !fine_windows_.empty())
+        hit->SetFineBinning(fine_timebinning_, fine_windows_);
+      hit->SetPosition(position);
+      HC_->insert(hit);
+    }
+
+    return hit;
+  }
+
+
+
+  G4bool SensorSD::HasSensor(G4int sensor_id)
+  {
+    if (sensors_.empty()) FindAllSensors();
+    return sensors_.count(sensor_id) > 0;
+  }
+
+
+
+  G4bool SensorSD::AddDetectedPhotons(G4int sensor_id, G4double time, G4int counts)
+  {
+    if (!HasSensor(sensor_id) || !HC_) return false;
+
+    G4int channel_id = FindChannelID(sensor_id);
+    G4bool grouped = group_by_mother_ || !group_map_.empty();
+
+    SensorHit* hit = GetHit(channel_id, grouped ? channels_[channel_id].position
+                                                : sensors_[sensor_id]);
+    hit->Fill(time, counts);
+    return true;
+  }
+
+
+
   G4int SensorSD::FindPmtID(const G4VTouchable* touchable)
   {
     G4int pmtid = touchable->GetCopyNumber(sensor_depth_);
@@ -126,14 +333,84 @@ namespace nexus {
   }
 
 
+  G4int SensorSD::FindChannelID(G4int sensor_id) const
+  {
+    if (group_by_mother_)
+      return naming_order_ * (sensor_id / naming_order_);
+
+    if (!group_map_.empty()) {
+      auto it = group_map_.find(sensor_id);
+      if (it != group_map_.end()) return it->second;
+    }
+
+    return sensor_id;
+  }
+
+
+
+  void SensorSD::FindSensors(G4VPhysicalVolume* pv, G4NavigationHistory& history,
+                             std::map<G4int, G4ThreeVector>& sensors)
+  {
+    G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+    if (lv->GetSensitiveDetector() == this) {
+      G4TouchableHistory touchable(history);
+      sensors[FindPmtID(&touchable)] = touchable.GetTranslation();
+    }
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      history.NewLevel(daughter, kNormal, daughter->GetCopyNo());
+      FindSensors(daughter, history, sensors);
+      history.BackLevel();
+    }
+  }
+
+
+
+  void SensorSD::FindAllSensors()
+  {
+    // Find all the sensors of this SD navigating the geometry
+    G4VPhysicalVolume* world =
+      G4TransportationManager::GetTransportationManager()->
+      GetNavigatorForTracking()->GetWorldVolume();
+    G4NavigationHistory history;
+    history.SetFirstEntry(world);
+
+    sensors_.clear();
+    FindSensors(world, history, sensors_);
+  }
+
+
+
+  void SensorSD::FindChannels()
+  {
+    if (sensors_.empty()) FindAllSensors();
+
+    channels_.clear();
+    for (const auto& sensor : sensors_) {
+      SensorChannel& channel = channels_[FindChannelID(sensor.first)];
+      channel.position += sensor.second;
+      channel.num_sensors += 1;
+    }
+
+    for (auto& channel : channels_)
+      channel.second.position /= channel.second.num_sensors;
+  }
+
+
+
   void SensorSD::EndOfEvent(G4HCofThisEvent* /*HCE*/)
   {
-    //  int HCID = G4SDManager::GetSDMpointer()->
-    //    GetCollectionID(this->GetCollectionName(0));
-    //  // }
-    // HCE->AddHitsCollection(HCID, HC_);
+    if (!WC_) return;
 
+    digitizer_->Digitize(HC_, channels_, timebinning_, WC_);
 
+    // Drop the detected-photon histograms if they are not to be stored
+    if (!digitizer_->KeepPhotons()) {
+      for (size_t i=0; i<HC_->entries(); ++i) delete (*HC_)[i];
+      HC_->GetVector()->clear();
+    }
   }
 
 
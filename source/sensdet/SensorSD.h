@@ -12,12 +12,20 @@
 
 #include <G4VSensitiveDetector.hh>
 #include "SensorHit.h"
+#include "SensorWaveform.h"
+#include "SensorDigitizer.h"
+
+#include <unordered_map>
+#include <map>
 
 class G4Step;
+class G4GenericMessenger;
 class G4HCofThisEvent;
 class G4VTouchable;
 class G4TouchableHistory;
 class G4OpBoundaryProcess;
+class G4VPhysicalVolume;
+class G4NavigationHistory;
 
 
 namespace nexus {
@@ -57,10 +65,46 @@ namespace nexus {
     /// Set a time binning for the pmt hits
     void SetTimeBinning(G4double);
 
+    /// Return the time binning used inside the fine time windows
+    G4double GetFineTimeBinning() const;
+    /// Set a finer time binning used inside the fine time windows
+    void SetFineTimeBinning(G4double);
+    /// Add a time window with fine binning, given as "start end unit"
+    /// (e.g. "0 5 mus" around the S1 signal)
+    void AddFineTimeWindow(G4String);
+
+    /// Sum the photons detected by all the sensors with the same
+    /// mother volume (i.e., with the same sensor id divided by the
+    /// naming order) into a single channel, with id naming_order*motherid
+    void SetGroupByMother(G4bool);
+    /// Sum the photons detected by groups of sensors into single
+    /// channels, reading the sensor id - channel id pairs from a file.
+    /// Sensors not in the file are read out individually.
+    void ReadGroupingTable(G4String filename);
+
+    /// Return whether only the total number of photons per sensor is recorded
+    G4bool GetPhotonCountOnly() const;
+    /// Record only the total number of photons detected by each sensor,
+    /// without time information (e.g. for light-table productions).
+    /// It can be set in a delayed macro with the command
+    /// /nexus/sensdet/<sd path>/photon_count_only true
+    void SetPhotonCountOnly(G4bool);
+
+    /// Return whether a sensor id belongs to this sensitive detector
+    G4bool HasSensor(G4int sensor_id);
+    /// Register photons detected by a sensor without tracking them
+    /// (e.g., from a parametrized simulation of the light). Only valid
+    /// during an event. Returns false if the sensor does not belong
+    /// to this sensitive detector.
+    G4bool AddDetectedPhotons(G4int sensor_id, G4double time, G4int counts);
+
     /// Return the unique name of the hits collection created
     /// by this sensitive detector. This will be used by the
     /// persistency manager to select the collection.
     static G4String GetCollectionUniqueName();
+    /// Return the unique name of the collection of digitized
+    /// waveforms created by this sensitive detector
+    static G4String GetWaveformCollectionUniqueName();
 
   private:
 
@@ -68,15 +112,55 @@ namespace nexus {
 
     G4int FindPmtID(const G4VTouchable*);
 
+    /// Return the number of photons detected from an optical photon
+    /// of a given weight
+    G4int DetectedPhotons(G4double weight) const;
+
+    /// Return the hit of a readout channel in the current event,
+    /// creating it if needed
+    SensorHit* GetHit(G4int channel_id, const G4ThreeVector& position);
+
+    /// Find recursively all the sensors of this SD in the geometry
+    void FindSensors(G4VPhysicalVolume*, G4NavigationHistory&,
+                     std::map<G4int, G4ThreeVector>&);
+    /// Find all the sensors of this SD and their positions
+    void FindAllSensors();
+    /// Build the list of readout channels of this SD
+    void FindChannels();
+    /// Return the readout channel of a sensor
+    G4int FindChannelID(G4int sensor_id) const;
+
     G4int naming_order_; ///< Order of the naming scheme
     G4int sensor_depth_; ///< Depth of the SD in the geometry tree
     G4int mother_depth_; ///< Depth of the SD's mother in the geometry tree
 
     G4double timebinning_; ///< Time bin width
+    G4double fine_timebinning_; ///< Time bin width inside the fine windows
+    /// Time windows with fine binning
+    std::vector<std::pair<G4double, G4double>> fine_windows_;
+    G4bool count_only_;    ///< Record only the number of photons per sensor
+    /// Detection probability of the photons carried by a weighted photon
+    G4double weighted_efficiency_;
+
+    G4bool group_by_mother_; ///< Sum the sensors of the same mother volume
+    std::unordered_map<G4int, G4int> group_map_; ///< Sensor id to channel id
 
     G4OpBoundaryProcess* boundary_; ///< Pointer to the optical boundary process
 
     SensorHitsCollection* HC_; ///< Pointer to the collection of hits
+    SensorWaveformsCollection* WC_; ///< Pointer to the collection of waveforms
+
+    /// Hits of the current event indexed by sensor id
+    std::unordered_map<G4int, SensorHit*> hit_map_;
+
+    G4GenericMessenger* msg_; ///< Messenger for the SD configuration
+
+    SensorDigitizer* digitizer_; ///< Response of the sensor electronics
+
+    /// Positions of the sensors of this SD, indexed by sensor id
+    std::map<G4int, G4ThreeVector> sensors_;
+    /// Readout channels of this SD, indexed by channel id
+    std::map<G4int, SensorChannel> channels_;
   };
 
   // INLINE METHODS //////////////////////////////////////////////////
@@ -93,6 +177,12 @@ namespace nexus {
   inline G4double SensorSD::GetTimeBinning() const { return timebinning_; }
   inline void SensorSD::SetTimeBinning(G4double tb) { timebinning_ = tb; }
 
+  inline G4double SensorSD::GetFineTimeBinning() const { return fine_timebinning_; }
+  inline void SensorSD::SetFineTimeBinning(G4double tb) { fine_timebinning_ = tb; }
+
+  inline G4bool SensorSD::GetPhotonCountOnly() const { return count_only_; }
+  inline void SensorSD::SetPhotonCountOnly(G4bool co) { count_only_ = co; }
+
 } // end namespace nexus
 
 #endif
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorSDLookup.cc
+//
+// This class finds the sensitive detector of a sensor given its id, so that
+// parametrized simulations of the light can fill the sensor hits directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorSDLookup.h"
+
+#include "SensorSD.h"
+
+#include <G4SDManager.hh>
+
+
+namespace nexus {
+
+
+  SensorSDLookup::SensorSDLookup()
+  {
+  }
+
+
+
+  SensorSDLookup::~SensorSDLookup()
+  {
+  }
+
+
+
+  void SensorSDLookup::AddSensitiveDetector(const G4String& sdname)
+  {
+    sd_names_.push_back(sdname);
+    sds_.clear();
+    sensor_sd_.clear();
+  }
+
+
+
+  SensorSD* SensorSDLookup::Find(G4int sensor_id)
+  {
+    auto it = sensor_sd_.find(sensor_id);
+    if (it != sensor_sd_.end()) return it->second;
+
+    if (sds_.empty()) {
+      for (const auto& name : sd_names_) {
+        SensorSD* sd = dynamic_cast<SensorSD*>
+          (G4SDManager::GetSDMpointer()->FindSensitiveDetector(name, false));
+        if (!sd) {
+          G4Exception("[SensorSDLookup]", "Find()", FatalException,
+                      ("Unknown sensor sensitive detector " + name).c_str());
+        }
+        sds_.push_back(sd);
+      }
+    }
+
+    SensorSD* owner = 0;
+    for (SensorSD* sd : sds_) {
+      if (sd->HasSensor(sensor_id)) {
+        owner = sd;
+        break;
+      }
+    }
+
+    if (!owner) {
+      G4Exception("[SensorSDLookup]", "Find()", JustWarning,
+                  ("Sensor " + std::to_string(sensor_id) +
+                   " not found in the sensitive detectors given.").c_str());
+    }
+
+    sensor_sd_[sensor_id] = owner;
+    return owner;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorSDLookup.h
+//
+// This class finds the sensitive detector of a sensor given its id, so that
+// parametrized simulations of the light can fill the sensor hits directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_SD_LOOKUP_H
+#define SENSOR_SD_LOOKUP_H
+
+#include <globals.hh>
+
+#include <vector>
+#include <unordered_map>
+
+
+namespace nexus {
+
+  class SensorSD;
+
+  class SensorSDLookup
+  {
+  public:
+    /// Constructor
+    SensorSDLookup();
+    /// Destructor
+    ~SensorSDLookup();
+
+    /// Add a sensitive detector (full path name) to the lookup
+    void AddSensitiveDetector(const G4String& sdname);
+
+    /// Return the sensitive detector of a sensor, or null if the sensor
+    /// does not belong to any of the detectors given (a warning is
+    /// issued the first time). The detectors are built with the geometry,
+    /// so this can only be called once the run has been initialized.
+    SensorSD* Find(G4int sensor_id);
+
+  private:
+    std::vector<G4String> sd_names_; ///< Sensitive detectors given
+    std::vector<SensorSD*> sds_;
+    /// Sensitive detector of every sensor, found on first use
+    std::unordered_map<G4int, SensorSD*> sensor_sd_;
+  };
+
+} // end namespace nexus
+
+#endif
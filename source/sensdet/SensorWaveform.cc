@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorWaveform.cc
+//
+// This class describes the digitized waveform of a photosensor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorWaveform.h"
+
+
+using namespace nexus;
+
+
+
+SensorWaveform::SensorWaveform(G4int id, const G4ThreeVector& position,
+                               G4double bin_size):
+  G4VHit(), sensor_id_(id), position_(position), bin_size_(bin_size)
+{
+}
+
+
+
+SensorWaveform::~SensorWaveform()
+{
+}
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorWaveform.h
+//
+// This class describes the digitized waveform of a photosensor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_WAVEFORM_H
+#define SENSOR_WAVEFORM_H
+
+#include <G4VHit.hh>
+#include <G4THitsCollection.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class SensorWaveform: public G4VHit
+  {
+  public:
+    /// Constructor providing the detector ID, position and sampling time
+    SensorWaveform(G4int id, const G4ThreeVector& position, G4double bin_size);
+    /// Destructor
+    ~SensorWaveform();
+
+    /// Returns the detector ID code
+    G4int GetSensorID() const;
+    /// Returns the position of the detector
+    G4ThreeVector GetPosition() const;
+    /// Returns the sampling time of the waveform
+    G4double GetBinSize() const;
+
+    /// Adds a sample (time bin index and amplitude in ADC counts)
+    void AddSample(G4long time_bin, G4double amplitude);
+
+    /// Sparse waveform: only the samples above the digitizer threshold
+    const std::vector<std::pair<G4long, G4double>>& GetSamples() const;
+
+  private:
+    G4int sensor_id_;        ///< Detector ID number
+    G4ThreeVector position_; ///< Detector position
+    G4double bin_size_;      ///< Sampling time
+
+    std::vector<std::pair<G4long, G4double>> samples_;
+  };
+
+} // namespace nexus
+
+
+typedef G4THitsCollection<nexus::SensorWaveform> SensorWaveformsCollection;
+
+
+// INLINE DEFINITIONS ////////////////////////////////////////////////
+
+namespace nexus {
+
+  inline G4int SensorWaveform::GetSensorID() const { return sensor_id_; }
+
+  inline G4ThreeVector SensorWaveform::GetPosition() const { return position_; }
+
+  inline G4double SensorWaveform::GetBinSize() const { return bin_size_; }
+
+  inline void SensorWaveform::AddSample(G4long time_bin, G4double amplitude)
+  { samples_.push_back(std::make_pair(time_bin, amplitude)); }
+
+  inline const std::vector<std::pair<G4long, G4double>>&
+  SensorWaveform::GetSamples() const { return samples_; }
+
+} // namespace nexus
+
+#endif
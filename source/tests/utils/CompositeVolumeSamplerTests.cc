@@ -0,0 +1,34 @@
+#include <CompositeVolumeSampler.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+
+TEST_CASE("Composite volume sampler") {
+  // These tests check that the parts of a CompositeVolumeSampler
+  // are chosen in proportion to their weights
+
+  nexus::CompositeVolumeSampler sampler;
+  const std::vector<G4double> weights = {1., 0., 3., 4.};
+  for (size_t i=0; i<weights.size(); ++i)
+    sampler.AddPart([i]() { return G4ThreeVector(i, 0., 0.); }, weights[i]);
+
+  SECTION ("Fractions") {
+    REQUIRE (sampler.GetNumberOfParts() == weights.size());
+    REQUIRE (sampler.GetTotalWeight() == Approx(8.));
+    REQUIRE (sampler.GetFraction(1) == 0.);
+    REQUIRE (sampler.GetFraction(3) == Approx(0.5));
+  }
+
+  SECTION ("Frequencies") {
+    const G4int n = 100000;
+    std::vector<G4int> counts(weights.size(), 0);
+    for (G4int i=0; i<n; ++i)
+      counts[size_t(sampler.Shoot().x())]++;
+
+    REQUIRE (counts[1] == 0);
+    for (size_t i=0; i<weights.size(); ++i)
+      REQUIRE (counts[i] == Approx(n * sampler.GetFraction(i)).epsilon(0.05));
+  }
+}
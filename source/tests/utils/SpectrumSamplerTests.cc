@@ -0,0 +1,69 @@
+#include <AliasSampler.h>
+#include <SpectrumSampler.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+
+TEST_CASE("Alias sampler") {
+  // These tests check that the outcomes of AliasSampler follow
+  // the probabilities given by the weights
+
+  std::vector<G4double> weights = {1., 0., 3., -2., 4.};
+  nexus::AliasSampler sampler(weights);
+
+  SECTION ("Probabilities") {
+    REQUIRE (sampler.GetSize() == weights.size());
+    REQUIRE (sampler.GetTotalWeight() == Approx(8.));
+    REQUIRE (sampler.GetProbability(2) == Approx(3./8.));
+    REQUIRE (sampler.GetProbability(3) == 0.);
+  }
+
+  SECTION ("Frequencies") {
+    const G4int n = 100000;
+    std::vector<G4int> counts(weights.size(), 0);
+    for (G4int i=0; i<n; ++i)
+      counts[sampler.Sample((i + 0.5) / n)]++;
+
+    REQUIRE (counts[1] == 0);
+    REQUIRE (counts[3] == 0);
+    for (size_t i=0; i<weights.size(); ++i)
+      REQUIRE (counts[i] == Approx(n * sampler.GetProbability(i)).margin(5));
+  }
+
+  SECTION ("Empty") {
+    nexus::AliasSampler empty(std::vector<G4double>{0., -1.});
+    REQUIRE (empty.IsEmpty());
+  }
+}
+
+
+TEST_CASE("Spectrum sampler") {
+  // These tests check that SpectrumSampler reproduces a spectrum
+  // interpolated linearly between its points
+
+  SECTION ("Triangular spectrum") {
+    // Intensity rising linearly from 0 at energy 1 to 1 at energy 3:
+    // the mean energy is 1 + 2*2/3
+    nexus::SpectrumSampler sampler(std::vector<G4double>{1., 3.},
+                                   std::vector<G4double>{0., 1.});
+    const G4int n = 1000;
+    G4double mean = 0.;
+    for (G4int i=0; i<n; ++i) {
+      G4double energy = sampler.Sample(0.5, (i + 0.5) / n);
+      REQUIRE (energy >= 1.);
+      REQUIRE (energy <= 3.);
+      mean += energy / n;
+    }
+    REQUIRE (mean == Approx(1. + 4./3.).epsilon(1.e-3));
+  }
+
+  SECTION ("Flat spectrum") {
+    nexus::SpectrumSampler sampler(std::vector<G4double>{1., 2., 4.},
+                                   std::vector<G4double>{1., 1., 1.});
+    // One third of the area is in the first bin
+    REQUIRE (sampler.Sample(0.1, 0.5) == Approx(1.5));
+    REQUIRE (sampler.Sample(0.9, 0.5) == Approx(3.));
+  }
+}
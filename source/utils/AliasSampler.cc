@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// nexus | AliasSampler.cc
+//
+// This class samples an index from a discrete distribution with the
+// alias method of Walker, in constant time.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "AliasSampler.h"
+
+#include <Randomize.hh>
+
+#include <algorithm>
+
+
+namespace nexus {
+
+
+  AliasSampler::AliasSampler(): total_(0.)
+  {
+  }
+
+
+
+  AliasSampler::AliasSampler(const std::vector<G4double>& weights): total_(0.)
+  {
+    SetWeights(weights);
+  }
+
+
+
+  AliasSampler::~AliasSampler()
+  {
+  }
+
+
+
+  void AliasSampler::SetWeights(const std::vector<G4double>& weights)
+  {
+    const size_t n = weights.size();
+
+    accept_.clear();
+    alias_.clear();
+    probs_.assign(n, 0.);
+
+    total_ = 0.;
+    for (G4double w : weights) total_ += std::max(w, 0.);
+    if (total_ <= 0.) return;
+
+    // Weights scaled to a mean of one, split into
+    // the bins below and above the mean
+    std::vector<G4double> scaled(n);
+    std::vector<size_t> small, large;
+    for (size_t i=0; i<n; ++i) {
+      probs_[i] = std::max(weights[i], 0.) / total_;
+      scaled[i] = probs_[i] * n;
+      if (scaled[i] < 1.) small.push_back(i);
+      else                large.push_back(i);
+    }
+
+    accept_.assign(n, 1.);
+    alias_.resize(n);
+    for (size_t i=0; i<n; ++i) alias_[i] = i;
+
+    // Every small bin is filled up with a piece of a large one
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(); small.pop_back();
+      size_t l = large.back(); large.pop_back();
+
+      accept_[s] = scaled[s];
+      alias_[s]  = l;
+
+      scaled[l] = (scaled[l] + scaled[s]) - 1.;
+      if (scaled[l] < 1.) small.push_back(l);
+      else                large.push_back(l);
+    }
+
+    // The remaining bins are full (up to rounding errors)
+    for (size_t i : small) accept_[i] = 1.;
+    for (size_t i : large) accept_[i] = 1.;
+  }
+
+
+
+  size_t AliasSampler::Shoot() const
+  {
+    return Sample(G4UniformRand());
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | AliasSampler.h
+//
+// This class samples an index from a discrete distribution with the
+// alias method of Walker, in constant time.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ALIAS_SAMPLER_H
+#define ALIAS_SAMPLER_H
+
+#include <globals.hh>
+
+#include <vector>
+#include <algorithm>
+
+
+namespace nexus {
+
+  /// The table is built once from the weights of the outcomes (Vose's
+  /// algorithm), after which every sample costs a single random number,
+  /// a multiplication and a comparison, whatever the number of outcomes.
+  /// Negative weights are taken as zero.
+
+  class AliasSampler
+  {
+  public:
+    /// Constructor of an empty sampler
+    AliasSampler();
+    /// Constructor from the weights of the outcomes
+    AliasSampler(const std::vector<G4double>& weights);
+    /// Destructor
+    ~AliasSampler();
+
+    /// Build the table for the given weights
+    void SetWeights(const std::vector<G4double>& weights);
+
+    /// Returns the number of outcomes
+    size_t GetSize() const;
+    /// Returns true if there are no outcomes with positive weight
+    G4bool IsEmpty() const;
+    /// Returns the sum of the weights
+    G4double GetTotalWeight() const;
+    /// Returns the probability of an outcome
+    G4double GetProbability(size_t i) const;
+
+    /// Returns the outcome for a uniform random number in [0, 1)
+    size_t Sample(G4double u) const;
+    /// Returns a random outcome
+    size_t Shoot() const;
+
+  private:
+    std::vector<G4double> accept_; ///< Probability of keeping the bin
+    std::vector<size_t> alias_;    ///< Alternative outcome of every bin
+    std::vector<G4double> probs_;  ///< Probability of every outcome
+    G4double total_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t AliasSampler::GetSize() const { return probs_.size(); }
+
+  inline G4bool AliasSampler::IsEmpty() const { return accept_.empty(); }
+
+  inline G4double AliasSampler::GetTotalWeight() const { return total_; }
+
+  inline G4double AliasSampler::GetProbability(size_t i) const
+  { return probs_[i]; }
+
+  inline size_t AliasSampler::Sample(G4double u) const
+  {
+    if (IsEmpty())
+      G4Exception("[AliasSampler]", "Sample()", FatalException,
+                  "Sampling from an empty table.");
+
+    // The integer part of u*n is the bin, the fractional part
+    // decides between the bin and its alias
+    G4double x = u * accept_.size();
+    size_t bin = std::min(size_t(x), accept_.size() - 1);
+    return (x - bin < accept_[bin]) ? bin : alias_[bin];
+  }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+// nexus | CompositeVolumeSampler.cc
+//
+// This class samples random points in a volume made of several parts,
+// choosing every part with a probability proportional to its weight.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "CompositeVolumeSampler.h"
+
+#include <cmath>
+
+
+namespace nexus {
+
+
+  CompositeVolumeSampler::CompositeVolumeSampler()
+  {
+  }
+
+
+
+  CompositeVolumeSampler::~CompositeVolumeSampler()
+  {
+  }
+
+
+
+  void CompositeVolumeSampler::AddPart(const Sampler& sampler, G4double weight)
+  {
+    if (!sampler || !std::isfinite(weight) || weight < 0.) {
+      G4Exception("[CompositeVolumeSampler]", "AddPart()", FatalErrorInArgument,
+                  "Parts need a sampler and a finite, non-negative weight.");
+    }
+
+    samplers_.push_back(sampler);
+    weights_.push_back(weight);
+
+    // The table is rebuilt with every part, which is cheap for the
+    // handful of parts of a geometry component
+    parts_.SetWeights(weights_);
+  }
+
+
+
+  G4ThreeVector CompositeVolumeSampler::Shoot() const
+  {
+    if (parts_.IsEmpty()) {
+      G4Exception("[CompositeVolumeSampler]", "Shoot()", FatalException,
+                  "No part with a positive weight to sample from.");
+    }
+
+    return samplers_[parts_.Shoot()]();
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------
+// nexus | CompositeVolumeSampler.h
+//
+// This class samples random points in a volume made of several parts,
+// choosing every part with a probability proportional to its weight.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef COMPOSITE_VOLUME_SAMPLER_H
+#define COMPOSITE_VOLUME_SAMPLER_H
+
+#include "AliasSampler.h"
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+#include <functional>
+
+
+namespace nexus {
+
+  /// Every part is given as a sampler of points in it and a weight,
+  /// which is its volume for points uniform in the whole volume or its
+  /// mass for points uniform in mass (e.g. for radioactive backgrounds
+  /// in parts of different materials). The part of every point is
+  /// chosen with an alias table, in constant time whatever the number
+  /// of parts. Weights must be finite and non-negative, and at least
+  /// one of them positive.
+
+  class CompositeVolumeSampler
+  {
+  public:
+    /// Sampler of points in a part
+    typedef std::function<G4ThreeVector()> Sampler;
+
+    /// Constructor
+    CompositeVolumeSampler();
+    /// Destructor
+    ~CompositeVolumeSampler();
+
+    /// Add a part with its weight (volume or mass)
+    void AddPart(const Sampler& sampler, G4double weight);
+
+    /// Returns the number of parts
+    size_t GetNumberOfParts() const;
+    /// Returns the sum of the weights of the parts
+    G4double GetTotalWeight() const;
+    /// Returns the probability of choosing a part
+    G4double GetFraction(size_t part) const;
+
+    /// Returns a random point in the volume
+    G4ThreeVector Shoot() const;
+
+  private:
+    std::vector<Sampler> samplers_;  ///< Samplers of the parts
+    std::vector<G4double> weights_;  ///< Weights of the parts
+    AliasSampler parts_;             ///< Table of the parts
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t CompositeVolumeSampler::GetNumberOfParts() const
+  { return samplers_.size(); }
+
+  inline G4double CompositeVolumeSampler::GetTotalWeight() const
+  { return parts_.GetTotalWeight(); }
+
+  inline G4double CompositeVolumeSampler::GetFraction(size_t part) const
+  { return parts_.GetProbability(part); }
+
+} // end namespace nexus
+
+#endif
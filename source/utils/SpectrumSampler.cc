@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.cc
+//
+// This class samples photon energies from an emission spectrum
+// given as a table of (energy, intensity) pairs.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SpectrumSampler.h"
+
+#include <G4PhysicsVector.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace nexus {
+
+
+  SpectrumSampler::SpectrumSampler()
+  {
+  }
+
+
+
+  SpectrumSampler::SpectrumSampler(const G4PhysicsVector& spectrum)
+  {
+    std::vector<G4double> energies, intensities;
+    for (size_t i=0; i<spectrum.GetVectorLength(); ++i) {
+      energies.push_back(spectrum.Energy(i));
+      intensities.push_back(spectrum[i]);
+    }
+    SetSpectrum(energies, intensities);
+  }
+
+
+
+  SpectrumSampler::SpectrumSampler(const std::vector<G4double>& energies,
+                                   const std::vector<G4double>& intensities)
+  {
+    SetSpectrum(energies, intensities);
+  }
+
+
+
+  SpectrumSampler::~SpectrumSampler()
+  {
+  }
+
+
+
+  void SpectrumSampler::SetSpectrum(const std::vector<G4double>& energies,
+                                    const std::vector<G4double>& intensities)
+  {
+    if (energies.size() != intensities.size()) {
+      G4Exception("[SpectrumSampler]", "SetSpectrum()", FatalException,
+                  "Different number of energies and intensities in the spectrum.");
+    }
+
+    energies_ = energies;
+    intensities_.resize(intensities.size());
+    for (size_t i=0; i<intensities.size(); ++i)
+      intensities_[i] = std::max(intensities[i], 0.);
+
+    // Area of every bin (trapezoidal rule)
+    std::vector<G4double> areas;
+    for (size_t i=1; i<energies_.size(); ++i)
+      areas.push_back(0.5 * (energies_[i] - energies_[i-1]) *
+                      (intensities_[i] + intensities_[i-1]));
+
+    bins_.SetWeights(areas);
+  }
+
+
+
+  G4double SpectrumSampler::Sample(G4double u1, G4double u2) const
+  {
+    size_t bin = bins_.Sample(u1);
+
+    // Fraction x of the bin where the integral of the linear
+    // intensity f0 + (f1 - f0) x reaches u2 times the bin area,
+    // in a form that is stable when f0 and f1 are close
+    G4double f0 = intensities_[bin];
+    G4double f1 = intensities_[bin+1];
+    G4double den = f0 + std::sqrt(f0*f0 + u2 * (f1*f1 - f0*f0));
+    G4double x = (den > 0.) ? u2 * (f0 + f1) / den : u2;
+
+    return energies_[bin] + x * (energies_[bin+1] - energies_[bin]);
+  }
+
+
+
+  G4double SpectrumSampler::Shoot() const
+  {
+    G4double u1 = G4UniformRand();
+    return Sample(u1, G4UniformRand());
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.h
+//
+// This class samples photon energies from an emission spectrum
+// given as a table of (energy, intensity) pairs.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SPECTRUM_SAMPLER_H
+#define SPECTRUM_SAMPLER_H
+
+#include "AliasSampler.h"
+
+#include <globals.hh>
+
+#include <vector>
+
+class G4PhysicsVector;
+
+
+namespace nexus {
+
+  /// The spectrum is interpolated linearly between the tabulated
+  /// energies. The bin between two consecutive energies is chosen with
+  /// an alias table of the bin areas, and the energy is sampled from
+  /// the linear intensity within the bin by inverting its integral
+  /// analytically, so that every photon costs two random numbers and
+  /// no search. The sampler is meant to be built once per spectrum.
+
+  class SpectrumSampler
+  {
+  public:
+    /// Constructor of an empty sampler
+    SpectrumSampler();
+    /// Constructor from a spectrum (e.g. a material property vector)
+    SpectrumSampler(const G4PhysicsVector& spectrum);
+    /// Constructor from the energies and intensities of a spectrum
+    SpectrumSampler(const std::vector<G4double>& energies,
+                    const std::vector<G4double>& intensities);
+    /// Destructor
+    ~SpectrumSampler();
+
+    /// Build the sampler for the given spectrum
+    void SetSpectrum(const std::vector<G4double>& energies,
+                     const std::vector<G4double>& intensities);
+
+    /// Returns true if the spectrum has no positive intensity
+    G4bool IsEmpty() const;
+
+    /// Returns the energy for two uniform random numbers in [0, 1)
+    G4double Sample(G4double u1, G4double u2) const;
+    /// Returns a random energy
+    G4double Shoot() const;
+
+  private:
+    std::vector<G4double> energies_;
+    std::vector<G4double> intensities_;
+    AliasSampler bins_; ///< Sampler of the bins, weighted by their area
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool SpectrumSampler::IsEmpty() const { return bins_.IsEmpty(); }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------------------
+// nexus | VoxelizedVolumeSampler.cc
+//
+// This class samples random uniform points in a set of physical volumes
+// of the geometry using a voxel map of the volumes.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "VoxelizedVolumeSampler.h"
+
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VSolid.hh>
+#include <G4Point3D.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+
+namespace nexus {
+
+
+  VoxelizedVolumeSampler::VoxelizedVolumeSampler(const std::vector<G4String>& volumes,
+                                                 G4double voxel_size,
+                                                 G4Navigator* navigator):
+    volumes_(volumes), voxel_size_(voxel_size), navigator_(navigator)
+  {
+    if (volumes_.empty() || voxel_size_ <= 0. || !navigator_) {
+      G4Exception("[VoxelizedVolumeSampler]", "VoxelizedVolumeSampler()",
+                  FatalErrorInArgument,
+                  "Volumes, a positive voxel size and a navigator are needed.");
+    }
+
+    for (G4int i=0; i<3; ++i) bins_[i] = 0;
+  }
+
+
+
+  VoxelizedVolumeSampler::~VoxelizedVolumeSampler()
+  {
+  }
+
+
+
+  G4ThreeVector VoxelizedVolumeSampler::Shoot()
+  {
+    // The map is built at the first call, once the geometry is closed
+    if (voxels_.empty()) BuildMap();
+
+    while (true) {
+      size_t i = std::min(size_t(G4UniformRand() * voxels_.size()),
+                          voxels_.size() - 1);
+
+      G4ThreeVector point = GetVoxelOrigin(voxels_[i]) +
+        voxel_size_ * G4ThreeVector(G4UniformRand(), G4UniformRand(), G4UniformRand());
+
+      if (!boundary_[i] || IsInside(point)) return point;
+    }
+  }
+
+
+
+  void VoxelizedVolumeSampler::BuildMap()
+  {
+    G4VPhysicalVolume* world = navigator_->GetWorldVolume();
+    if (!world) {
+      G4Exception("[VoxelizedVolumeSampler]", "BuildMap()",
+                  FatalException, "The navigator has no world volume.");
+    }
+
+    min_ = G4ThreeVector( DBL_MAX,  DBL_MAX,  DBL_MAX);
+    max_ = G4ThreeVector(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    FindBounds(world->GetLogicalVolume(), G4Transform3D());
+
+    if (min_.x() > max_.x()) {
+      G4String msg = "None of the volumes";
+      for (const auto& name : volumes_) msg += " " + name;
+      msg += " is placed in the geometry.";
+      G4Exception("[VoxelizedVolumeSampler]", "BuildMap()",
+                  FatalException, msg.c_str());
+    }
+
+    G4double num_nodes = 1.;
+    for (G4int i=0; i<3; ++i) {
+      bins_[i] = std::max(1, G4int(std::ceil((max_[i] - min_[i]) / voxel_size_)));
+      num_nodes *= bins_[i] + 1.;
+    }
+
+    if (num_nodes > 5.e8) {
+      G4Exception("[VoxelizedVolumeSampler]", "BuildMap()", FatalException,
+                  "Too many voxels in the map: the voxel size is too small.");
+    }
+
+    // Whether every corner of the voxels is inside the volumes
+    const G4int nx = bins_[0] + 1, ny = bins_[1] + 1, nz = bins_[2] + 1;
+    std::vector<char> inside(size_t(num_nodes));
+    for (G4int i=0; i<nx; ++i)
+      for (G4int j=0; j<ny; ++j)
+        for (G4int k=0; k<nz; ++k)
+          inside[(size_t(i) * ny + j) * nz + k] =
+            IsInside(min_ + voxel_size_ * G4ThreeVector(i, j, k));
+
+    // Number of corners of every voxel inside the volumes
+    const size_t num_voxels = size_t(bins_[0]) * bins_[1] * bins_[2];
+    std::vector<char> corners(num_voxels);
+    for (G4int i=0; i<bins_[0]; ++i)
+      for (G4int j=0; j<bins_[1]; ++j)
+        for (G4int k=0; k<bins_[2]; ++k) {
+          G4int count = 0;
+          for (G4int c=0; c<8; ++c)
+            count += inside[(size_t(i + (c & 1)) * ny + j + ((c >> 1) & 1)) * nz +
+                            k + ((c >> 2) & 1)];
+          corners[(size_t(i) * bins_[1] + j) * bins_[2] + k] = count;
+        }
+
+    // A voxel is kept if it or any of its neighbours has a corner inside,
+    // and it is interior if it and all its neighbours are fully inside
+    voxels_.clear();
+    boundary_.clear();
+    size_t num_boundary = 0;
+
+    for (G4int i=0; i<bins_[0]; ++i)
+      for (G4int j=0; j<bins_[1]; ++j)
+        for (G4int k=0; k<bins_[2]; ++k) {
+          G4bool touched  = false;
+          G4bool interior = true;
+          for (G4int di=-1; di<=1; ++di)
+            for (G4int dj=-1; dj<=1; ++dj)
+              for (G4int dk=-1; dk<=1; ++dk) {
+                G4int a = i + di, b = j + dj, c = k + dk;
+                G4int count = 0;
+                if (a >= 0 && a < bins_[0] && b >= 0 && b < bins_[1] &&
+                    c >= 0 && c < bins_[2])
+                  count = corners[(size_t(a) * bins_[1] + b) * bins_[2] + c];
+                if (count > 0) touched  = true;
+                if (count < 8) interior = false;
+              }
+
+          if (!touched) continue;
+
+          voxels_.push_back((uint32_t(i) * bins_[1] + j) * bins_[2] + k);
+          boundary_.push_back(!interior);
+          if (!interior) ++num_boundary;
+        }
+
+    if (voxels_.empty()) {
+      G4Exception("[VoxelizedVolumeSampler]", "BuildMap()", FatalException,
+                  "No voxel found inside the volumes: the voxel size is too large.");
+    }
+
+    G4cout << "[VoxelizedVolumeSampler] Voxel map of " << volumes_.front()
+           << (volumes_.size() > 1 ? " and others" : "") << ": "
+           << voxels_.size() << " voxels of " << voxel_size_/mm << " mm, "
+           << num_boundary << " of them on the boundary." << G4endl;
+  }
+
+
+
+  void VoxelizedVolumeSampler::FindBounds(const G4LogicalVolume* logic,
+                                          const G4Transform3D& transform)
+  {
+    for (size_t i=0; i<logic->GetNoDaughters(); ++i) {
+      G4VPhysicalVolume* phys = logic->GetDaughter(i);
+
+      // Replicas and parameterised volumes have no fixed placement
+      if (phys->IsReplicated()) continue;
+
+      G4Transform3D daughter = transform *
+        G4Transform3D(phys->GetObjectRotationValue(), phys->GetObjectTranslation());
+
+      if (std::find(volumes_.begin(), volumes_.end(), phys->GetName()) != volumes_.end()) {
+        G4ThreeVector lower, upper;
+        phys->GetLogicalVolume()->GetSolid()->BoundingLimits(lower, upper);
+
+        for (G4int c=0; c<8; ++c) {
+          G4Point3D corner((c & 1) ? upper.x() : lower.x(),
+                           (c & 2) ? upper.y() : lower.y(),
+                           (c & 4) ? upper.z() : lower.z());
+          corner = daughter * corner;
+          for (G4int j=0; j<3; ++j) {
+            min_[j] = std::min(min_[j], corner[j]);
+            max_[j] = std::max(max_[j], corner[j]);
+          }
+        }
+      }
+
+      FindBounds(phys->GetLogicalVolume(), daughter);
+    }
+  }
+
+
+
+  G4bool VoxelizedVolumeSampler::IsInside(const G4ThreeVector& point) const
+  {
+    G4VPhysicalVolume* phys =
+      navigator_->LocateGlobalPointAndSetup(point, 0, false);
+
+    return phys &&
+      std::find(volumes_.begin(), volumes_.end(), phys->GetName()) != volumes_.end();
+  }
+
+
+
+  G4ThreeVector VoxelizedVolumeSampler::GetVoxelOrigin(size_t voxel) const
+  {
+    G4int k = voxel % bins_[2];
+    voxel /= bins_[2];
+    G4int j = voxel % bins_[1];
+    G4int i = voxel / bins_[1];
+
+    return min_ + voxel_size_ * G4ThreeVector(i, j, k);
+  }
+
+
+} // namespace nexus
@@ -0,0 +1,72 @@
+// ----------------------------------------------------------------------------
+// nexus | VoxelizedVolumeSampler.h
+//
+// This class samples random uniform points in a set of physical volumes
+// of the geometry using a voxel map of the volumes.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef VOXELIZED_VOLUME_SAMPLER_H
+#define VOXELIZED_VOLUME_SAMPLER_H
+
+#include <G4ThreeVector.hh>
+#include <G4Transform3D.hh>
+#include <globals.hh>
+
+#include <vector>
+#include <cstdint>
+
+class G4Navigator;
+class G4LogicalVolume;
+
+
+namespace nexus {
+
+  /// The volumes are selected by the name of their physical volumes. The
+  /// first time a point is requested, the bounding box of all the
+  /// placements with those names is divided into cubic voxels, and the
+  /// navigator is asked for the volume at every voxel corner. Voxels
+  /// whose corners (and those of their neighbours) are all inside the
+  /// volumes are interior; voxels with some corner inside, or next to
+  /// one, are boundary voxels. A point is generated by choosing a voxel
+  /// uniformly (all voxels have the same volume) and a uniform point in
+  /// it: points in interior voxels are accepted directly, and only those
+  /// in boundary voxels are checked with the navigator, choosing a new
+  /// voxel if they are outside. The distribution is uniform in the
+  /// volumes as long as no part of them is thinner than the voxel size
+  /// (parts falling between the corners of the grid would be missed).
+
+  class VoxelizedVolumeSampler
+  {
+  public:
+    /// Constructor
+    VoxelizedVolumeSampler(const std::vector<G4String>& volumes,
+                           G4double voxel_size, G4Navigator* navigator);
+    /// Destructor
+    ~VoxelizedVolumeSampler();
+
+    /// Returns a random point (in global coordinates) in the volumes
+    G4ThreeVector Shoot();
+
+  private:
+    void BuildMap();
+    void FindBounds(const G4LogicalVolume*, const G4Transform3D&);
+    G4bool IsInside(const G4ThreeVector&) const;
+    G4ThreeVector GetVoxelOrigin(size_t voxel) const;
+
+  private:
+    std::vector<G4String> volumes_; ///< Names of the physical volumes
+    G4double voxel_size_;           ///< Side of the voxels
+    G4Navigator* navigator_;
+
+    G4ThreeVector min_, max_; ///< Bounding box of the volumes
+    G4int bins_[3];           ///< Number of voxels in every axis
+
+    std::vector<uint32_t> voxels_;  ///< Voxels with some part in the volumes
+    std::vector<char> boundary_;    ///< Whether the voxels need a check
+  };
+
+} // namespace nexus
+
+#endif
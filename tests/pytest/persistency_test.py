@@ -15,6 +15,10 @@ def test_hdf5_structure(detectors):
             assert 'sns_response'  in h5out.root.MC
             assert 'configuration' in h5out.root.MC
             assert 'sns_positions' in h5out.root.MC
+            assert 'event_sources' in h5out.root.MC
+            assert 'event_points'  in h5out.root.MC
+            assert 'scan_points'   in h5out.root.MC
+            assert 'scan_counts'   in h5out.root.MC
 
 
             pcolumns = h5out.root.MC.particles.colnames
@@ -76,6 +80,20 @@ def test_hdf5_structure(detectors):
             assert 'z'           in sposcolumns
 
 
+            ecolumns = h5out.root.MC.event_sources.colnames
+
+            assert 'event_id' in ecolumns
+            assert 'source'   in ecolumns
+            assert 'weight'   in ecolumns
+
+
+            ccolumns = h5out.root.MC.scan_counts.colnames
+
+            assert 'point_id'  in ccolumns
+            assert 'sensor_id' in ccolumns
+            assert 'charge'    in ccolumns
+
+
     filename, _, _, _, _ = detectors
     if "DEMOPP" in filename:
         for run in ["run5", "run7", "run8", "run9", "run10"]: